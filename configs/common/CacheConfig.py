@@ -70,11 +70,36 @@ def _get_cache_opts(level, options):
 
     prefetcher_attr = f"{level}_hwp_type"
     if hasattr(options, prefetcher_attr):
-        opts["prefetcher"] = _get_hwp(getattr(options, prefetcher_attr))
+        pf = _get_hwp(getattr(options, prefetcher_attr))
+        if pf is not NULL and getattr(options, "pf_functional_warming", False):
+            for warmed in [pf] + list(getattr(pf, "prefetchers", [])):
+                warmed.functional_warming = True
+        opts["prefetcher"] = pf
+
+    # Every cache of the hierarchy must be tag-only, or none
+    if getattr(options, "tag_only_caches", False):
+        opts["tag_only"] = True
 
     return opts
 
 
+def _get_trace_monitor(trace_file):
+    # Record the requests crossing the monitor, with their PC, in a packet
+    # trace that the TrafficGen TRACE state can replay
+    monitor = TraceMonitor()
+    monitor.trace = MemTraceProbe(trace_file=trace_file, with_pc=True)
+    return monitor
+
+
+def _connect_l2_cpu_side(options, system):
+    if getattr(options, "l2_trace_file", None):
+        system.l2_mon = _get_trace_monitor(options.l2_trace_file)
+        system.l2_mon.cpu_side_port = system.tol2bus.mem_side_ports
+        system.l2.cpu_side = system.l2_mon.mem_side_port
+    else:
+        system.l2.cpu_side = system.tol2bus.mem_side_ports
+
+
 def config_cache(options, system):
     if options.external_memory_system and (options.caches or options.l2cache):
         print("External caches and internal caches are exclusive options.\n")
@@ -137,7 +162,7 @@ def config_cache(options, system):
         system.l3.mem_side = system.membus.cpu_side_ports
         system.l3.cpu_side = system.tol3bus.mem_side_ports
 
-        system.l2.cpu_side = system.tol2bus.mem_side_ports
+        _connect_l2_cpu_side(options, system)
         system.l2.mem_side = system.tol3bus.cpu_side_ports
 
     if options.l2cache and not options.l3cache:
@@ -149,7 +174,7 @@ def config_cache(options, system):
         )
 
         system.tol2bus = L2XBar(clk_domain=system.cpu_clk_domain)
-        system.l2.cpu_side = system.tol2bus.mem_side_ports
+        _connect_l2_cpu_side(options, system)
         system.l2.mem_side = system.membus.cpu_side_ports
 
     if options.memchecker:
@@ -160,13 +185,27 @@ def config_cache(options, system):
             icache = icache_class(**_get_cache_opts("l1i", options))
             dcache = dcache_class(**_get_cache_opts("l1d", options))
 
+            # Prefetchers that learn from load values listen to the core
+            if hasattr(dcache.prefetcher, "listenLoadValues"):
+                dcache.prefetcher.listenLoadValues(system.cpu[i])
+
+            # Prefetchers that follow the fetch-target queue of the core
+            # prefetch its virtual addresses, so they translate with its MMU
+            if hasattr(icache.prefetcher, "listenFetchTargets"):
+                icache.prefetcher.listenFetchTargets(system.cpu[i])
+                icache.prefetcher.registerMMU(system.cpu[i].mmu)
+
             # If we are using ISA.X86 or ISA.RISCV, we set walker caches.
             if ObjectList.cpu_list.get_isa(options.cpu_type) in [
                 ISA.RISCV,
                 ISA.X86,
             ]:
-                iwalkcache = PageTableWalkerCache()
-                dwalkcache = PageTableWalkerCache()
+                iwalkcache = PageTableWalkerCache(
+                    **_get_cache_opts("walk", options)
+                )
+                dwalkcache = PageTableWalkerCache(
+                    **_get_cache_opts("walk", options)
+                )
             else:
                 iwalkcache = None
                 dwalkcache = None
@@ -186,6 +225,16 @@ def config_cache(options, system):
                 # Let CPU connect to monitors
                 dcache = dcache_mon
 
+            if getattr(options, "l1d_trace_file", None):
+                dcache_trace_mon = _get_trace_monitor(options.l1d_trace_file)
+                dcache_traced = dcache
+
+                # Connect monitor
+                dcache_trace_mon.mem_side_port = dcache.cpu_side
+
+                # Let CPU connect to the monitor
+                dcache = dcache_trace_mon
+
             # When connecting the caches, the clock is also inherited
             # from the CPU in question
             system.cpu[i].addPrivateSplitL1Caches(
@@ -198,6 +247,13 @@ def config_cache(options, system):
                 system.cpu[i].dcache = dcache_real
                 system.cpu[i].dcache_mon = dcache_mon
 
+            if getattr(options, "l1d_trace_file", None):
+                # As above, keep the cache as dcache so that connectAllPorts
+                # connects its mem_side
+                if not options.memchecker:
+                    system.cpu[i].dcache = dcache_traced
+                system.cpu[i].dcache_trace_mon = dcache_trace_mon
+
         elif options.external_memory_system:
             # These port names are presented to whatever 'external' system
             # gem5 is connecting to.  Its configuration will likely depend
@@ -238,6 +294,59 @@ def config_cache(options, system):
     return system
 
 
+def config_prefetch_throttle(options, system):
+    # One throttle coordinates the prefetchers of the whole hierarchy, so
+    # it needs the memory controllers, and runs after config_mem
+    if not getattr(options, "pf_throttle", False):
+        return
+
+    system.pf_throttle = PrefetchThrottle(
+        mem_ctrls=[
+            ctrl
+            for ctrl in getattr(system, "mem_ctrls", [])
+            if isinstance(ctrl, MemCtrl)
+        ]
+    )
+    for obj in system.descendants():
+        if isinstance(obj, QueuedPrefetcher):
+            obj.throttle = system.pf_throttle
+
+
+def config_prefetch_levels(options, system):
+    # Chain the prefetchers of the L1D, L2 and L3 caches, so that the
+    # confidence of a candidate picks the level it fills, and the L1
+    # accesses also train the L2 prefetcher
+    if not getattr(options, "pf_fill_levels", False):
+        return
+
+    def prefetcher(cache):
+        pf = getattr(cache, "prefetcher", None)
+        return pf if isinstance(pf, QueuedPrefetcher) else None
+
+    def fill_by_confidence(pf, thresholds):
+        # Only the TDT prefetcher gives its candidates a confidence, the
+        # others would have all of them dropped
+        if isinstance(pf, TDTPrefetcher):
+            pf.confidence_priority = True
+            pf.fill_thresholds = thresholds
+
+    l2_pf = prefetcher(getattr(system, "l2", None))
+    l3_pf = prefetcher(getattr(system, "l3", None))
+    if not l2_pf:
+        return
+    if l3_pf:
+        l2_pf.lower_prefetcher = l3_pf
+        fill_by_confidence(l2_pf, [50, 0])
+
+    for cpu in system.cpu:
+        l1_pf = prefetcher(getattr(cpu, "dcache", None))
+        if not l1_pf:
+            continue
+        l1_pf.lower_prefetcher = l2_pf
+        l1_pf.forward_hints = True
+        fill_by_confidence(l1_pf, [75, 50, 25] if l3_pf else [75, 25])
+
+
 # ExternalSlave provides a "port", but when that port connects to a cache,
 # the connecting CPU SimObject wants to refer to its "cpu_side".
 # The 'ExternalCache' class provides this adaptation by rewriting the name,
@@ -254,6 +363,15 @@ class ExternalCache(ExternalSlave):
         return super(ExternalSlave, cls).__setattr__(attr, value)
 
 
+# Likewise, a CommMonitor placed in front of a cache must present the
+# "cpu_side" of that cache to the CPU.
+class TraceMonitor(CommMonitor):
+    def __getattr__(cls, attr):
+        if attr == "cpu_side":
+            attr = "cpu_side_port"
+        return super(CommMonitor, cls).__getattr__(attr)
+
+
 def ExternalCacheFactory(port_type):
     def make(name):
         return ExternalCache(
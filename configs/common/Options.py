@@ -340,6 +340,45 @@ def addCommonOptions(parser, default_isa: Optional[ISA] = None):
                         help="""
                         type of hardware prefetcher to use with the L3 cache.
                         """)
+    parser.add_argument(
+        "--l1d-trace-file",
+        default=None,
+        help="""
+                        record the requests to the L1 data cache, with their
+                        PC, in this packet trace (requires protobuf)""")
+    parser.add_argument(
+        "--l2-trace-file",
+        default=None,
+        help="""
+                        record the requests to the L2 cache, with their PC,
+                        in this packet trace (requires protobuf)""")
+    parser.add_argument(
+        "--tag-only-caches",
+        action="store_true",
+        help="""
+                        model the timing of the caches without storing
+                        their data, which memory then holds alone""")
+    parser.add_argument(
+        "--pf-throttle",
+        action="store_true",
+        help="""
+                        throttle the queued prefetchers of the hierarchy
+                        from their accuracy, lateness and pollution, and
+                        from the load on the memory controllers""")
+    parser.add_argument(
+        "--pf-functional-warming",
+        action="store_true",
+        help="""
+                        train the prefetchers on the accesses of atomic
+                        mode, e.g. with --fast-forward or before taking a
+                        checkpoint, which then holds their learned state""")
+    parser.add_argument(
+        "--pf-fill-levels",
+        action="store_true",
+        help="""
+                        chain the L1D, L2 and L3 prefetchers, so that the
+                        confidence of a candidate picks the cache it fills
+                        and the L1D accesses train the L2 prefetcher""")
     parser.add_argument("--checker", action="store_true")
     parser.add_argument(
         "--cpu-clock",
@@ -52,7 +52,7 @@ args.l1d_assoc = 12
 args.l1d_hwp_type = "TDTPrefetcher"
 
 args.l1i_size = "32KiB"
-args.l1i_hwp_type = "TDTPrefetcher"
+args.l1i_hwp_type = "FetchDirectedPrefetcher"
 
 args.l2_size = "1280KiB" #1.25MiB
 args.l2_assoc = 20
@@ -92,6 +92,8 @@ system.membus = SystemXBar()
 system.system_port = system.membus.cpu_side_ports
 CacheConfig.config_cache(args, system)
 MemConfig.config_mem(args, system)
+CacheConfig.config_prefetch_throttle(args, system)
+CacheConfig.config_prefetch_levels(args, system)
 config_filesystem(system, args)
 
 
@@ -0,0 +1,134 @@
+"""
+Replay a packet trace of the requests to a cache through two copies of that
+cache, one without and one with a prefetcher, to compare prefetcher variants
+without the O3 core and the DRAM model.
+
+Traces are recorded by running configs/tdt4260/prefetcher.py with
+--l1d-trace-file or --l2-trace-file. Only the cache under study and a fixed
+latency memory are simulated, so the evaluation is a first-order estimate
+that must be confirmed in timing simulation.
+
+The replay still runs in gem5, through the event-driven cache, crossbar and
+memory models, so it is much slower than a standalone trace evaluator.
+"""
+
+import argparse
+import sys
+import time
+
+import m5
+from m5.objects import *
+from m5.params import NULL
+from m5.util import addToPath
+
+addToPath('../')
+
+from common import ObjectList
+from common.Caches import *
+
+parser = argparse.ArgumentParser()
+parser.add_argument("trace", help="Packet trace to replay")
+parser.add_argument("--level", choices=["l1d", "l2"], default="l1d",
+    help="Cache level the trace was recorded at")
+parser.add_argument("--size", default=None,
+    help="Size of the cache (default: the size used by prefetcher.py)")
+parser.add_argument("--assoc", type=int, default=None,
+    help="Associativity of the cache (default: the one of prefetcher.py)")
+parser.add_argument("--hwp-type", default="TDTPrefetcher",
+    choices=ObjectList.hwp_list.get_names(),
+    help="Prefetcher to evaluate")
+parser.add_argument("--pf-param", action="append", default=[],
+    metavar="NAME=VALUE",
+    help="Set a parameter of the evaluated prefetcher, e.g. "
+    "bo_degree_mode=multiples. Can be given multiple times.")
+parser.add_argument("--mem-latency", default="60ns",
+    help="Latency of the memory behind the cache")
+
+args = parser.parse_args()
+
+# Same geometry as configs/tdt4260/prefetcher.py
+cache_configs = {
+    "l1d": (L1_DCache, "48KiB", 12),
+    "l2": (L2Cache, "1280KiB", 20),
+}
+
+def make_prefetcher():
+    prefetcher = ObjectList.hwp_list.get(args.hwp_type)()
+    for assignment in args.pf_param:
+        name, sep, value = assignment.partition("=")
+        if not sep:
+            print(f"Invalid prefetcher parameter '{assignment}'")
+            sys.exit(1)
+        setattr(prefetcher, name, value)
+    return prefetcher
+
+def make_system(prefetcher):
+    cache_class, size, assoc = cache_configs[args.level]
+
+    system = System(mem_mode = "timing",
+                    mem_ranges = [AddrRange("8GB")],
+                    cache_line_size = "64")
+    system.voltage_domain = VoltageDomain(voltage = "3.3V")
+    system.clk_domain = SrcClockDomain(clock = "3GHz",
+                                       voltage_domain = system.voltage_domain)
+
+    system.cache = cache_class(size = args.size or size,
+                               assoc = args.assoc or assoc,
+                               prefetcher = prefetcher)
+    system.tgen = PyTrafficGen()
+    system.tgen.port = system.cache.cpu_side
+
+    system.membus = SystemXBar()
+    system.system_port = system.membus.cpu_side_ports
+    system.cache.mem_side = system.membus.cpu_side_ports
+    system.mem = SimpleMemory(range = system.mem_ranges[0],
+                              latency = args.mem_latency)
+    system.mem.port = system.membus.mem_side_ports
+    return system
+
+root = Root(full_system = False)
+root.baseline = make_system(NULL)
+root.prefetched = make_system(make_prefetcher())
+
+m5.instantiate()
+
+for system in (root.baseline, root.prefetched):
+    system.tgen.start([system.tgen.createTrace(m5.MaxTick, args.trace),
+                       system.tgen.createExit(0)])
+
+# Each generator reaches its exit state when its copy of the trace is over
+start = time.time()
+finished = 0
+while finished < 2:
+    exit_event = m5.simulate()
+    if "exit state" not in exit_event.getCause():
+        print(f"Exiting @ tick {m5.curTick()} because "
+              f"{exit_event.getCause()}")
+        break
+    finished += 1
+wall_time = time.time() - start
+
+def stat(obj, name):
+    return obj.getCCObject().resolveStat(name).total
+
+base_misses = stat(root.baseline.cache, "demandMisses")
+pf_misses = stat(root.prefetched.cache, "demandMisses")
+accesses = stat(root.baseline.cache, "demandAccesses")
+prefetcher = root.prefetched.cache.prefetcher
+useful = stat(prefetcher, "pfUseful")
+issued = stat(prefetcher, "pfIssued")
+demand_mshr_misses = stat(prefetcher, "demandMshrMisses")
+
+def ratio(num, den):
+    return num / den if den else float("nan")
+
+print(f"trace: {args.trace} ({args.level})")
+print(f"demand accesses: {int(accesses)}")
+print(f"baseline misses: {int(base_misses)}")
+print(f"prefetcher misses: {int(pf_misses)}")
+print(f"miss reduction: {ratio(base_misses - pf_misses, base_misses):.4f}")
+print(f"accuracy: {ratio(useful, issued):.4f}")
+print(f"coverage: {ratio(useful, useful + demand_mshr_misses):.4f}")
+print(f"accesses per second: {ratio(2 * accesses, wall_time):.0f}")
+
+m5.stats.dump()
@@ -53,6 +53,7 @@
 #include "mem/cache/replacement_policies/base.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
+#include "sim/serialize.hh"
 
 namespace gem5
 {
@@ -90,11 +91,50 @@ class AssociativeCache : public Named
     {
         fatal_if((_num_entries % _assoc) != 0, "The number of entries of an "
                  "AssociativeCache<> must be a multiple of its associativity");
+        std::vector<ReplaceableEntry*> repl_entries(_num_entries);
         for (auto entry_idx = 0; entry_idx < _num_entries; entry_idx++) {
             Entry *entry = &entries[entry_idx];
             indexingPolicy->setEntry(entry, entry_idx);
-            entry->replacementData = replPolicy->instantiateEntry();
+            repl_entries[entry_idx] = entry;
         }
+        replPolicy->instantiateEntries(repl_entries);
+    }
+
+  protected:
+
+    /**
+     * An indexing policy only keeps pointers to the entries of the last
+     * container registered with it, so when several containers share a
+     * policy (e.g., one table per context) its candidates may belong to
+     * another container. Map a candidate back to the entry of this
+     * container that sits at the same set and way.
+     * @param candidate entry returned by the indexing policy
+     * @return the entry of this container at the same position
+     */
+    Entry*
+    localEntry(const ReplaceableEntry *candidate) const
+    {
+        const size_t idx =
+            candidate->getSet() * associativity + candidate->getWay();
+        return const_cast<Entry*>(&entries[idx]);
+    }
+
+    /**
+     * Get the entries of this container that could hold the given key.
+     * @param key key element
+     * @return the entries of the set selected by the indexing policy
+     */
+    std::vector<ReplaceableEntry*>
+    localCandidates(const KeyType &key) const
+    {
+        std::vector<ReplaceableEntry*> candidates =
+            indexingPolicy->getPossibleEntries(key);
+
+        for (auto &candidate : candidates) {
+            candidate = localEntry(candidate);
+        }
+
+        return candidates;
     }
 
   public:
@@ -208,7 +248,7 @@ class AssociativeCache : public Named
     virtual Entry*
     findEntry(const KeyType &key) const
     {
-        auto candidates = indexingPolicy->getPossibleEntries(key);
+        auto candidates = localCandidates(key);
 
         for (auto candidate : candidates) {
             Entry *entry = static_cast<Entry*>(candidate);
@@ -228,7 +268,7 @@ class AssociativeCache : public Named
     virtual Entry*
     findVictim(const KeyType &key)
     {
-        auto candidates = indexingPolicy->getPossibleEntries(key);
+        auto candidates = localCandidates(key);
 
         auto victim = static_cast<Entry*>(replPolicy->getVictim(candidates));
 
@@ -283,7 +323,7 @@ class AssociativeCache : public Named
     getPossibleEntries(const KeyType &key) const
     {
         std::vector<ReplaceableEntry *> selected_entries =
-            indexingPolicy->getPossibleEntries(key);
+            localCandidates(key);
 
         std::vector<Entry *> entries;
 
@@ -295,6 +335,64 @@ class AssociativeCache : public Named
         return entries;
     }
 
+    /**
+     * Checkpoint the valid entries with their position, so that they are
+     * restored in place. The Entry type must provide serialize() and
+     * unserialize().
+     * @param cp The checkpoint
+     */
+    void
+    serialize(CheckpointOut &cp) const
+    {
+        std::vector<size_t> valid_entries;
+        for (size_t idx = 0; idx < entries.size(); idx++) {
+            if (entries[idx].isValid()) {
+                valid_entries.push_back(idx);
+            }
+        }
+
+        paramOut(cp, "num_entries", entries.size());
+        SERIALIZE_CONTAINER(valid_entries);
+        for (size_t idx : valid_entries) {
+            Serializable::ScopedCheckpointSection sec(
+                cp, csprintf("entry%d", idx));
+            entries[idx].serialize(cp);
+        }
+    }
+
+    /**
+     * Restore the entries of a checkpoint. The replacement state is not
+     * checkpointed, so the restored entries are reset as if they had just
+     * been inserted. A checkpoint of a container of another size is
+     * ignored and the container is left empty.
+     * @param cp The checkpoint
+     */
+    void
+    unserialize(CheckpointIn &cp)
+    {
+        clear();
+
+        size_t num_entries;
+        paramIn(cp, "num_entries", num_entries);
+        if (num_entries != entries.size()) {
+            warn("%s: the checkpoint has %d entries instead of %d, not "
+                 "restoring them\n", name(), num_entries, entries.size());
+            return;
+        }
+
+        std::vector<size_t> valid_entries;
+        UNSERIALIZE_CONTAINER(valid_entries);
+        for (size_t idx : valid_entries) {
+            fatal_if(idx >= entries.size(), "%s: invalid entry %d in the "
+                     "checkpoint\n", name(), idx);
+            Serializable::ScopedCheckpointSection sec(
+                cp, csprintf("entry%d", idx));
+            Entry *entry = &entries[idx];
+            entry->unserialize(cp);
+            replPolicy->reset(entry->replacementData);
+        }
+    }
+
     /** Iterator types */
     using const_iterator = typename std::vector<Entry>::const_iterator;
     using iterator = typename std::vector<Entry>::iterator;
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "base/cache/associative_cache.hh"
+#include "base/cache/cache_entry.hh"
+#include "base/gtest/cur_tick_fake.hh"
+#include "mem/cache/replacement_policies/lru_rp.hh"
+#include "mem/cache/tags/indexing_policies/set_associative.hh"
+#include "params/LRURP.hh"
+#include "params/SetAssociative.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+GTestTickHandler tickHandler;
+
+const size_t numEntries = 16;
+const size_t assoc = 4;
+const int entrySize = 64;
+
+/** Two containers registered with the same policies, in that order. */
+class SharedPolicyTest : public ::testing::Test
+{
+  protected:
+    SharedPolicyTest()
+    {
+        SetAssociativeParams ip;
+        ip.name = "indexing";
+        ip.eventq_index = 0;
+        ip.assoc = assoc;
+        ip.size = numEntries * entrySize;
+        ip.entry_size = entrySize;
+        indexing = std::make_unique<SetAssociative>(ip);
+
+        LRURPParams rp;
+        rp.name = "repl";
+        rp.eventq_index = 0;
+        repl = std::make_unique<replacement_policy::LRU>(rp);
+
+        const CacheEntry init(genTagExtractor(indexing.get()));
+        first = std::make_unique<AssociativeCache<CacheEntry>>("first",
+            numEntries, assoc, repl.get(), indexing.get(), init);
+        second = std::make_unique<AssociativeCache<CacheEntry>>("second",
+            numEntries, assoc, repl.get(), indexing.get(), init);
+    }
+
+    /** Allocate an entry for addr in the given container. */
+    CacheEntry *
+    insert(AssociativeCache<CacheEntry> &cache, Addr addr)
+    {
+        CacheEntry *victim = cache.findVictim(addr);
+        cache.insertEntry(addr, victim);
+        return victim;
+    }
+
+    std::unique_ptr<SetAssociative> indexing;
+    std::unique_ptr<replacement_policy::LRU> repl;
+    std::unique_ptr<AssociativeCache<CacheEntry>> first;
+    std::unique_ptr<AssociativeCache<CacheEntry>> second;
+};
+
+} // anonymous namespace
+
+/**
+ * An entry inserted into the container registered first must be found in
+ * it, and not in the container the policy was registered with last.
+ */
+TEST_F(SharedPolicyTest, FindEntryIsPerContainer)
+{
+    const Addr addr = 0x1040;
+    CacheEntry *entry = insert(*first, addr);
+
+    ASSERT_EQ(first->findEntry(addr), entry);
+    ASSERT_EQ(second->findEntry(addr), nullptr);
+
+    CacheEntry *other = insert(*second, addr);
+    ASSERT_NE(other, entry);
+    ASSERT_EQ(first->findEntry(addr), entry);
+    ASSERT_EQ(second->findEntry(addr), other);
+
+    first->invalidate(entry);
+    ASSERT_EQ(first->findEntry(addr), nullptr);
+    ASSERT_EQ(second->findEntry(addr), other);
+}
+
+/**
+ * Victims and candidates of a container are its own entries, at the set
+ * and way chosen by the indexing policy.
+ */
+TEST_F(SharedPolicyTest, FindVictimIsPerContainer)
+{
+    const Addr addr = 0x2080;
+    const uint32_t set = (addr / entrySize) % (numEntries / assoc);
+
+    const auto first_candidates = first->getPossibleEntries(addr);
+    const auto second_candidates = second->getPossibleEntries(addr);
+    ASSERT_EQ(first_candidates.size(), assoc);
+    ASSERT_EQ(second_candidates.size(), assoc);
+    for (size_t way = 0; way < assoc; way++) {
+        ASSERT_EQ(first_candidates[way]->getSet(), set);
+        ASSERT_EQ(first_candidates[way]->getWay(), way);
+        ASSERT_NE(first_candidates[way], second_candidates[way]);
+    }
+
+    // Filling a whole set of one container must not evict the other
+    CacheEntry *entry = insert(*second, addr);
+    for (Addr tag = 1; tag <= assoc; tag++) {
+        const Addr conflict = addr + tag * numEntries / assoc * entrySize;
+        CacheEntry *victim = insert(*first, conflict);
+        ASSERT_NE(victim, entry);
+        ASSERT_EQ(first->findEntry(conflict), victim);
+    }
+    ASSERT_EQ(second->findEntry(addr), entry);
+    ASSERT_EQ(first->findEntry(addr), nullptr);
+}
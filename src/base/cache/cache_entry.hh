@@ -48,6 +48,7 @@
 #include "base/types.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
+#include "sim/serialize.hh"
 
 namespace gem5
 {
@@ -122,6 +123,26 @@ class CacheEntry : public ReplaceableEntry
                         isValid(), ReplaceableEntry::print());
     }
 
+    /**
+     * Checkpoint the tag of a valid entry. Entries holding more state
+     * extend these to checkpoint it as well.
+     */
+    void
+    serialize(CheckpointOut &cp) const
+    {
+        paramOut(cp, "tag", getTag());
+    }
+
+    /** Restore a checkpointed entry into this invalid entry. */
+    void
+    unserialize(CheckpointIn &cp)
+    {
+        Addr _tag;
+        paramIn(cp, "tag", _tag);
+        setValid();
+        setTag(_tag);
+    }
+
   protected:
     /**
      * Set tag associated to this block.
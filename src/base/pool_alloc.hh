@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Pools of fixed-size chunks for objects that are created and destroyed
+ * at a high rate, such as packets, requests and sender states.
+ *
+ * Every pooled type has its own free list per thread, so allocating and
+ * releasing never synchronize. Chunks are carved from slabs that are
+ * never returned to the system, and a chunk released by another thread
+ * than the one that allocated it simply joins the free list of the
+ * releasing thread.
+ *
+ * Pooling is opt-in: the classes using it only change their allocation
+ * when gem5 is built with USE_POOL_ALLOC. Builds with assertions count
+ * the objects of each pool that are still allocated, and warn at exit
+ * about the pools that still have some.
+ */
+
+#ifndef __BASE_POOL_ALLOC_HH__
+#define __BASE_POOL_ALLOC_HH__
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#include "base/logging.hh"
+#include "config/use_pool_alloc.hh"
+
+namespace gem5
+{
+
+/**
+ * The pool of the objects of one type.
+ *
+ * @tparam T The type of the pooled objects.
+ */
+template <class T>
+class ObjectPool
+{
+  private:
+    /** A chunk, which holds either an object or the next free chunk. */
+    union Chunk
+    {
+        Chunk *next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    /** Number of chunks carved at once when the free list runs out. */
+    static constexpr std::size_t slabChunks =
+        std::max<std::size_t>(16, 16384 / sizeof(Chunk));
+
+    /** The free chunks of the calling thread. */
+    static inline thread_local Chunk *freeList = nullptr;
+
+#ifndef NDEBUG
+    /** Objects allocated and not released yet, over all threads. */
+    static inline std::atomic<int64_t> live{0};
+
+    /** Reports the objects of the pool still allocated when destroyed. */
+    struct LeakCheck
+    {
+        ~LeakCheck()
+        {
+            warn_if(live != 0, "%d pooled objects of %d bytes were not "
+                    "released at exit.\n", live.load(), sizeof(T));
+        }
+    };
+#endif
+
+    /** Carve a new slab into free chunks. */
+    static void
+    refill()
+    {
+        Chunk *slab = new Chunk[slabChunks];
+        for (std::size_t i = 0; i < slabChunks; i++) {
+            slab[i].next = freeList;
+            freeList = &slab[i];
+        }
+    }
+
+  public:
+    /**
+     * Get a chunk large and aligned enough to construct a T in.
+     *
+     * @return The uninitialized chunk.
+     */
+    static void *
+    allocate()
+    {
+        if (!freeList) {
+            refill();
+        }
+        Chunk *chunk = freeList;
+        freeList = chunk->next;
+#ifndef NDEBUG
+        // Destroyed at exit, once the pool has been used
+        static LeakCheck leak_check;
+        live++;
+#endif
+        return chunk->storage;
+    }
+
+    /**
+     * Return a chunk to the pool. The object it held must have been
+     * destroyed already.
+     *
+     * @param p The chunk, as returned by allocate().
+     */
+    static void
+    deallocate(void *p)
+    {
+        Chunk *chunk = static_cast<Chunk *>(p);
+        chunk->next = freeList;
+        freeList = chunk;
+#ifndef NDEBUG
+        live--;
+#endif
+    }
+
+    /**
+     * Number of objects of this pool that are still allocated. Only
+     * builds with assertions keep track of it.
+     *
+     * @return The allocated objects, or zero if they are not tracked.
+     */
+    static int64_t
+    allocated()
+    {
+#ifndef NDEBUG
+        return live;
+#else
+        return 0;
+#endif
+    }
+};
+
+/**
+ * Classes deriving from this one are allocated from the pool of their
+ * type when pooling is enabled. Derived classes of a different size, e.g.
+ * the subclasses of a pooled base class, fall back to the global heap, so
+ * the types that are worth pooling should derive from it themselves.
+ *
+ * @tparam T The pooled class.
+ */
+template <class T>
+class PoolAllocated
+{
+#if USE_POOL_ALLOC
+  public:
+    static void *
+    operator new(std::size_t size)
+    {
+        if (size != sizeof(T)) {
+            return ::operator new(size);
+        }
+        return ObjectPool<T>::allocate();
+    }
+
+    static void
+    operator delete(void *p, std::size_t size)
+    {
+        if (size != sizeof(T)) {
+            ::operator delete(p);
+        } else {
+            ObjectPool<T>::deallocate(p);
+        }
+    }
+#endif
+};
+
+/**
+ * A standard allocator on top of the object pools, e.g., to pool the
+ * objects created by std::allocate_shared together with their control
+ * block. Arrays are allocated from the global heap.
+ *
+ * @tparam T The allocated type.
+ */
+template <class T>
+class PoolAllocator
+{
+  public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template <class U>
+    PoolAllocator(const PoolAllocator<U> &other) {}
+
+    T *
+    allocate(std::size_t n)
+    {
+        if (n != 1) {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T *>(ObjectPool<T>::allocate());
+    }
+
+    void
+    deallocate(T *p, std::size_t n)
+    {
+        if (n != 1) {
+            std::allocator<T>().deallocate(p, n);
+        } else {
+            ObjectPool<T>::deallocate(p);
+        }
+    }
+
+    template <class U>
+    bool operator==(const PoolAllocator<U> &other) const { return true; }
+
+    template <class U>
+    bool operator!=(const PoolAllocator<U> &other) const { return false; }
+};
+
+/**
+ * Pools of data buffers, with one pool per power-of-two size up to
+ * maxSize. Larger buffers are allocated from the global heap.
+ */
+class BufferPool
+{
+  private:
+    template <std::size_t N>
+    struct Buffer
+    {
+        alignas(std::max_align_t) uint8_t bytes[N];
+    };
+
+    template <std::size_t N>
+    static uint8_t *
+    allocateFrom(std::size_t size)
+    {
+        if constexpr (N > maxSize) {
+            return new uint8_t[size];
+        } else {
+            return size <= N ?
+                static_cast<uint8_t *>(ObjectPool<Buffer<N>>::allocate()) :
+                allocateFrom<2 * N>(size);
+        }
+    }
+
+    template <std::size_t N>
+    static void
+    deallocateTo(uint8_t *p, std::size_t size)
+    {
+        if constexpr (N > maxSize) {
+            delete [] p;
+        } else if (size <= N) {
+            ObjectPool<Buffer<N>>::deallocate(p);
+        } else {
+            deallocateTo<2 * N>(p, size);
+        }
+    }
+
+  public:
+    /** The largest pooled size, which covers the usual block sizes. */
+    static constexpr std::size_t maxSize = 1024;
+
+    /**
+     * Allocate a buffer.
+     *
+     * @param size The size of the buffer, in bytes.
+     * @return The uninitialized buffer.
+     */
+    static uint8_t *
+    allocate(std::size_t size)
+    {
+        return allocateFrom<16>(size);
+    }
+
+    /**
+     * Release a buffer.
+     *
+     * @param p The buffer, as returned by allocate().
+     * @param size The size it was allocated with.
+     */
+    static void
+    deallocate(uint8_t *p, std::size_t size)
+    {
+        deallocateTo<16>(p, size);
+    }
+};
+
+} // namespace gem5
+
+#endif // __BASE_POOL_ALLOC_HH__
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "base/gtest/cur_tick_fake.hh"
+#include "base/pool_alloc.hh"
+#include "config/use_pool_alloc.hh"
+#include "mem/packet.hh"
+#include "mem/request.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+GTestTickHandler tickHandler;
+
+struct Pooled
+{
+    uint64_t a;
+    uint32_t b;
+};
+
+struct alignas(64) Aligned
+{
+    uint8_t bytes[8];
+};
+
+} // anonymous namespace
+
+TEST(PoolAllocTest, ReusesReleasedChunks)
+{
+    void *first = ObjectPool<Pooled>::allocate();
+    ObjectPool<Pooled>::deallocate(first);
+    void *second = ObjectPool<Pooled>::allocate();
+    EXPECT_EQ(first, second);
+    ObjectPool<Pooled>::deallocate(second);
+}
+
+TEST(PoolAllocTest, DistinctChunks)
+{
+    // Span more than a slab to exercise refills
+    constexpr int num_chunks = 5000;
+    std::unique_ptr<void *[]> chunks(new void *[num_chunks]);
+    for (int i = 0; i < num_chunks; i++) {
+        chunks[i] = ObjectPool<Pooled>::allocate();
+        std::memset(chunks[i], i & 0xff, sizeof(Pooled));
+    }
+    for (int i = 0; i < num_chunks; i++) {
+        const uint8_t *bytes = static_cast<const uint8_t *>(chunks[i]);
+        for (std::size_t j = 0; j < sizeof(Pooled); j++) {
+            ASSERT_EQ(bytes[j], i & 0xff);
+        }
+    }
+    for (int i = 0; i < num_chunks; i++) {
+        ObjectPool<Pooled>::deallocate(chunks[i]);
+    }
+}
+
+TEST(PoolAllocTest, Alignment)
+{
+    void *chunks[4];
+    for (auto &chunk : chunks) {
+        chunk = ObjectPool<Aligned>::allocate();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(chunk) % alignof(Aligned), 0);
+    }
+    for (auto chunk : chunks) {
+        ObjectPool<Aligned>::deallocate(chunk);
+    }
+}
+
+#ifndef NDEBUG
+TEST(PoolAllocTest, CountsAllocatedObjects)
+{
+    const int64_t before = ObjectPool<Pooled>::allocated();
+    void *chunk = ObjectPool<Pooled>::allocate();
+    EXPECT_EQ(ObjectPool<Pooled>::allocated(), before + 1);
+    ObjectPool<Pooled>::deallocate(chunk);
+    EXPECT_EQ(ObjectPool<Pooled>::allocated(), before);
+}
+#endif
+
+TEST(PoolAllocTest, SharedPointers)
+{
+    auto ptr = std::allocate_shared<Pooled>(PoolAllocator<Pooled>(),
+                                            Pooled{1, 2});
+    EXPECT_EQ(ptr->a, 1);
+    EXPECT_EQ(ptr->b, 2);
+    auto copy = ptr;
+    ptr.reset();
+    EXPECT_EQ(copy->a, 1);
+}
+
+TEST(PoolAllocTest, Buffers)
+{
+    for (std::size_t size : {1, 16, 17, 64, 1024, 1025, 4096}) {
+        uint8_t *buffer = BufferPool::allocate(size);
+        std::memset(buffer, 0xa5, size);
+        BufferPool::deallocate(buffer, size);
+    }
+
+    // Buffers of the same size class are recycled
+    uint8_t *first = BufferPool::allocate(60);
+    BufferPool::deallocate(first, 60);
+    uint8_t *second = BufferPool::allocate(64);
+    EXPECT_EQ(first, second);
+    BufferPool::deallocate(second, 64);
+}
+
+/** Packets and requests work whether they are pooled or not. */
+TEST(PoolAllocTest, PacketsAndRequests)
+{
+    RequestPtr req = Request::create(0x1000, 64, 0, 0);
+    EXPECT_EQ(req->getPaddr(), 0x1000);
+
+    PacketPtr pkt = new Packet(req, MemCmd::WriteReq);
+    pkt->allocate();
+    uint8_t data[64];
+    std::memset(data, 0x5a, sizeof(data));
+    pkt->setData(data);
+    EXPECT_EQ(std::memcmp(pkt->getConstPtr<uint8_t>(), data, sizeof(data)),
+              0);
+    delete pkt;
+}
+
+#if USE_POOL_ALLOC
+/** Released packets and their data are reused from their pools. */
+TEST(PoolAllocTest, PooledPackets)
+{
+    RequestPtr req = Request::create(0x1000, 64, 0, 0);
+#ifndef NDEBUG
+    const int64_t before = ObjectPool<Packet>::allocated();
+#endif
+
+    PacketPtr pkt = new Packet(req, MemCmd::WriteReq);
+    pkt->allocate();
+    const Packet *pkt_addr = pkt;
+    const uint8_t *data_addr = pkt->getConstPtr<uint8_t>();
+#ifndef NDEBUG
+    EXPECT_EQ(ObjectPool<Packet>::allocated(), before + 1);
+#endif
+    delete pkt;
+#ifndef NDEBUG
+    EXPECT_EQ(ObjectPool<Packet>::allocated(), before);
+#endif
+
+    pkt = new Packet(req, MemCmd::WriteReq);
+    pkt->allocate();
+    EXPECT_EQ(pkt, pkt_addr);
+    EXPECT_EQ(pkt->getConstPtr<uint8_t>(), data_addr);
+    delete pkt;
+}
+
+/** A request is allocated with its reference count, from a pool. */
+TEST(PoolAllocTest, PooledRequests)
+{
+    RequestPtr req = Request::create(0x1000, 64, 0, 0);
+    const Request *req_addr = req.get();
+    req.reset();
+
+    req = Request::create(0x2000, 64, 0, 0);
+    EXPECT_EQ(req.get(), req_addr);
+    EXPECT_EQ(req->getPaddr(), 0x2000);
+}
+#endif
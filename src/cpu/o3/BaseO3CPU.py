@@ -90,6 +90,15 @@ class BaseO3CPU(BaseCPU):
     fetchBufferSize = Param.Unsigned(64, "Fetch buffer size in bytes")
     fetchQueueSize = Param.Unsigned(140, "Fetch queue size in micro-ops "
                                     "per-thread")
+    fetchTargetQueueSize = Param.Unsigned(8, "Number of cache blocks the "
+                                          "fetch-target queue predicts ahead "
+                                          "of fetch, used only when an "
+                                          "instruction prefetcher follows it")
+    fetchTargetWidth = Param.Unsigned(2, "Number of cache blocks added to "
+                                      "the fetch-target queue per cycle")
+    fetchTargetAlign = Param.Unsigned(1, "Alignment of the branches the "
+                                      "fetch-target queue looks up in the "
+                                      "BTB, in bytes")
 
     renameToDecodeDelay = Param.Cycles(1, "Rename to decode delay")
     iewToDecodeDelay = Param.Cycles(
@@ -329,6 +329,7 @@ CPU::regProbePoints()
     ppDataAccessComplete = new ProbePointArg<
         std::pair<DynInstPtr, PacketPtr>>(
                 getProbeManager(), "DataAccessComplete");
+    ppLoadValue = new probing::LoadValue(getProbeManager(), "LoadValue");
 
     fetch.regProbePoints();
     rename.regProbePoints();
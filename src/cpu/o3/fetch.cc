@@ -95,6 +95,9 @@ Fetch::Fetch(CPU *_cpu, const BaseO3CPUParams &params)
       fetchBufferSize(params.fetchBufferSize),
       fetchBufferMask(fetchBufferSize - 1),
       fetchQueueSize(params.fetchQueueSize),
+      fetchTargetQueueSize(params.fetchTargetQueueSize),
+      fetchTargetWidth(params.fetchTargetWidth),
+      fetchTargetAlign(params.fetchTargetAlign),
       numThreads(params.numThreads),
       numFetchingThreads(params.smtNumFetchingThreads),
       icachePort(this, _cpu),
@@ -114,6 +117,9 @@ Fetch::Fetch(CPU *_cpu, const BaseO3CPUParams &params)
     if (cacheBlkSize % fetchBufferSize)
         fatal("cache block (%u bytes) is not a multiple of the "
               "fetch buffer (%u bytes)\n", cacheBlkSize, fetchBufferSize);
+    if (fetchTargetAlign == 0)
+        fatal("The alignment of the branches looked up by the fetch-target "
+              "queue cannot be zero\n");
 
     for (int i = 0; i < MaxThreads; i++) {
         fetchStatus[i] = Idle;
@@ -129,6 +135,9 @@ Fetch::Fetch(CPU *_cpu, const BaseO3CPUParams &params)
         fetchBufferValid[i] = false;
         lastIcacheStall[i] = 0;
         issuePipelinedIfetch[i] = false;
+        fetchTargetBlock[i] = MaxAddr;
+        fetchTargetPC[i] = 0;
+        fetchTargetHit[i] = false;
     }
 
     branchPred = params.branchPred;
@@ -152,6 +161,8 @@ Fetch::regProbePoints()
     ppFetch = new ProbePointArg<DynInstPtr>(cpu->getProbeManager(), "Fetch");
     ppFetchRequestSent = new ProbePointArg<RequestPtr>(cpu->getProbeManager(),
                                                        "FetchRequest");
+    ppFetchTarget = new probing::FetchTarget(cpu->getProbeManager(),
+                                             "FetchTarget");
 
 }
 
@@ -193,7 +204,18 @@ Fetch::FetchStatGroup::FetchStatGroup(CPU *cpu, Fetch *fetch)
              "Number of instructions fetched each cycle (Total)"),
     ADD_STAT(idleRate, statistics::units::Ratio::get(),
              "Ratio of cycles fetch was idle",
-             idleCycles / cpu->baseStats.numCycles)
+             idleCycles / cpu->baseStats.numCycles),
+    ADD_STAT(ftqPredictions, statistics::units::Count::get(),
+             "Number of cache blocks added to the fetch-target queue"),
+    ADD_STAT(ftqHits, statistics::units::Count::get(),
+             "Number of cache blocks fetch went to as the fetch-target "
+             "queue predicted"),
+    ADD_STAT(ftqRedirects, statistics::units::Count::get(),
+             "Number of times fetch left the path of the fetch-target "
+             "queue"),
+    ADD_STAT(ftqStallCycles, statistics::units::Cycle::get(),
+             "Number of I-cache stall cycles on cache blocks the "
+             "fetch-target queue predicted")
 {
         predictedBranches
             .prereq(predictedBranches);
@@ -232,6 +254,14 @@ Fetch::FetchStatGroup::FetchStatGroup(CPU *cpu, Fetch *fetch)
             .flags(statistics::pdf);
         idleRate
             .prereq(idleRate);
+        ftqPredictions
+            .prereq(ftqPredictions);
+        ftqHits
+            .prereq(ftqHits);
+        ftqRedirects
+            .prereq(ftqRedirects);
+        ftqStallCycles
+            .prereq(ftqStallCycles);
 }
 void
 Fetch::setTimeBuffer(TimeBuffer<TimeStruct> *time_buffer)
@@ -283,6 +313,7 @@ Fetch::clearStates(ThreadID tid)
     fetchBufferPC[tid] = 0;
     fetchBufferValid[tid] = false;
     fetchQueue[tid].clear();
+    resetFetchTargets(tid, pc[tid]->instAddr());
 
     // TODO not sure what to do with priorityList for now
     // priorityList.push_back(tid);
@@ -314,6 +345,7 @@ Fetch::resetStage()
         fetchBufferValid[tid] = false;
 
         fetchQueue[tid].clear();
+        resetFetchTargets(tid, pc[tid]->instAddr());
 
         priorityList.push_back(tid);
     }
@@ -723,6 +755,9 @@ Fetch::doSquash(const PCStateBase &new_pc, const DynInstPtr squashInst,
     // Empty fetch queue
     fetchQueue[tid].clear();
 
+    // Predict the fetch targets again from the new PC
+    resetFetchTargets(tid, new_pc.instAddr());
+
     // microops are being squashed, it is not known wheather the
     // youngest non-squashed microop was  marked delayed commit
     // or not. Setting the flag to true ensures that the
@@ -851,6 +886,14 @@ Fetch::tick()
         fetch(status_change);
     }
 
+    // Run the fetch-target queues ahead of fetch, for the instruction
+    // prefetchers that follow them.
+    if (ppFetchTarget->hasListeners()) {
+        for (auto tid : *activeThreads) {
+            updateFetchTargets(tid);
+        }
+    }
+
     // Record number of instructions fetched this cycle for distribution.
     fetchStats.nisnDist.sample(numInst);
 
@@ -1124,6 +1167,9 @@ Fetch::fetch(bool &status_change)
 
             if (fetchStatus[tid] == IcacheWaitResponse) {
                 cpu->fetchStats[tid]->icacheStallCycles++;
+                if (fetchTargetHit[tid]) {
+                    ++fetchStats.ftqStallCycles;
+                }
             }
             else if (fetchStatus[tid] == ItlbWait)
                 ++fetchStats.tlbCycles;
@@ -1329,6 +1375,69 @@ Fetch::fetch(bool &status_change)
         !curMacroop;
 }
 
+void
+Fetch::resetFetchTargets(ThreadID tid, Addr fetch_pc)
+{
+    if (!fetchTargetQueue[tid].empty()) {
+        ++fetchStats.ftqRedirects;
+    }
+    fetchTargetQueue[tid].clear();
+    fetchTargetBlock[tid] = cacheBlockAlign(fetch_pc);
+    fetchTargetPC[tid] = fetch_pc;
+    fetchTargetHit[tid] = false;
+}
+
+Addr
+Fetch::predictFetchTarget(ThreadID tid)
+{
+    Addr &target_pc = fetchTargetPC[tid];
+    const Addr block_end = cacheBlockAlign(target_pc) + cacheBlkSize;
+
+    for (Addr inst_pc = target_pc; inst_pc < block_end;
+         inst_pc += fetchTargetAlign) {
+        const PCStateBase *target = branchPred->BTBPeek(tid, inst_pc);
+        if (target) {
+            DPRINTF(Fetch, "[tid:%i] Fetch-target queue predicts branch %#x "
+                    "to %s\n", tid, inst_pc, *target);
+            target_pc = target->instAddr();
+            return cacheBlockAlign(target_pc);
+        }
+    }
+
+    // No taken branch, fetch falls through to the next block
+    target_pc = block_end;
+    return block_end;
+}
+
+void
+Fetch::updateFetchTargets(ThreadID tid)
+{
+    std::deque<Addr> &queue = fetchTargetQueue[tid];
+    const Addr block = cacheBlockAlign(pc[tid]->instAddr());
+
+    if (block != fetchTargetBlock[tid]) {
+        auto it = std::find(queue.begin(), queue.end(), block);
+        if (it == queue.end()) {
+            resetFetchTargets(tid, pc[tid]->instAddr());
+        } else {
+            // Drop the blocks fetch went past, up to the one it is in now
+            queue.erase(queue.begin(), it + 1);
+            fetchTargetBlock[tid] = block;
+            fetchTargetHit[tid] = true;
+            ++fetchStats.ftqHits;
+        }
+    }
+
+    for (unsigned i = 0; i < fetchTargetWidth &&
+         queue.size() < fetchTargetQueueSize; i++) {
+        const Addr target = predictFetchTarget(tid);
+        queue.push_back(target);
+        ++fetchStats.ftqPredictions;
+        ppFetchTarget->notify(probing::FetchTargetInfo{
+            target, static_cast<unsigned>(queue.size())});
+    }
+}
+
 void
 Fetch::recvReqRetry()
 {
@@ -1551,6 +1660,9 @@ Fetch::profileStall(ThreadID tid)
         DPRINTF(Fetch, "[tid:%i] Fetch is squashing!\n", tid);
     } else if (fetchStatus[tid] == IcacheWaitResponse) {
         cpu->fetchStats[tid]->icacheStallCycles++;
+        if (fetchTargetHit[tid]) {
+            ++fetchStats.ftqStallCycles;
+        }
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting cache response!\n",
                 tid);
     } else if (fetchStatus[tid] == ItlbWait) {
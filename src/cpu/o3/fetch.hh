@@ -56,6 +56,7 @@
 #include "mem/packet.hh"
 #include "mem/port.hh"
 #include "sim/eventq.hh"
+#include "sim/probe/mem.hh"
 #include "sim/probe/probe.hh"
 
 namespace gem5
@@ -200,6 +201,8 @@ class Fetch
     ProbePointArg<DynInstPtr> *ppFetch;
     /** To probe when a fetch request is successfully sent. */
     ProbePointArg<RequestPtr> *ppFetchRequestSent;
+    /** To probe when a block is added to the fetch-target queue. */
+    probing::FetchTarget *ppFetchTarget;
 
     Random::RandomPtr rng = Random::genRandom();
 
@@ -326,6 +329,31 @@ class Fetch
      * cycle. */
     FetchStatus updateFetchStatus();
 
+    /** Align an address to the start of a cache block. */
+    Addr cacheBlockAlign(Addr addr) const
+    {
+        return addr & ~(cacheBlkSize - 1);
+    }
+
+    /** Empties the fetch-target queue, to predict again from a PC. */
+    void resetFetchTargets(ThreadID tid, Addr fetch_pc);
+
+    /**
+     * Follows fetch in the fetch-target queue, and adds the next blocks
+     * predicted by the BTB to the queue, up to its size. Only done when
+     * something listens to the FetchTarget probe point.
+     */
+    void updateFetchTargets(ThreadID tid);
+
+    /**
+     * Predicts the block fetch goes to after the block of the fetch-target
+     * PC, and moves the fetch-target PC there. The first branch that hits
+     * in the BTB from that PC to the end of its block is predicted taken,
+     * as the BTB only holds taken branches.
+     * @return The predicted block.
+     */
+    Addr predictFetchTarget(ThreadID tid);
+
   public:
     /** Squashes a specific thread and resets the PC. Also tells the CPU to
      * remove any instructions that are not in the ROB. The source of this
@@ -498,6 +526,31 @@ class Fetch
     /** Whether or not the fetch buffer data is valid. */
     bool fetchBufferValid[MaxThreads];
 
+    /** The size of the fetch-target queue in cache blocks. */
+    unsigned fetchTargetQueueSize;
+
+    /** Number of blocks added to the fetch-target queue each cycle. */
+    unsigned fetchTargetWidth;
+
+    /** Alignment of the branches looked up in the BTB, in bytes. */
+    unsigned fetchTargetAlign;
+
+    /**
+     * Fetch-target queue. It holds the cache blocks predicted to follow
+     * the block fetch is in, so that instruction prefetchers can run
+     * ahead of fetch.
+     */
+    std::deque<Addr> fetchTargetQueue[MaxThreads];
+
+    /** The cache block fetch was in when the queue was last updated. */
+    Addr fetchTargetBlock[MaxThreads];
+
+    /** The PC the fetch-target queue predicts from next. */
+    Addr fetchTargetPC[MaxThreads];
+
+    /** Whether fetch is in a block the fetch-target queue predicted. */
+    bool fetchTargetHit[MaxThreads];
+
     /** Size of instructions. */
     int instSize;
 
@@ -578,6 +631,15 @@ class Fetch
         statistics::Distribution nisnDist;
         /** Rate of how often fetch was idle. */
         statistics::Formula idleRate;
+        /** Number of blocks added to the fetch-target queue. */
+        statistics::Scalar ftqPredictions;
+        /** Number of blocks fetch went to as the queue predicted. */
+        statistics::Scalar ftqHits;
+        /** Number of times fetch left the path of the queue. */
+        statistics::Scalar ftqRedirects;
+        /** Number of I-cache stall cycles on blocks the queue predicted,
+         *  which the instruction prefetcher did not bring in time. */
+        statistics::Scalar ftqStallCycles;
     } fetchStats;
 };
 
@@ -42,6 +42,8 @@
 #include "cpu/o3/lsq_unit.hh"
 
 #include "arch/generic/debugfaults.hh"
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
 #include "base/str.hh"
 #include "cpu/checker/cpu.hh"
 #include "cpu/o3/dyn_inst.hh"
@@ -162,6 +164,17 @@ LSQUnit::completeDataAccess(PacketPtr pkt)
 
     cpu->ppDataAccessComplete->notify(std::make_pair(inst, pkt));
 
+    if (cpu->ppLoadValue->hasListeners() && inst->isLoad() &&
+        !inst->isSquashed() && pkt->isRead() && pkt->hasData() &&
+        !pkt->htmTransactionFailedInCache() &&
+        isPowerOf2(pkt->getSize()) && pkt->getSize() <= sizeof(uint64_t)) {
+        cpu->ppLoadValue->notify(probing::LoadValueInfo{
+            inst->pcState().instAddr(), inst->effAddr, inst->physEffAddr,
+            pkt->getSize(),
+            sext(pkt->getUintX(cpu->system->getGuestByteOrder()),
+                 pkt->getSize() * 8)});
+    }
+
     assert(!cpu->switchedOut());
     if (!inst->isSquashed()) {
         if (request->needWBToRegister()) {
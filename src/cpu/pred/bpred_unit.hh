@@ -213,6 +213,20 @@ class BPredUnit : public SimObject
         return btb->lookup(tid, instPC.instAddr());
     }
 
+    /**
+     * Looks up a given PC in the BTB to get the predicted target, without
+     * updating the statistics or the replacement state of the BTB. This
+     * lets a decoupled front-end predict ahead of fetch.
+     * @param tid The thread id.
+     * @param inst_PC The PC to look up.
+     * @return The target of the branch, nullptr if not in the BTB.
+     */
+    const PCStateBase *
+    BTBPeek(ThreadID tid, Addr instPC)
+    {
+        return btb->peek(tid, instPC);
+    }
+
     /**
      * Looks up a given PC in the BTB to get current static instruction
      * information. This is necessary in a decoupled frontend as
@@ -53,14 +53,14 @@ BaseGen::BaseGen(SimObject &obj, RequestorID requestor_id, Tick _duration)
 
 PacketPtr
 BaseGen::getPacket(Addr addr, unsigned size, const MemCmd& cmd,
-                   Request::FlagsType flags)
+                   Request::FlagsType flags, Addr pc)
 {
     // Create new request
     RequestPtr req = std::make_shared<Request>(addr, size, flags,
                                                requestorId);
-    // Dummy PC to have PC-based prefetchers latch on; get entropy into higher
-    // bits
-    req->setPC(((Addr)requestorId) << 2);
+    // Unless a PC is given, use a dummy PC to have PC-based prefetchers
+    // latch on; get entropy into higher bits
+    req->setPC(pc != 0 ? pc : ((Addr)requestorId) << 2);
 
     // Embed it in a packet
     PacketPtr pkt = new Packet(req, cmd);
@@ -82,9 +82,10 @@ class BaseGen
      * @param size Size of the request
      * @param cmd Memory command to send
      * @param flags Optional request flags
+     * @param pc Optional PC of the request, 0 for a dummy one
      */
     PacketPtr getPacket(Addr addr, unsigned size, const MemCmd& cmd,
-                        Request::FlagsType flags = 0);
+                        Request::FlagsType flags = 0, Addr pc = 0);
 
   public:
 
@@ -84,6 +84,7 @@ TraceGen::InputStream::read(TraceElement& element)
         element.blocksize = pkt_msg.size();
         element.tick = pkt_msg.tick();
         element.flags = pkt_msg.has_flags() ? pkt_msg.flags() : 0;
+        element.pc = pkt_msg.has_pc() ? pkt_msg.pc() : 0;
         return true;
     }
 
@@ -150,7 +151,8 @@ TraceGen::getNextPacket()
 
     PacketPtr pkt = getPacket(currElement.addr + addrOffset,
                               currElement.blocksize,
-                              currElement.cmd, currElement.flags);
+                              currElement.cmd, currElement.flags,
+                              currElement.pc);
 
     if (!traceComplete)
         DPRINTF(TrafficGen, "nextElement: %c addr %d size %d tick %d (%d)\n",
@@ -84,6 +84,9 @@ class TraceGen : public BaseGen
         /** Potential request flags to use */
         Request::FlagsType flags;
 
+        /** PC of the request, 0 if the trace does not record it */
+        Addr pc;
+
         /**
          * Check validity of this element.
          *
@@ -464,7 +464,9 @@ AbstractMemory::access(PacketPtr pkt)
         // no need to do anything
     } else if (pkt->isWrite()) {
         if (writeOK(pkt)) {
-            if (pmemAddr) {
+            // Tag-only caches write their data through and only send a
+            // placeholder when writing a block back
+            if (pmemAddr && !pkt->hasPlaceholderData()) {
                 pkt->writeData(host_addr);
                 DPRINTF(MemoryAccess, "%s write due to %s\n",
                         __func__, pkt->print());
@@ -136,6 +136,13 @@ class BaseCache(ClockedObject):
         False, "Whether to access tags and data sequentially"
     )
 
+    # A tag-only cache models the timing of its accesses without holding
+    # any data: memory keeps the only copy, and writes go through to it.
+    # Every cache of the hierarchy must then be tag-only, as a cache
+    # holding data cannot be filled by one that has none. Prefetchers
+    # relying on the data of fills, e.g. IndirectMemory, are unsupported.
+    tag_only = Param.Bool(False, "Whether the blocks hold no data")
+
     cpu_side = ResponsePort("Upstream port closer to the CPU and/or device")
     mem_side = RequestPort("Downstream port closer to memory")
 
@@ -45,6 +45,8 @@
 
 #include "mem/cache/base.hh"
 
+#include <cstring>
+
 #include "base/compiler.hh"
 #include "base/logging.hh"
 #include "debug/Cache.hh"
@@ -102,6 +104,7 @@ BaseCache::BaseCache(const BaseCacheParams &p, unsigned blk_size)
       fillLatency(p.data_latency),
       responseLatency(p.response_latency),
       sequentialAccess(p.sequential_access),
+      tagOnly(p.tag_only),
       numTarget(p.tgts_per_mshr),
       forwardSnoops(true),
       clusivity(p.clusivity),
@@ -130,11 +133,14 @@ BaseCache::BaseCache(const BaseCacheParams &p, unsigned blk_size)
 
     tags->tagsInit();
     if (prefetcher)
-        prefetcher->setParentInfo(system, getProbeManager(), getBlockSize());
+        prefetcher->setParentInfo(system, getProbeManager(), accessor,
+                                  getBlockSize());
 
     fatal_if(compressor && !dynamic_cast<CompressedTags*>(tags),
         "The tags of compressed cache %s must derive from CompressedTags",
         name());
+    fatal_if(compressor && tagOnly,
+        "Tag-only cache %s has no data to compress", name());
     warn_if(!compressor && dynamic_cast<CompressedTags*>(tags),
         "Compressed cache %s does not have a compression algorithm", name());
     if (compressor)
@@ -146,6 +152,16 @@ BaseCache::~BaseCache()
     delete tempBlock;
 }
 
+void
+BaseCache::CacheAccessorImpl::prefetchQueued()
+{
+    Tick next_pf_time = std::max(cache.prefetcher->nextPrefetchReadyTime(),
+                                 cache.clockEdge());
+    if (next_pf_time != MaxTick) {
+        cache.schedMemSideSendEvent(next_pf_time);
+    }
+}
+
 void
 BaseCache::CacheResponsePort::setBlocked()
 {
@@ -250,7 +266,7 @@ BaseCache::handleTimingReqHit(PacketPtr pkt, CacheBlk *blk, Tick request_time)
             // Basically we need to get the MSHR in the same state as if
             // we had missed and just received the response.
             // Request *req2 = new Request(*(pkt->req));
-            RequestPtr req2 = std::make_shared<Request>(*(pkt->req));
+            RequestPtr req2 = Request::create(*(pkt->req));
             PacketPtr pkt2 = new Packet(req2, pkt->cmd);
             MSHR *mshr = allocateMissBuffer(pkt2, curTick(), true);
             // Mark the MSHR "in service" (even though it's not) to prevent
@@ -344,6 +360,13 @@ BaseCache::handleTimingReqMiss(PacketPtr pkt, MSHR *mshr, CacheBlk *blk,
                 assert(pkt->req->requestorId() < system->maxRequestors());
                 stats.cmdStats(pkt).mshrHits[pkt->req->requestorId()]++;
 
+                // A demand joining the MSHR of a prefetch shows the
+                // prefetch was late
+                if (prefetcher && pkt->isDemand() &&
+                    mshr->getTarget()->pkt->cmd.isHWPrefetch()) {
+                    prefetcher->prefetchLate(pkt->getAddr(), pkt->isSecure());
+                }
+
                 // We use forward_time here because it is the same
                 // considering new targets. We have multiple
                 // requests for the same address here. It
@@ -671,7 +694,7 @@ BaseCache::recvAtomic(PacketPtr pkt)
         lat += handleAtomicReqMiss(pkt, blk, writebacks);
     }
 
-    // Note that we don't invoke the prefetcher at all in atomic mode.
+    // Note that we don't prefetch at all in atomic mode.
     // It's not clear how to do it properly, particularly for
     // prefetchers that aggressively generate prefetch candidates and
     // rely on bandwidth contention to throttle them; these will tend
@@ -680,7 +703,12 @@ BaseCache::recvAtomic(PacketPtr pkt)
     // mode, though, this is the place to do it... see timingAccess()
     // for an example (though we'd want to issue the prefetch(es)
     // immediately rather than calling requestMemSideBus() as we do
-    // there).
+    // there). A prefetcher can still learn from the accesses, e.g. when
+    // fast forwarding, so that it is warm when switching to timing mode.
+    if (prefetcher) {
+        prefetcher->warmAtomic(CacheAccessProbeArg(pkt, accessor),
+                               !satisfied, !satisfied && blk);
+    }
 
     // do any writebacks resulting from the response handling
     doWritebacksAtomic(writebacks);
@@ -733,7 +761,7 @@ BaseCache::functionalAccess(PacketPtr pkt, bool from_cpu_side)
     // we have it, but only declare it satisfied if we are the owner.
 
     // see if we have data at all (owned or otherwise)
-    bool have_data = blk && blk->isValid()
+    bool have_data = blk && blk->isValid() && !tagOnly
         && pkt->trySatisfyFunctional(&cbpw, blk_addr, is_secure, blkSize,
                                      blk->data);
 
@@ -785,6 +813,10 @@ BaseCache::updateBlockData(CacheBlk *blk, const PacketPtr cpkt,
         }
     }
 
+    fatal_if(cpkt && cpkt->hasPlaceholderData(), "%s received %s from a "
+             "tag-only cache, but holds data. All the caches of the "
+             "hierarchy must be tag-only.\n", name(), cpkt->print());
+
     // Actually perform the data update
     if (cpkt) {
         cpkt->writeDataToBlock(blk->data, blkSize);
@@ -855,6 +887,88 @@ BaseCache::cmpAndSwap(CacheBlk *blk, PacketPtr pkt)
     }
 }
 
+void
+BaseCache::accessBackingStore(Addr addr, unsigned size, bool is_secure,
+                              uint8_t *data, bool write)
+{
+    MemBackdoorPtr backdoor = getBackdoor(RangeSize(addr, size));
+    if (backdoor) {
+        uint8_t *host_addr =
+            backdoor->ptr() + (addr - backdoor->range().start());
+        if (write) {
+            std::memcpy(host_addr, data, size);
+        } else {
+            std::memcpy(data, host_addr, size);
+        }
+        return;
+    }
+
+    RequestPtr req = Request::create(addr, size, 0, Request::funcRequestorId);
+    if (is_secure) {
+        req->setFlags(Request::SECURE);
+    }
+
+    Packet pkt(req, write ? MemCmd::WriteReq : MemCmd::ReadReq);
+    pkt.dataStatic(data);
+    memSidePort.sendFunctional(&pkt);
+}
+
+void
+BaseCache::writeBackingStore(PacketPtr pkt)
+{
+    uint8_t *data = pkt->getPtr<uint8_t>();
+    if (!pkt->isMaskedWrite()) {
+        accessBackingStore(pkt->getAddr(), pkt->getSize(), pkt->isSecure(),
+                           data, true);
+        return;
+    }
+
+    // Write each run of enabled bytes, leaving the others untouched
+    const std::vector<bool> &byte_enable = pkt->req->getByteEnable();
+    assert(byte_enable.size() == pkt->getSize());
+    unsigned start = 0;
+    while (start < byte_enable.size()) {
+        if (!byte_enable[start]) {
+            start++;
+            continue;
+        }
+        unsigned end = start + 1;
+        while (end < byte_enable.size() && byte_enable[end]) {
+            end++;
+        }
+        accessBackingStore(pkt->getAddr() + start, end - start,
+                           pkt->isSecure(), data + start, true);
+        start = end;
+    }
+}
+
+MemBackdoorPtr
+BaseCache::getBackdoor(const AddrRange &range)
+{
+    for (MemBackdoorPtr backdoor : backdoors) {
+        if (range.isSubset(backdoor->range())) {
+            return backdoor;
+        }
+    }
+
+    MemBackdoorPtr backdoor = nullptr;
+    memSidePort.sendMemBackdoorReq(MemBackdoorReq(range,
+        MemBackdoor::Flags(MemBackdoor::Readable | MemBackdoor::Writeable)),
+        backdoor);
+    if (!backdoor || !backdoor->readable() || !backdoor->writeable() ||
+        !range.isSubset(backdoor->range())) {
+        return nullptr;
+    }
+
+    // Forget the backdoor when it is revoked, e.g., when a load locked
+    // reaches the memory
+    backdoor->addInvalidationCallback([this](const MemBackdoor &backdoor) {
+        backdoors.erase(const_cast<MemBackdoorPtr>(&backdoor));
+    });
+    backdoors.insert(backdoor);
+    return backdoor;
+}
+
 QueueEntry*
 BaseCache::getNextQueueEntry()
 {
@@ -1114,6 +1228,19 @@ BaseCache::satisfyRequest(PacketPtr pkt, CacheBlk *blk, bool, bool)
     // Check RMW operations first since both isRead() and
     // isWrite() will be true for them
     if (pkt->cmd == MemCmd::SwapReq) {
+        // A tag-only cache only reads and writes back the bytes of the
+        // operation, unless the update of the whole block is probed
+        const int blk_offset = pkt->getOffset(blkSize);
+        if (tagOnly) {
+            if (ppDataUpdate->hasListeners()) {
+                accessBackingStore(blk, false);
+            } else {
+                accessBackingStore(pkt->getAddr(), pkt->getSize(),
+                                   pkt->isSecure(), blk->data + blk_offset,
+                                   false);
+            }
+        }
+
         if (pkt->isAtomicOp()) {
             // Get a copy of the old block's contents for the probe before
             // the update
@@ -1147,6 +1274,12 @@ BaseCache::satisfyRequest(PacketPtr pkt, CacheBlk *blk, bool, bool)
         } else {
             cmpAndSwap(blk, pkt);
         }
+
+        if (tagOnly) {
+            accessBackingStore(pkt->getAddr(), pkt->getSize(),
+                               pkt->isSecure(), blk->data + blk_offset,
+                               true);
+        }
     } else if (pkt->isWrite()) {
         // we have the block in a writable state and can go ahead,
         // note that the line may be also be considered writable in
@@ -1155,7 +1288,17 @@ BaseCache::satisfyRequest(PacketPtr pkt, CacheBlk *blk, bool, bool)
         assert(blk->isSet(CacheBlk::WritableBit));
         // Write or WriteLine at the first cache with block in writable state
         if (blk->checkWrite(pkt)) {
-            updateBlockData(blk, pkt, true);
+            if (!tagOnly) {
+                updateBlockData(blk, pkt, true);
+            } else {
+                // A tag-only cache only loads the block to probe its
+                // update, and writes the bytes of the packet through
+                if (ppDataUpdate->hasListeners()) {
+                    accessBackingStore(blk, false);
+                    updateBlockData(blk, pkt, true);
+                }
+                writeBackingStore(pkt);
+            }
         }
         // Always mark the line as dirty (and thus transition to the
         // Modified state) even if we are a failed StoreCond so we
@@ -1170,7 +1313,16 @@ BaseCache::satisfyRequest(PacketPtr pkt, CacheBlk *blk, bool, bool)
 
         // all read responses have a data payload
         assert(pkt->hasRespData());
-        pkt->setDataFromBlock(blk->data, blkSize);
+        if (!tagOnly) {
+            pkt->setDataFromBlock(blk->data, blkSize);
+        } else if (pkt->fromCache()) {
+            // the caches above hold no data either
+            pkt->setPlaceholderData();
+        } else {
+            accessBackingStore(pkt->getAddr(), pkt->getSize(),
+                               pkt->isSecure(), pkt->getPtr<uint8_t>(),
+                               false);
+        }
     } else if (pkt->isUpgrade()) {
         // sanity check
         assert(!pkt->hasSharers());
@@ -1380,7 +1532,9 @@ BaseCache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
         // nothing else to do; writeback doesn't expect response
         assert(!pkt->needsResponse());
 
-        updateBlockData(blk, pkt, has_old_data);
+        if (!tagOnly) {
+            updateBlockData(blk, pkt, has_old_data);
+        }
         DPRINTF(Cache, "%s new state is %s\n", __func__, blk->print());
         incHitCount(pkt);
 
@@ -1455,7 +1609,9 @@ BaseCache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
         // nothing else to do; writeback doesn't expect response
         assert(!pkt->needsResponse());
 
-        updateBlockData(blk, pkt, has_old_data);
+        if (!tagOnly) {
+            updateBlockData(blk, pkt, has_old_data);
+        }
         DPRINTF(Cache, "%s new state is %s\n", __func__, blk->print());
 
         incHitCount(pkt);
@@ -1603,7 +1759,7 @@ BaseCache::handleFill(PacketPtr pkt, CacheBlk *blk, PacketList &writebacks,
 
     // if we got new data, copy it in (checking for a read response
     // and a response that has data is the same in the end)
-    if (pkt->isRead()) {
+    if (pkt->isRead() && !tagOnly) {
         // sanity checks
         assert(pkt->hasData());
         assert(pkt->getSize() == blkSize);
@@ -1682,7 +1838,7 @@ BaseCache::invalidateBlock(CacheBlk *blk)
 {
     // If block is still marked as prefetched, then it hasn't been used
     if (blk->wasPrefetched()) {
-        prefetcher->prefetchUnused();
+        prefetcher->prefetchUnused(regenerateBlkAddr(blk), blk->isSecure());
     }
 
     // Notify that the data contents for this address are no longer present
@@ -1716,7 +1872,7 @@ BaseCache::writebackBlk(CacheBlk *blk)
 
     stats.writebacks[Request::wbRequestorId]++;
 
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::create(
         regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
 
     if (blk->isSecure())
@@ -1745,7 +1901,12 @@ BaseCache::writebackBlk(CacheBlk *blk)
     blk->clearCoherenceBits(CacheBlk::DirtyBit);
 
     pkt->allocate();
-    pkt->setDataFromBlock(blk->data, blkSize);
+    if (tagOnly) {
+        // the data was written through already
+        pkt->setPlaceholderData();
+    } else {
+        pkt->setDataFromBlock(blk->data, blkSize);
+    }
 
     // When a block is compressed, it must first be decompressed before being
     // sent for writeback.
@@ -1759,7 +1920,7 @@ BaseCache::writebackBlk(CacheBlk *blk)
 PacketPtr
 BaseCache::writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id)
 {
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::create(
         regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
 
     if (blk->isSecure()) {
@@ -1790,7 +1951,12 @@ BaseCache::writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id)
     blk->clearCoherenceBits(CacheBlk::DirtyBit);
 
     pkt->allocate();
-    pkt->setDataFromBlock(blk->data, blkSize);
+    if (tagOnly) {
+        // the data was written through already
+        pkt->setPlaceholderData();
+    } else {
+        pkt->setDataFromBlock(blk->data, blkSize);
+    }
 
     // When a block is compressed, it must first be decompressed before being
     // sent for writeback.
@@ -1833,7 +1999,7 @@ BaseCache::writebackVisitor(CacheBlk &blk)
     if (blk.isSet(CacheBlk::DirtyBit)) {
         assert(blk.isValid());
 
-        RequestPtr request = std::make_shared<Request>(
+        RequestPtr request = Request::create(
             regenerateBlkAddr(&blk), blkSize, 0, Request::funcRequestorId);
 
         request->taskId(blk.getTaskId());
@@ -2614,6 +2780,17 @@ BaseCache::CpuSidePort::recvFunctional(PacketPtr pkt)
     cache.functionalAccess(pkt, true);
 }
 
+void
+BaseCache::CpuSidePort::recvMemBackdoorReq(const MemBackdoorReq &req,
+                                           MemBackdoorPtr &backdoor)
+{
+    // Only a tag-only cache can let the caches above bypass it, as it
+    // holds no data that memory does not
+    if (cache.tagOnly) {
+        cache.memSidePort.sendMemBackdoorReq(req, backdoor);
+    }
+}
+
 AddrRangeList
 BaseCache::CpuSidePort::getAddrRanges() const
 {
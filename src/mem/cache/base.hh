@@ -48,6 +48,7 @@
 
 #include <cassert>
 #include <cstdint>
+#include <set>
 #include <string>
 
 #include "base/addr_range.hh"
@@ -58,6 +59,7 @@
 #include "debug/Cache.hh"
 #include "debug/CachePort.hh"
 #include "enums/Clusivity.hh"
+#include "mem/backdoor.hh"
 #include "mem/cache/cache_blk.hh"
 #include "mem/cache/cache_probe_arg.hh"
 #include "mem/cache/compressors/base.hh"
@@ -305,6 +307,9 @@ class BaseCache : public ClockedObject
 
         virtual void recvFunctional(PacketPtr pkt) override;
 
+        virtual void recvMemBackdoorReq(const MemBackdoorReq &req,
+                                        MemBackdoorPtr &backdoor) override;
+
         virtual AddrRangeList getAddrRanges() const override;
 
       public:
@@ -341,6 +346,8 @@ class BaseCache : public ClockedObject
         bool coalesce() const override
         { return cache.coalesce(); }
 
+        void prefetchQueued() override;
+
     } accessor;
 
     /** Miss status registers */
@@ -636,6 +643,50 @@ class BaseCache : public ClockedObject
      */
     void cmpAndSwap(CacheBlk *blk, PacketPtr pkt);
 
+    /**
+     * Access the memory below a tag-only cache, which holds the only
+     * copy of the data, through a backdoor if it offers one, and with a
+     * functional access otherwise.
+     *
+     * @param addr The address of the first byte.
+     * @param size The number of bytes.
+     * @param is_secure Whether the bytes are in the secure space.
+     * @param data The buffer to read into or to write from.
+     * @param write Whether to write the bytes instead of reading them.
+     */
+    void accessBackingStore(Addr addr, unsigned size, bool is_secure,
+                            uint8_t *data, bool write);
+
+    /**
+     * Write the bytes of a write packet through a tag-only cache, leaving
+     * the bytes its byte enable mask disables untouched.
+     *
+     * @param pkt The write packet.
+     */
+    void writeBackingStore(PacketPtr pkt);
+
+    /**
+     * Get a backdoor to the memory below a tag-only cache.
+     *
+     * @param range The range the backdoor must cover.
+     * @return A readable and writeable backdoor, or nullptr if none.
+     */
+    MemBackdoorPtr getBackdoor(const AddrRange &range);
+
+    /**
+     * Load the data of a block into the scratch line of a tag-only cache,
+     * or store it back, to let the usual code operate on it.
+     *
+     * @param blk The block.
+     * @param write Whether to store the data instead of loading it.
+     */
+    void
+    accessBackingStore(CacheBlk *blk, bool write)
+    {
+        accessBackingStore(regenerateBlkAddr(blk), blkSize, blk->isSecure(),
+                           blk->data, write);
+    }
+
     /**
      * Return the next queue entry to service, either a pending miss
      * from the MSHR queue, a buffered write from the write buffer, or
@@ -929,6 +980,17 @@ class BaseCache : public ClockedObject
      */
     const bool sequentialAccess;
 
+    /**
+     * Whether the blocks hold no data. Only the timing of the accesses
+     * is modelled then: memory holds the only copy of the data, and
+     * the data of the requestors that are not caches is read from and
+     * written through to it functionally.
+     */
+    const bool tagOnly;
+
+    /** The backdoors to the memory below a tag-only cache. */
+    std::set<MemBackdoorPtr> backdoors;
+
     /** The number of targets for each MSHR. */
     const int numTarget;
 
@@ -390,10 +390,10 @@ Cache::handleTimingReqMiss(PacketPtr pkt, CacheBlk *blk, Tick forward_time,
 
         if (!mshr) {
             // copy the request and create a new SoftPFReq packet
-            RequestPtr req = std::make_shared<Request>(pkt->req->getPaddr(),
-                                                    pkt->req->getSize(),
-                                                    pkt->req->getFlags(),
-                                                    pkt->req->requestorId());
+            RequestPtr req = Request::create(pkt->req->getPaddr(),
+                                             pkt->req->getSize(),
+                                             pkt->req->getFlags(),
+                                             pkt->req->requestorId());
             pf = new Packet(req, pkt->cmd);
             pf->allocate();
             assert(pf->matchAddr(pkt));
@@ -870,7 +870,17 @@ Cache::serviceMSHRTargets(MSHR *mshr, const PacketPtr pkt, CacheBlk *blk)
                         assert(pkt->matchAddr(tgt_pkt));
                         assert(pkt->getSize() >= tgt_pkt->getSize());
 
-                        tgt_pkt->setData(pkt->getConstPtr<uint8_t>());
+                        if (!pkt->hasPlaceholderData()) {
+                            tgt_pkt->setData(pkt->getConstPtr<uint8_t>());
+                        } else if (tgt_pkt->fromCache()) {
+                            tgt_pkt->setPlaceholderData();
+                        } else {
+                            // a tag-only cache below answered, and
+                            // memory has the data
+                            accessBackingStore(tgt_pkt->getAddr(),
+                                tgt_pkt->getSize(), tgt_pkt->isSecure(),
+                                tgt_pkt->getPtr<uint8_t>(), false);
+                        }
                     } else {
                         // MSHR targets can read data either from the
                         // block or the response pkt. If we can't get data
@@ -976,7 +986,7 @@ Cache::cleanEvictBlk(CacheBlk *blk)
     assert(blk && blk->isValid() && !blk->isSet(CacheBlk::DirtyBit));
 
     // Creating a zero sized write, a message to the snoop filter
-    RequestPtr req = std::make_shared<Request>(
+    RequestPtr req = Request::create(
         regenerateBlkAddr(blk), blkSize, 0, Request::wbRequestorId);
 
     if (blk->isSecure())
@@ -1006,6 +1016,9 @@ Cache::doTimingSupplyResponse(PacketPtr req_pkt, const uint8_t *blk_data,
     assert(req_pkt->needsResponse());
 
     DPRINTF(Cache, "%s: for %s\n", __func__, req_pkt->print());
+    // the caches above a tag-only cache hold no data either
+    const bool placeholder = tagOnly && req_pkt->fromCache();
+
     // timing-mode snoop responses require a new packet, unless we
     // already made a copy...
     PacketPtr pkt = req_pkt;
@@ -1019,7 +1032,11 @@ Cache::doTimingSupplyResponse(PacketPtr req_pkt, const uint8_t *blk_data,
            pkt->hasSharers());
     pkt->makeTimingResponse();
     if (pkt->isRead()) {
-        pkt->setDataFromBlock(blk_data, blkSize);
+        if (placeholder) {
+            pkt->setPlaceholderData();
+        } else {
+            pkt->setDataFromBlock(blk_data, blkSize);
+        }
     }
     if (pkt->cmd == MemCmd::ReadResp && pending_inval) {
         // Assume we defer a response to a read from a far-away cache
@@ -1225,14 +1242,25 @@ Cache::handleSnoop(PacketPtr pkt, CacheBlk *blk, bool is_timing,
                  "%s is passing a Modified line through %s, "
                  "but keeping the block", name(), pkt->print());
 
+        // a tag-only cache loads the data of the other requestors
+        const bool placeholder = tagOnly && pkt->fromCache();
+        if (tagOnly && pkt->isRead() && !placeholder) {
+            accessBackingStore(blk, false);
+        }
+
         if (is_timing) {
             doTimingSupplyResponse(pkt, blk->data, is_deferred, pending_inval);
         } else {
             pkt->makeAtomicResponse();
             // packets such as upgrades do not actually have any data
             // payload
-            if (pkt->hasData())
-                pkt->setDataFromBlock(blk->data, blkSize);
+            if (pkt->hasData()) {
+                if (placeholder) {
+                    pkt->setPlaceholderData();
+                } else {
+                    pkt->setDataFromBlock(blk->data, blkSize);
+                }
+            }
         }
 
         // When a block is compressed, it must first be decompressed before
@@ -1351,6 +1379,12 @@ Cache::recvTimingSnoopReq(PacketPtr pkt)
                 pkt->setResponderHadWritable();
             }
 
+            if (tagOnly && pkt->isRead() && !pkt->fromCache()) {
+                accessBackingStore(wb_pkt->getAddr(), blkSize,
+                                   wb_pkt->isSecure(),
+                                   wb_pkt->getPtr<uint8_t>(), false);
+            }
+
             doTimingSupplyResponse(pkt, wb_pkt->getConstPtr<uint8_t>(),
                                    false, false);
         }
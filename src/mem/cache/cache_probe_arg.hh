@@ -68,6 +68,13 @@ struct CacheAccessor
 
     /** Determine if cache is coalescing writes */
     virtual bool coalesce() const = 0;
+
+    /**
+     * Have the cache send the prefetches of its prefetcher when they are
+     * ready, for the prefetches queued outside of the accesses of the
+     * cache
+     */
+    virtual void prefetchQueued() = 0;
 };
 
 /**
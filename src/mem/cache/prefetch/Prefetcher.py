@@ -83,6 +83,12 @@ class BasePrefetcher(ClockedObject):
         "Use virtual addresses for prefetching")
     page_bytes = Param.MemorySize('4KiB',
             "Size of pages for virtual addresses")
+    pollution_filter_entries = Param.Unsigned(4096,
+        "Number of blocks evicted by prefetches tracked to account for "
+        "pollution (0 disables it)")
+    functional_warming = Param.Bool(False,
+        "Train the prefetcher on the accesses of atomic mode, e.g. when "
+        "fast forwarding, without issuing prefetches")
 
     def __init__(self, **kwargs):
         super().__init__(**kwargs)
@@ -121,6 +127,91 @@ class MultiPrefetcher(BasePrefetcher):
 
     prefetchers = VectorParam.BasePrefetcher([], "Array of prefetchers")
 
+    # The prefetchers share the issue bandwidth by weighted round robin:
+    # each one issues up to its number of slots per round, and the slots
+    # can follow the measured accuracy of the prefetchers. Lines recently
+    # issued by one prefetcher are not issued again by another.
+    weights = VectorParam.Unsigned(
+        [], "Issue slots of each prefetcher per round, 1 each if empty"
+    )
+    accuracy_weighting = Param.Bool(
+        False, "Scale the slots of each prefetcher by its accuracy"
+    )
+    accuracy_interval = Param.Unsigned(
+        256, "Prefetches issued between two updates of the accuracies"
+    )
+    accuracy_slots = Param.Unsigned(
+        8, "Slots per unit of weight of a fully accurate prefetcher"
+    )
+    dedup_entries = Param.Unsigned(
+        64,
+        "Number of recently issued lines checked for duplicates "
+        "(0 disables the filter)",
+    )
+
+
+class PerceptronPrefetchFilter(SimObject):
+    type = "PerceptronPrefetchFilter"
+    cxx_class = "gem5::prefetch::PerceptronFilter"
+    cxx_header = "mem/cache/prefetch/perceptron_filter.hh"
+
+    table_entries = Param.Unsigned(
+        1024, "Number of weights of each feature of the candidates"
+    )
+    weight_bits = Param.Unsigned(5, "Number of bits of the weights")
+    threshold = Param.Int(0, "Score a candidate needs to be prefetched")
+    training_margin = Param.Unsigned(
+        16,
+        "Scores this far from the threshold, on the side of the outcome, "
+        "are not trained",
+    )
+    prefetch_table_entries = Param.Unsigned(
+        1024, "Number of issued prefetches waiting for their outcome"
+    )
+    reject_table_entries = Param.Unsigned(
+        1024, "Number of rejected candidates waiting for their outcome"
+    )
+
+
+class PrefetchThrottle(SimObject):
+    type = "PrefetchThrottle"
+    cxx_class = "gem5::prefetch::Throttle"
+    cxx_header = "mem/cache/prefetch/throttle.hh"
+
+    interval = Param.Latency(
+        "10us", "Time between two samples of the feedback"
+    )
+    min_issued = Param.Unsigned(
+        32, "Prefetches a prefetcher must issue in an interval to be judged"
+    )
+    accuracy_high = Param.Percent(
+        75, "Accuracy at or above which a prefetcher is accurate"
+    )
+    accuracy_low = Param.Percent(
+        40, "Accuracy below which a prefetcher is inaccurate"
+    )
+    lateness_threshold = Param.Percent(
+        10, "Percentage of late prefetches at which a prefetcher is late"
+    )
+    pollution_threshold = Param.Percent(
+        5,
+        "Percentage of the demand misses caused by prefetches at which a "
+        "prefetcher pollutes the cache",
+    )
+    read_queue_threshold = Param.Percent(
+        75, "Read buffer occupancy at which a memory is under pressure"
+    )
+    bus_threshold = Param.Percent(
+        70, "Data bus utilization at which a memory is under pressure"
+    )
+    levels = Param.Unsigned(5, "Number of aggressiveness levels")
+    initial_level = Param.Unsigned(
+        3, "Level at which the prefetchers behave as configured"
+    )
+    mem_ctrls = VectorParam.MemCtrl(
+        [], "Memory controllers whose load throttles the prefetchers"
+    )
+
 
 class QueuedPrefetcher(BasePrefetcher):
     type = "QueuedPrefetcher"
@@ -158,6 +249,45 @@ class QueuedPrefetcher(BasePrefetcher):
         that can be throttled depending on the accuracy of the prefetcher.",
     )
 
+    # A filter scores each candidate, and only the candidates it accepts
+    # are queued. It learns from the prefetches that turn out useful or
+    # unused, so aggressive prefetchers need not waste bandwidth.
+    filter = Param.PerceptronPrefetchFilter(
+        NULL, "Filter of the prefetch candidates"
+    )
+
+    # A throttle shared by the prefetchers of the hierarchy adjusts their
+    # aggressiveness from their accuracy, lateness and pollution, and from
+    # the load on the memory, so that they do not fight over bandwidth.
+    # Stride and TDTPrefetcher scale their degree, while the others can
+    # only be made less aggressive, by queueing fewer of their candidates.
+    throttle = Param.PrefetchThrottle(
+        NULL, "Feedback throttle of the prefetcher"
+    )
+
+    # The prefetchers of a hierarchy can be chained: the priority of a
+    # candidate picks the level it fills, fill_thresholds[i] being the
+    # lowest priority filling i levels below this one (the candidates
+    # below the last threshold are dropped), and the accesses seen here
+    # can train the lower prefetcher as hints. Every prefetcher of the
+    # chain but the first must use physical addresses.
+    lower_prefetcher = Param.QueuedPrefetcher(
+        NULL, "Prefetcher of the next cache level"
+    )
+    fill_thresholds = VectorParam.Int(
+        [],
+        "Lowest priority of the candidates filling each level, this one "
+        "first; all candidates fill this level if empty",
+    )
+    forward_hints = Param.Bool(
+        False, "Train the lower prefetcher with the accesses seen here"
+    )
+    # A hinted block is trained on when hinted, not again when the
+    # prefetch of the level above misses in the lower level for it
+    hint_table_entries = Param.Unsigned(
+        64, "Number of hinted blocks remembered, not to retrain on them"
+    )
+
 
 class StridePrefetcherHashedSetAssociative(TaggedSetAssociative):
     type = "StridePrefetcherHashedSetAssociative"
@@ -219,11 +349,95 @@ class StridePrefetcher(QueuedPrefetcher):
             raise TypeError("argument must be of SimObject type")
         self.addEvent(HWPProbeEventRetiredInsts(self, simObj,"RetiredInstsPC"))
 
+class SignaturePathPrefetcher(QueuedPrefetcher):
+    type = "SignaturePathPrefetcher"
+    cxx_class = "gem5::prefetch::SignaturePath"
+    cxx_header = "mem/cache/prefetch/signature_path.hh"
+
+    signature_shift = Param.Unsigned(
+        3, "Number of bits a signature is shifted by before adding a delta"
+    )
+    signature_bits = Param.Unsigned(12, "Number of bits of the signatures")
+    signature_table_entries = Param.MemorySize(
+        "256", "Number of entries of the signature table"
+    )
+    signature_table_assoc = Param.Unsigned(
+        4, "Associativity of the signature table"
+    )
+    signature_table_indexing_policy = Param.TaggedIndexingPolicy(
+        TaggedSetAssociative(
+            entry_size=1,
+            assoc=Parent.signature_table_assoc,
+            size=Parent.signature_table_entries,
+        ),
+        "Indexing policy of the signature table",
+    )
+    signature_table_replacement_policy = Param.BaseReplacementPolicy(
+        LRURP(), "Replacement policy of the signature table"
+    )
+
+    num_counter_bits = Param.UInt8(
+        4, "Number of bits of the occurrence counters of the pattern table"
+    )
+    strides_per_pattern_entry = Param.Unsigned(
+        4, "Number of deltas stored in each pattern table entry"
+    )
+    pattern_table_entries = Param.MemorySize(
+        "512", "Number of entries of the pattern table"
+    )
+    pattern_table_assoc = Param.Unsigned(
+        1, "Associativity of the pattern table"
+    )
+    pattern_table_indexing_policy = Param.TaggedIndexingPolicy(
+        TaggedSetAssociative(
+            entry_size=1,
+            assoc=Parent.pattern_table_assoc,
+            size=Parent.pattern_table_entries,
+        ),
+        "Indexing policy of the pattern table",
+    )
+    pattern_table_replacement_policy = Param.BaseReplacementPolicy(
+        LRURP(), "Replacement policy of the pattern table"
+    )
+
+    prefetch_confidence_threshold = Param.Percent(
+        25, "Path confidence a delta needs to be prefetched"
+    )
+    lookahead_confidence_threshold = Param.Percent(
+        75, "Path confidence the lookahead needs to go one step further"
+    )
+    max_lookahead_depth = Param.Unsigned(
+        8, "Largest number of lookahead steps per access"
+    )
+
+    global_history_register_entries = Param.Unsigned(
+        8, "Number of paths leaving a page remembered for the next page"
+    )
+
 class TDTPrefetcherHashedSetAssociative(TaggedSetAssociative):
     type = 'TDTPrefetcherHashedSetAssociative'
     cxx_class = 'gem5::prefetch::TDTPrefetcherHashedSetAssociative'
     cxx_header = "mem/cache/prefetch/tdt_prefetcher.hh"
 
+class TDTOffsetSet(ScopedEnum):
+    vals = ["smooth", "all", "powers_of_two"]
+
+class TDTDegreeMode(ScopedEnum):
+    vals = ["single", "top_offsets", "multiples"]
+
+class TDTArbiter(ScopedEnum):
+    vals = ["stride_first", "bo_first", "both", "bo_only"]
+
+class TDTPagePolicy(ScopedEnum):
+    vals = ["drop", "clamp", "translate"]
+
+class TDTPrefetcherRRHashedSetAssociative(TaggedSetAssociative):
+    type = 'TDTPrefetcherRRHashedSetAssociative'
+    cxx_class = 'gem5::prefetch::TDTPrefetcherRRHashedSetAssociative'
+    cxx_header = "mem/cache/prefetch/tdt_prefetcher.hh"
+
+    tag_bits = Param.Unsigned(12, "Number of bits of the partial tags")
+
 class TDTPrefetcher(QueuedPrefetcher):
     type = 'TDTPrefetcher'
     cxx_class = 'gem5::prefetch::TDTPrefetcher'
@@ -238,4 +452,341 @@ class TDTPrefetcher(QueuedPrefetcher):
 
     table_replacement_policy = Param.BaseReplacementPolicy(RandomRP(),
         "Replacement policy of the PC table")
+    table_confidence_counter_bits = Param.Unsigned(3,
+        "Number of bits of the stride confidence counters of the PC table")
+    table_initial_confidence = Param.Unsigned(4,
+        "Starting confidence of new PC table entries")
+    table_confidence_threshold = Param.Percent(50,
+        "Confidence a PC stride needs to generate prefetches")
+    stride_degree = Param.Unsigned(1,
+        "Number of prefetches generated by the stride engine per access")
+    confidence_priority = Param.Bool(False,
+        "Give candidates the confidence of their engine, from 0 to 100, as "
+        "their priority, so that fill_thresholds can place them")
+    arbiter = Param.TDTArbiter("bo_only",
+        "Engine whose candidates are issued: bo_only (the BO learner alone, "
+        "as without the stride engine), stride_first (a confident stride, "
+        "else BO), bo_first, or both")
+
+    rr_assoc = Param.Int(1, "Associativity of the Recent Requests table")
+    rr_entries = Param.MemorySize("256",
+        "Number of entries of the Recent Requests table")
+    rr_tag_bits = Param.Unsigned(12,
+        "Number of bits of the partial tags of the Recent Requests table")
+    rr_indexing_policy = Param.TaggedIndexingPolicy(
+        TDTPrefetcherRRHashedSetAssociative(entry_size = 1,
+        assoc = Parent.rr_assoc, size = Parent.rr_entries,
+        tag_bits = Parent.rr_tag_bits),
+        "Indexing policy of the Recent Requests table")
+    rr_replacement_policy = Param.BaseReplacementPolicy(LRURP(),
+        "Replacement policy of the Recent Requests table")
+
+    issued_offset_entries = Param.Unsigned(64,
+        "Number of in-flight prefetches whose offset is remembered until "
+        "their fill")
+
+    bo_score_max = Param.Unsigned(31,
+        "Score that ends a learning phase as soon as an offset reaches it")
+    bo_round_max = Param.Unsigned(20,
+        "Maximum number of rounds over the offset list per learning phase")
+    bo_bad_score = Param.Int(-1,
+        "Prefetching is turned off when the best score of a learning phase "
+        "is not above this value. If negative, it is never turned off: a "
+        "phase in which no offset scores selects offset 0, i.e., the "
+        "accessed line, as the original learner did")
+    bo_max_offset = Param.Unsigned(256,
+        "Largest magnitude of a generated candidate offset, in lines")
+    bo_negative_offsets = Param.Bool(False,
+        "Also generate the negative of every candidate offset")
+    bo_offset_set = Param.TDTOffsetSet("smooth",
+        "Generator of the candidate offsets: smooth (2^i*3^j*5^k), all, "
+        "or powers_of_two")
+    bo_offsets = VectorParam.Int([],
+        "Explicit list of candidate offsets, used instead of the generated "
+        "one when not empty")
+
+    bo_batch_width = Param.Unsigned(1,
+        "Number of candidate offsets tested against the RR table on every "
+        "access")
+
+    bo_page_policy = Param.TDTPagePolicy("drop",
+        "What to do with BO candidates that cross a page when learning on "
+        "physical addresses: drop them, clamp them to the page of the "
+        "access, or translate them through the virtual address of the "
+        "access. Virtual candidates are always translated.")
+
+    bo_degree_mode = Param.TDTDegreeMode("single",
+        "Candidates generated per access: single (D), top_offsets (the best "
+        "scoring offsets of the last phase) or multiples (D, 2D, ...)")
+    bo_max_degree = Param.Unsigned(4,
+        "Largest number of candidates generated per access")
+    bo_adaptive_degree = Param.Bool(False,
+        "Adapt the degree, and suspend prefetching, from the accuracy of "
+        "the issued prefetches")
+    bo_accuracy_window = Param.Unsigned(64,
+        "Number of useful or unused prefetches between two degree updates")
+    bo_high_accuracy = Param.Percent(75,
+        "Accuracy at or above which the degree is increased")
+    bo_low_accuracy = Param.Percent(40,
+        "Accuracy below which the degree is decreased")
+    bo_off_accuracy = Param.Percent(10,
+        "Accuracy below which prefetching is suspended at degree 1")
+
+class SMSPrefetcher(QueuedPrefetcher):
+    type = "SMSPrefetcher"
+    cxx_class = "gem5::prefetch::SMS"
+    cxx_header = "mem/cache/prefetch/sms.hh"
+
+    region_size = Param.MemorySize(
+        "2KiB", "Size of the regions whose footprints are learnt"
+    )
 
+    accumulation_table_entries = Param.MemorySize(
+        "64", "Number of generations in progress that are tracked"
+    )
+    accumulation_table_assoc = Param.Unsigned(
+        16, "Associativity of the accumulation table"
+    )
+    accumulation_table_indexing_policy = Param.TaggedIndexingPolicy(
+        TaggedSetAssociative(
+            entry_size=1,
+            assoc=Parent.accumulation_table_assoc,
+            size=Parent.accumulation_table_entries,
+        ),
+        "Indexing policy of the accumulation table",
+    )
+    accumulation_table_replacement_policy = Param.BaseReplacementPolicy(
+        LRURP(), "Replacement policy of the accumulation table"
+    )
+
+    pattern_history_table_entries = Param.MemorySize(
+        "2048", "Number of footprints remembered"
+    )
+    pattern_history_table_assoc = Param.Unsigned(
+        16, "Associativity of the pattern history table"
+    )
+    pattern_history_table_indexing_policy = Param.TaggedIndexingPolicy(
+        StridePrefetcherHashedSetAssociative(
+            entry_size=1,
+            assoc=Parent.pattern_history_table_assoc,
+            size=Parent.pattern_history_table_entries,
+        ),
+        "Indexing policy of the pattern history table",
+    )
+    pattern_history_table_replacement_policy = Param.BaseReplacementPolicy(
+        LRURP(), "Replacement policy of the pattern history table"
+    )
+
+class TemporalMetadata(ScopedEnum):
+    vals = ["on_chip", "off_chip"]
+
+class TemporalPrefetcher(QueuedPrefetcher):
+    type = "TemporalPrefetcher"
+    cxx_class = "gem5::prefetch::Temporal"
+    cxx_header = "mem/cache/prefetch/temporal.hh"
+
+    degree = Param.Unsigned(2, "Number of successors prefetched per miss")
+
+    pc_table_entries = Param.MemorySize(
+        "256", "Number of PCs whose last miss is tracked"
+    )
+    pc_table_assoc = Param.Unsigned(4, "Associativity of the PC table")
+    pc_table_indexing_policy = Param.TaggedIndexingPolicy(
+        StridePrefetcherHashedSetAssociative(
+            entry_size=1,
+            assoc=Parent.pc_table_assoc,
+            size=Parent.pc_table_entries,
+        ),
+        "Indexing policy of the PC table",
+    )
+    pc_table_replacement_policy = Param.BaseReplacementPolicy(
+        LRURP(), "Replacement policy of the PC table"
+    )
+
+    metadata_location = Param.TemporalMetadata(
+        "on_chip",
+        "Where the successor metadata is kept: on_chip, in the metadata "
+        "table only, or off_chip, in a history buffer in memory fronted by "
+        "the metadata table. Metadata read from memory only serves the "
+        "lookups after it arrives",
+    )
+    metadata_entries = Param.MemorySize(
+        "16384", "Number of entries of the on-chip metadata table"
+    )
+    metadata_assoc = Param.Unsigned(
+        16, "Associativity of the on-chip metadata table"
+    )
+    metadata_indexing_policy = Param.TaggedIndexingPolicy(
+        TaggedSetAssociative(
+            entry_size=1,
+            assoc=Parent.metadata_assoc,
+            size=Parent.metadata_entries,
+        ),
+        "Indexing policy of the on-chip metadata table",
+    )
+    metadata_replacement_policy = Param.BaseReplacementPolicy(
+        LRURP(), "Replacement policy of the on-chip metadata table"
+    )
+    metadata_entry_bytes = Param.Unsigned(
+        4, "Size of a metadata entry, used to account its storage"
+    )
+    confidence_counter_bits = Param.Unsigned(
+        2, "Number of bits of the confidence counter of each successor"
+    )
+    history_buffer_entries = Param.MemorySize(
+        "1048576", "Number of entries of the off-chip history buffer"
+    )
+    metadata_transfer_bytes = Param.Unsigned(
+        64, "Size of a transfer of metadata from or to memory"
+    )
+    metadata_latency = Param.Latency(
+        "60ns", "Latency of a read of metadata from memory"
+    )
+    metadata_bandwidth = Param.MemoryBandwidth(
+        "4GiB/s", "Memory bandwidth available to the metadata transfers"
+    )
+    metadata_read_queue = Param.Unsigned(
+        16, "Number of metadata reads from memory in flight"
+    )
+
+    def carveFromCache(self, cache, ways, block_bytes=64):
+        """
+        Keep the on-chip metadata in the first `ways` ways of `cache`. The
+        data of the cache is restricted to its other ways with a way
+        partitioning policy, and the metadata table is sized to the
+        capacity of the reserved ways. The cache must not have a
+        partitioning manager already, as it is replaced.
+        """
+        from m5.objects.PartitioningPolicies import (
+            PartitionManager,
+            WayPartitioningPolicy,
+            WayPolicyAllocation,
+        )
+
+        assoc = int(cache.assoc)
+        if not 0 < ways < assoc:
+            raise ValueError(
+                f"Cannot reserve {ways} of the {assoc} ways of {cache}"
+            )
+        if cache.partitioning_manager is not NULL:
+            raise ValueError(
+                f"Cannot reserve ways of {cache}, which already has a "
+                "partitioning manager"
+            )
+
+        sets = int(cache.size.value) // (assoc * block_bytes)
+        entries_per_block = block_bytes // int(self.metadata_entry_bytes)
+        self.metadata_entries = ways * sets * entries_per_block
+        self.metadata_assoc = ways * entries_per_block
+
+        # Requests without a partition ID belong to partition 0
+        cache.partitioning_manager = PartitionManager(
+            partitioning_policies=[
+                WayPartitioningPolicy(
+                    allocations=[
+                        WayPolicyAllocation(
+                            partition_id=0, ways=list(range(ways, assoc))
+                        )
+                    ]
+                )
+            ]
+        )
+
+class IndirectMemoryPrefetcher(QueuedPrefetcher):
+    type = "IndirectMemoryPrefetcher"
+    cxx_class = "gem5::prefetch::IndirectMemory"
+    cxx_header = "mem/cache/prefetch/indirect_memory.hh"
+    cxx_exports = [PyBindMethod("addLoadValueProbe")]
+
+    # Index values are added to the virtual base of the indirect array
+    use_virtual_addresses = True
+
+    pt_table_entries = Param.MemorySize(
+        "64", "Number of loads tracked by the prefetch table"
+    )
+    pt_table_assoc = Param.Unsigned(16, "Associativity of the prefetch table")
+    pt_table_indexing_policy = Param.TaggedIndexingPolicy(
+        StridePrefetcherHashedSetAssociative(
+            entry_size=1,
+            assoc=Parent.pt_table_assoc,
+            size=Parent.pt_table_entries,
+        ),
+        "Indexing policy of the prefetch table",
+    )
+    pt_table_replacement_policy = Param.BaseReplacementPolicy(
+        LRURP(), "Replacement policy of the prefetch table"
+    )
+
+    stream_counter_bits = Param.Unsigned(
+        3, "Number of bits of the stride confidence counters"
+    )
+    stream_confidence_threshold = Param.Percent(
+        50, "Stride confidence a load needs to be an index stream"
+    )
+    indirect_counter_bits = Param.Unsigned(
+        2, "Number of bits of the indirect pattern confidence counters"
+    )
+    indirect_initial_confidence = Param.Unsigned(
+        2, "Confidence of a newly learnt indirect pattern"
+    )
+
+    shift_values = VectorParam.Unsigned(
+        [2, 3, 4], "Candidate log2 of the element size of indirect arrays"
+    )
+    index_window = Param.Unsigned(
+        4, "Number of recent index values matched against the misses"
+    )
+    detector_misses = Param.Unsigned(
+        16, "Number of misses the detector waits for a pattern"
+    )
+    index_distance = Param.Unsigned(
+        16, "Number of strides ahead of the index stream that are prefetched"
+    )
+    max_pending_blocks = Param.Unsigned(
+        64, "Largest number of index blocks, predictions and indirect "
+        "prefetches waiting for an event",
+    )
+
+    def __init__(self, **kwargs):
+        super().__init__(**kwargs)
+        self._load_value_sources = []
+
+    def listenLoadValues(self, simObj):
+        """Learn from the values returned to the loads of a core"""
+        if not isinstance(simObj, SimObject):
+            raise TypeError("argument must be of SimObject type")
+        self._load_value_sources.append(simObj)
+
+    def regProbeListeners(self):
+        for simObj in self._load_value_sources:
+            self.getCCObject().addLoadValueProbe(simObj.getCCObject())
+        super().regProbeListeners()
+
+class FetchDirectedPrefetcher(QueuedPrefetcher):
+    type = "FetchDirectedPrefetcher"
+    cxx_class = "gem5::prefetch::FetchDirected"
+    cxx_header = "mem/cache/prefetch/fetch_directed.hh"
+    cxx_exports = [PyBindMethod("addFetchTargetProbe")]
+
+    # The fetch-target queue predicts virtual addresses
+    use_virtual_addresses = True
+
+    max_pending_targets = Param.Unsigned(
+        32, "Largest number of predicted blocks waiting to be queued"
+    )
+
+    def __init__(self, **kwargs):
+        super().__init__(**kwargs)
+        self._fetch_target_sources = []
+
+    def listenFetchTargets(self, simObj):
+        """Prefetch the blocks predicted by the fetch-target queue of a
+        core"""
+        if not isinstance(simObj, SimObject):
+            raise TypeError("argument must be of SimObject type")
+        self._fetch_target_sources.append(simObj)
+
+    def regProbeListeners(self):
+        for simObj in self._fetch_target_sources:
+            self.getCCObject().addFetchTargetProbe(simObj.getCCObject())
+        super().regProbeListeners()
@@ -60,12 +60,16 @@ namespace prefetch
 
 Base::PrefetchInfo::PrefetchInfo(PacketPtr pkt, Addr addr, bool miss)
   : address(addr), pc(pkt->req->hasPC() ? pkt->req->getPC() : 0),
-    requestorId(pkt->req->requestorId()), validPC(pkt->req->hasPC()),
+    requestorId(pkt->req->requestorId()),
+    contextId(pkt->req->hasContextId() ? pkt->req->contextId() :
+              InvalidContextID),
+    validPC(pkt->req->hasPC()),
     secure(pkt->isSecure()), size(pkt->req->getSize()), write(pkt->isWrite()),
     paddress(pkt->req->getPaddr()), cacheMiss(miss)
 {
     unsigned int req_size = pkt->req->getSize();
-    if ((!write && miss) || !pkt->hasData()) {
+    // Tag-only caches send placeholders in place of data
+    if ((!write && miss) || !pkt->hasData() || pkt->hasPlaceholderData()) {
         data = nullptr;
     } else {
         data = new uint8_t[req_size];
@@ -76,16 +80,56 @@ Base::PrefetchInfo::PrefetchInfo(PacketPtr pkt, Addr addr, bool miss)
 
 Base::PrefetchInfo::PrefetchInfo(PrefetchInfo const &pfi, Addr addr)
   : address(addr), pc(pfi.pc), requestorId(pfi.requestorId),
-    validPC(pfi.validPC), secure(pfi.secure), size(pfi.size),
+    contextId(pfi.contextId), validPC(pfi.validPC), secure(pfi.secure),
+    size(pfi.size),
     write(pfi.write), paddress(pfi.paddress), cacheMiss(pfi.cacheMiss),
     data(nullptr)
 {
 }
 
+Base::PrefetchInfo::PrefetchInfo(PrefetchInfo const &pfi, Addr addr,
+                                 Addr paddr, bool miss)
+  : PrefetchInfo(pfi, addr)
+{
+    paddress = paddr;
+    cacheMiss = miss;
+}
+
+Base::PrefetchInfo::PrefetchInfo(CheckpointIn &cp)
+  : data(nullptr)
+{
+    UNSERIALIZE_SCALAR(address);
+    UNSERIALIZE_SCALAR(pc);
+    UNSERIALIZE_SCALAR(requestorId);
+    UNSERIALIZE_SCALAR(contextId);
+    UNSERIALIZE_SCALAR(validPC);
+    UNSERIALIZE_SCALAR(secure);
+    UNSERIALIZE_SCALAR(size);
+    UNSERIALIZE_SCALAR(write);
+    UNSERIALIZE_SCALAR(paddress);
+    UNSERIALIZE_SCALAR(cacheMiss);
+}
+
+void
+Base::PrefetchInfo::serialize(CheckpointOut &cp) const
+{
+    SERIALIZE_SCALAR(address);
+    SERIALIZE_SCALAR(pc);
+    SERIALIZE_SCALAR(requestorId);
+    SERIALIZE_SCALAR(contextId);
+    SERIALIZE_SCALAR(validPC);
+    SERIALIZE_SCALAR(secure);
+    SERIALIZE_SCALAR(size);
+    SERIALIZE_SCALAR(write);
+    SERIALIZE_SCALAR(paddress);
+    SERIALIZE_SCALAR(cacheMiss);
+}
+
 void
 Base::PrefetchListener::notify(const CacheAccessProbeArg &arg)
 {
     if (isFill) {
+        parent.pollutionFill(arg.pkt);
         parent.notifyFill(arg);
     } else {
         parent.probeNotify(arg, miss);
@@ -95,12 +139,16 @@ Base::PrefetchListener::notify(const CacheAccessProbeArg &arg)
 void
 Base::PrefetchEvictListener::notify(const EvictionInfo &info)
 {
-    if (info.newData.empty())
+    if (info.newData.empty()) {
+        parent.lastEvictAddr = info.addr;
+        parent.lastEvictTick = curTick();
         parent.notifyEvict(info);
+    }
 }
 
 Base::Base(const BasePrefetcherParams &p)
     : ClockedObject(p), listeners(), system(nullptr), probeManager(nullptr),
+      parentCache(nullptr),
       blkSize(p.block_size), lBlkSize(floorLog2(blkSize)),
       onMiss(p.on_miss), onRead(p.on_read),
       onWrite(p.on_write), onData(p.on_data), onInst(p.on_inst),
@@ -109,22 +157,45 @@ Base::Base(const BasePrefetcherParams &p)
       prefetchOnAccess(p.prefetch_on_access),
       prefetchOnPfHit(p.prefetch_on_pf_hit),
       useVirtualAddresses(p.use_virtual_addresses),
+      functionalWarming(p.functional_warming), warming(false),
       prefetchStats(this), issuedPrefetches(0),
-      usefulPrefetches(0), mmu(nullptr)
+      usefulPrefetches(0), mmu(nullptr),
+      pollutionFilter(p.pollution_filter_entries, false),
+      lastEvictAddr(0), lastEvictTick(MaxTick)
 {
 }
 
 void
-Base::setParentInfo(System *sys, ProbeManager *pm, unsigned blk_size)
+Base::setParentInfo(System *sys, ProbeManager *pm, CacheAccessor &cache,
+                    unsigned blk_size)
 {
     assert(!system && !probeManager);
     system = sys;
     probeManager = pm;
+    parentCache = &cache;
     // If the cache has a different block size from the system's, save it
     blkSize = blk_size;
     lBlkSize = floorLog2(blkSize);
 }
 
+void
+Base::serialize(CheckpointOut &cp) const
+{
+    // Derived prefetchers checkpoint their learning state in sections of
+    // their own, which must come after the scalars of this one
+    SERIALIZE_SCALAR(issuedPrefetches);
+    SERIALIZE_SCALAR(usefulPrefetches);
+}
+
+void
+Base::unserialize(CheckpointIn &cp)
+{
+    // Checkpoints taken before the prefetchers had any state hold an
+    // empty section for them, which leaves them untrained
+    UNSERIALIZE_OPT_SCALAR(issuedPrefetches);
+    UNSERIALIZE_OPT_SCALAR(usefulPrefetches);
+}
+
 Base::StatGroup::StatGroup(statistics::Group *parent)
   : statistics::Group(parent),
     ADD_STAT(demandMshrMisses, statistics::units::Count::get(),
@@ -149,11 +220,16 @@ Base::StatGroup::StatGroup(statistics::Group *parent)
     ADD_STAT(pfHitInWB, statistics::units::Count::get(),
         "number of prefetches hit in the Write Buffer"),
     ADD_STAT(pfLate, statistics::units::Count::get(),
-        "number of late prefetches (hitting in cache, MSHR or WB)")
+        "number of late prefetches (hitting in cache, MSHR or WB)"),
+    ADD_STAT(pfHitByDemand, statistics::units::Count::get(),
+        "number of demand accesses hitting in the MSHR of a prefetch"),
+    ADD_STAT(pfPollution, statistics::units::Count::get(),
+        "number of demand misses to blocks evicted by prefetches")
 {
     using namespace statistics;
 
     pfUnused.flags(nozero);
+    pfHitByDemand.flags(nozero);
 
     accuracy.flags(total);
     accuracy = pfUseful / pfIssued;
@@ -164,6 +240,29 @@ Base::StatGroup::StatGroup(statistics::Group *parent)
     pfLate = pfHitInCache + pfHitInMSHR + pfHitInWB;
 }
 
+Base::Feedback
+Base::feedback() const
+{
+    Feedback counters;
+    counters.issued = prefetchStats.pfIssued.value();
+    counters.useful = prefetchStats.pfUseful.value();
+    counters.late = prefetchStats.pfHitInCache.value() +
+        prefetchStats.pfHitInMSHR.value() + prefetchStats.pfHitInWB.value();
+    counters.pollution = prefetchStats.pfPollution.value();
+    counters.demandMisses = prefetchStats.demandMshrMisses.value();
+    return counters;
+}
+
+void
+Base::pollutionFill(const PacketPtr &pkt)
+{
+    if (!pollutionFilter.empty() && pkt->cmd == MemCmd::HardPFResp &&
+        lastEvictTick == curTick()) {
+        pollutionBit(lastEvictAddr) = true;
+    }
+    lastEvictTick = MaxTick;
+}
+
 bool
 Base::observeAccess(const PacketPtr &pkt, bool miss, bool prefetched) const
 {
@@ -254,6 +353,17 @@ Base::probeNotify(const CacheAccessProbeArg &acc, bool miss)
             // This case happens when a demand hits on a prefetched line
             // that's not in the requested coherency state.
             prefetchStats.pfUsefulButMiss++;
+        notifyPrefetchUseful(pkt->getAddr(), pkt->isSecure());
+    }
+
+    // A demand miss on a block a prefetch evicted shows pollution
+    if (miss && !has_been_prefetched && !pkt->isWriteback() &&
+        !pollutionFilter.empty()) {
+        auto evicted_by_prefetch = pollutionBit(pkt->getAddr());
+        if (evicted_by_prefetch) {
+            prefetchStats.pfPollution++;
+            evicted_by_prefetch = false;
+        }
     }
 
     // Verify this access type is observed by prefetcher
@@ -268,6 +378,24 @@ Base::probeNotify(const CacheAccessProbeArg &acc, bool miss)
     }
 }
 
+void
+Base::warmAtomic(const CacheAccessProbeArg &acc, bool miss, bool filled)
+{
+    if (!functionalWarming) {
+        return;
+    }
+
+    // In timing mode the access is notified before its fill
+    warming = true;
+    if (miss || prefetchOnAccess) {
+        probeNotify(acc, miss);
+    }
+    if (filled) {
+        notifyFill(acc);
+    }
+    warming = false;
+}
+
 void
 Base::regProbeListeners()
 {
@@ -47,6 +47,7 @@
 #define __MEM_CACHE_PREFETCH_BASE_HH__
 
 #include <cstdint>
+#include <vector>
 
 #include "arch/generic/tlb.hh"
 #include "base/compiler.hh"
@@ -58,6 +59,7 @@
 #include "sim/byteswap.hh"
 #include "sim/clocked_object.hh"
 #include "sim/probe/probe.hh"
+#include "sim/serialize.hh"
 
 namespace gem5
 {
@@ -115,6 +117,8 @@ class Base : public ClockedObject
         Addr pc;
         /** The requestor ID that generated this address. */
         RequestorID requestorId;
+        /** The hardware context that generated this address. */
+        ContextID contextId;
         /** Validity bit for the PC of this address. */
         bool validPC;
         /** Whether this address targets the secure memory space. */
@@ -177,6 +181,16 @@ class Base : public ClockedObject
             return requestorId;
         }
 
+        /**
+         * Gets the hardware context that generated this address
+         * @return the context ID, InvalidContextID if the request that
+         *         generated this address has no context
+         */
+        ContextID getContextId() const
+        {
+            return contextId;
+        }
+
         /**
          * Gets the size of the request triggering this event
          * @return the size in bytes of the request triggering this event
@@ -266,6 +280,27 @@ class Base : public ClockedObject
          */
         PrefetchInfo(PrefetchInfo const &pfi, Addr addr);
 
+        /**
+         * Constructs a PrefetchInfo for another block, using another
+         * PrefetchInfo as a reference for the rest of the access.
+         * @param pfi PrefetchInfo used to generate this new object
+         * @param addr the address value of the new object
+         * @param paddr the physical address of the new object
+         * @param miss whether this event comes from a cache miss
+         */
+        PrefetchInfo(PrefetchInfo const &pfi, Addr addr, Addr paddr,
+                     bool miss);
+
+        /**
+         * Constructs a PrefetchInfo from a checkpoint. The data of the
+         * request is not checkpointed.
+         * @param cp The checkpoint, in the section written by serialize()
+         */
+        PrefetchInfo(CheckpointIn &cp);
+
+        /** Checkpoint the information, except the data of the request */
+        void serialize(CheckpointOut &cp) const;
+
         ~PrefetchInfo()
         {
             delete[] data;
@@ -282,6 +317,9 @@ class Base : public ClockedObject
     /** Pointer to the parent cache's probe manager. */
     ProbeManager *probeManager;
 
+    /** Accessor of the parent cache. */
+    CacheAccessor *parentCache;
+
     /** The block size of the parent cache. */
     unsigned blkSize;
 
@@ -317,6 +355,15 @@ class Base : public ClockedObject
     /** Use Virtual Addresses for prefetching */
     const bool useVirtualAddresses;
 
+    /** Train on the accesses of atomic mode, e.g. when fast forwarding */
+    const bool functionalWarming;
+
+    /**
+     * Whether the access being notified comes from functional warming,
+     * in which case the prefetcher learns from it but issues nothing
+     */
+    bool warming;
+
     /**
      * Determine if this access should be observed
      * @param pkt The memory request causing the event
@@ -366,6 +413,14 @@ class Base : public ClockedObject
         /** The number of times a HW-prefetch is late
          * (hit in cache, MSHR, WB). */
         statistics::Formula pfLate;
+
+        /** The number of times a demand access hits in the MSHR of a
+         * HW-prefetch, which was issued too late to hide the miss. */
+        statistics::Scalar pfHitByDemand;
+
+        /** The number of demand misses to blocks evicted by a
+         * HW-prefetch. */
+        statistics::Scalar pfPollution;
     } prefetchStats;
 
     /** Total prefetches issued */
@@ -376,12 +431,42 @@ class Base : public ClockedObject
     /** Registered mmu for address translations */
     BaseMMU * mmu;
 
+    /**
+     * Blocks evicted to make room for a prefetch, hashed by address, so
+     * that a demand miss on one of them is accounted as pollution.
+     * Empty if pollution is not tracked.
+     */
+    std::vector<bool> pollutionFilter;
+
+    /** Last block evicted from the cache, and when */
+    Addr lastEvictAddr;
+    Tick lastEvictTick;
+
+    /** @return The bit of a block in the pollution filter */
+    std::vector<bool>::reference
+    pollutionBit(Addr addr)
+    {
+        return pollutionFilter[blockIndex(addr) % pollutionFilter.size()];
+    }
+
+    /**
+     * Remember a fill for the pollution filter. The cache evicts the
+     * victim of a fill just before filling the block, so a prefetch
+     * filled in the same tick as the last eviction is the one that
+     * evicted it.
+     * @param pkt The response filling the block
+     */
+    void pollutionFill(const PacketPtr &pkt);
+
   public:
     Base(const BasePrefetcherParams &p);
     virtual ~Base() = default;
 
-    virtual void
-    setParentInfo(System *sys, ProbeManager *pm, unsigned blk_size);
+    virtual void setParentInfo(System *sys, ProbeManager *pm,
+                               CacheAccessor &cache, unsigned blk_size);
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
 
     /**
      * Notify prefetcher of cache access (may be any access or just
@@ -404,12 +489,63 @@ class Base : public ClockedObject
 
     virtual Tick nextPrefetchReadyTime() const = 0;
 
+    /**
+     * Account for a prefetched block evicted before it was used.
+     * @param addr The address of the block
+     * @param is_secure Whether the block belongs to the secure space
+     */
     void
-    prefetchUnused()
+    prefetchUnused(Addr addr, bool is_secure)
     {
         prefetchStats.pfUnused++;
+        notifyPrefetchUnused(addr, is_secure);
     }
 
+    /**
+     * Account for a demand access that found a prefetch of its block in
+     * flight.
+     * @param addr The address of the block
+     * @param is_secure Whether the block belongs to the secure space
+     */
+    void
+    prefetchLate(Addr addr, bool is_secure)
+    {
+        prefetchStats.pfHitByDemand++;
+        notifyPrefetchLate(addr, is_secure);
+    }
+
+    /** Notify prefetcher that a demand access used a block it prefetched */
+    virtual void notifyPrefetchUseful(Addr addr, bool is_secure) {}
+
+    /** Notify prefetcher that a block it prefetched was evicted unused */
+    virtual void notifyPrefetchUnused(Addr addr, bool is_secure) {}
+
+    /** Notify prefetcher that a demand access found its prefetch in flight */
+    virtual void notifyPrefetchLate(Addr addr, bool is_secure) {}
+
+    /** Counters a feedback controller samples to rate the prefetcher */
+    struct Feedback
+    {
+        /** Prefetches issued */
+        uint64_t issued = 0;
+        /** Prefetched blocks used by a demand access */
+        uint64_t useful = 0;
+        /** Prefetches that found their block in the cache, a MSHR or
+         *  the write buffer */
+        uint64_t late = 0;
+        /** Demand misses to blocks evicted by a prefetch */
+        uint64_t pollution = 0;
+        /** Demand misses */
+        uint64_t demandMisses = 0;
+    };
+
+    /**
+     * Sample the counters of the prefetcher. They follow the statistics,
+     * so they restart from zero when the statistics are reset.
+     * @return The counters
+     */
+    Feedback feedback() const;
+
     void
     incrDemandMhsrMisses()
     {
@@ -446,6 +582,17 @@ class Base : public ClockedObject
      */
     void probeNotify(const CacheAccessProbeArg &acc, bool miss);
 
+    /**
+     * Train the prefetcher on an access of atomic mode, if it warms
+     * functionally. The access is notified as the default probe
+     * listeners would see it in timing mode.
+     * @param acc probe arg encapsulating the memory request
+     * @param miss whether the access missed in the cache
+     * @param filled whether the access filled a block of the cache
+     */
+    virtual void warmAtomic(const CacheAccessProbeArg &acc, bool miss,
+                            bool filled);
+
     /**
      * Add a SimObject and a probe name to listen events from
      * @param obj The SimObject pointer to listen from
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/prefetch/fetch_directed.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+#include "params/FetchDirectedPrefetcher.hh"
+
+namespace gem5
+{
+
+namespace prefetch
+{
+
+FetchDirected::FetchDirected(const FetchDirectedPrefetcherParams &p)
+  : Queued(p),
+    maxPendingTargets(p.max_pending_targets),
+    scaledPendingTargets(maxPendingTargets),
+    fdipStats(this)
+{
+    fatal_if(!useVirtualAddresses, "The fetch targets are virtual "
+             "addresses, the FDIP needs use_virtual_addresses.\n");
+    fatal_if(maxPendingTargets == 0,
+             "The FDIP must keep at least one fetch target.\n");
+    pendingTargets.reserve(maxPendingTargets);
+
+    fdipStats.distance.init(1, maxPendingTargets, 1);
+}
+
+FetchDirected::FetchDirectedStats::FetchDirectedStats(
+    statistics::Group *parent)
+  : statistics::Group(parent, "fdip"),
+    ADD_STAT(fetchTargets, statistics::units::Count::get(),
+             "Number of blocks predicted by the fetch-target queue"),
+    ADD_STAT(fetchTargetsDropped, statistics::units::Count::get(),
+             "Number of predicted blocks dropped before they were queued"),
+    ADD_STAT(distance, statistics::units::Count::get(),
+             "Distance to fetch of the queued blocks, in blocks")
+{
+}
+
+void
+FetchDirected::addFetchTargetProbe(SimObject *obj)
+{
+    fetchTargetListeners.emplace_back(new FetchTargetListener(
+        *this, obj->getProbeManager(), "FetchTarget"));
+}
+
+void
+FetchDirected::setAggressiveness(double scale)
+{
+    scaledPendingTargets =
+        std::max(1u, unsigned(std::lround(maxPendingTargets * scale)));
+}
+
+void
+FetchDirected::notifyFetchTarget(const probing::FetchTargetInfo &info)
+{
+    fdipStats.fetchTargets++;
+
+    // The nearest blocks are the most urgent, so keep them
+    if (pendingTargets.size() >= scaledPendingTargets) {
+        fdipStats.fetchTargetsDropped++;
+        return;
+    }
+    pendingTargets.push_back(info);
+}
+
+void
+FetchDirected::calculatePrefetch(const PrefetchInfo &pfi,
+                                 std::vector<AddrPriority> &addresses,
+                                 const CacheAccessor &cache)
+{
+    // Fetch needs the nearest blocks first
+    for (const probing::FetchTargetInfo &target : pendingTargets) {
+        addresses.push_back(AddrPriority(target.addr,
+                                         -int32_t(target.distance)));
+        fdipStats.distance.sample(target.distance);
+    }
+
+    DPRINTF(HWPrefetch, "FDIP: access %#x, %d fetch targets\n",
+            pfi.getAddr(), pendingTargets.size());
+    pendingTargets.clear();
+}
+
+} // namespace prefetch
+} // namespace gem5
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes a Fetch-Directed Instruction Prefetcher (FDIP).
+ *
+ * The prefetcher follows the fetch-target queue of a core, which the
+ * branch predictor runs ahead of fetch through its BTB, and prefetches
+ * the cache blocks of the predicted path before fetch reaches them. The
+ * core provides the blocks through its FetchTarget probe point, and they
+ * are queued with the next instruction access, nearest block first.
+ *
+ * G. Reinman, B. Calder and T. Austin, "Fetch directed instruction
+ * prefetching", MICRO 1999.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_FETCH_DIRECTED_HH__
+#define __MEM_CACHE_PREFETCH_FETCH_DIRECTED_HH__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/cache/prefetch/queued.hh"
+#include "sim/probe/mem.hh"
+
+namespace gem5
+{
+
+struct FetchDirectedPrefetcherParams;
+
+namespace prefetch
+{
+
+class FetchDirected : public Queued
+{
+  protected:
+    /** Largest number of fetch targets waiting to be queued */
+    const unsigned maxPendingTargets;
+
+    /**
+     * Fetch targets kept per access, scaled by the feedback throttle.
+     * They come nearest first, so this bounds the lookahead.
+     */
+    unsigned scaledPendingTargets;
+
+    /** Fetch targets waiting for the next access to be queued */
+    std::vector<probing::FetchTargetInfo> pendingTargets;
+
+    /** Listens to the fetch-target queue of a core */
+    class FetchTargetListener
+        : public ProbeListenerArgBase<probing::FetchTargetInfo>
+    {
+      public:
+        FetchTargetListener(FetchDirected &_parent, ProbeManager *pm,
+                            const std::string &name)
+          : ProbeListenerArgBase(pm, name), parent(_parent)
+        {
+        }
+
+        void
+        notify(const probing::FetchTargetInfo &info) override
+        {
+            parent.notifyFetchTarget(info);
+        }
+
+      protected:
+        FetchDirected &parent;
+    };
+    std::vector<std::unique_ptr<FetchTargetListener>> fetchTargetListeners;
+
+    struct FetchDirectedStats : public statistics::Group
+    {
+        FetchDirectedStats(statistics::Group *parent);
+
+        /** Blocks predicted by the fetch-target queue */
+        statistics::Scalar fetchTargets;
+        /** Blocks dropped as too many were waiting to be queued */
+        statistics::Scalar fetchTargetsDropped;
+        /** Distance to fetch of the queued blocks, in blocks */
+        statistics::Distribution distance;
+    } fdipStats;
+
+  public:
+    FetchDirected(const FetchDirectedPrefetcherParams &p);
+
+    void calculatePrefetch(const PrefetchInfo &pfi,
+                           std::vector<AddrPriority> &addresses,
+                           const CacheAccessor &cache) override;
+
+    void setAggressiveness(double scale) override;
+
+    /**
+     * Take a block the fetch-target queue predicts fetch will go to.
+     * @param info The block and its distance to fetch
+     */
+    void notifyFetchTarget(const probing::FetchTargetInfo &info);
+
+    /**
+     * Listen to the FetchTarget probe point of an object, usually a core.
+     * @param obj The object
+     */
+    void addFetchTargetProbe(SimObject *obj);
+};
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif // __MEM_CACHE_PREFETCH_FETCH_DIRECTED_HH__
@@ -0,0 +1,379 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/prefetch/indirect_memory.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "base/bitfield.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "params/IndirectMemoryPrefetcher.hh"
+#include "sim/byteswap.hh"
+#include "sim/system.hh"
+
+namespace gem5
+{
+
+namespace prefetch
+{
+
+namespace
+{
+
+/** Read a value of a power of 2 size of at most 8 bytes */
+template <typename T>
+uint64_t
+readValue(const uint8_t *data, ByteOrder order)
+{
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return gtoh(value, order);
+}
+
+} // anonymous namespace
+
+IndirectMemory::PrefetchTableEntry::PrefetchTableEntry(
+    const SatCounter8 &init_stream_counter,
+    const SatCounter8 &init_indirect_counter, TagExtractor ext)
+  : TaggedEntry(), streamCounter(init_stream_counter),
+    indirectCounter(init_indirect_counter)
+{
+    registerTagExtractor(ext);
+    invalidate();
+}
+
+void
+IndirectMemory::PrefetchTableEntry::invalidate()
+{
+    TaggedEntry::invalidate();
+    lastAddr = 0;
+    stride = 0;
+    streamCounter.reset();
+    enabled = false;
+    baseAddr = 0;
+    shift = 0;
+    indexSize = 0;
+    indirectCounter.reset();
+    expectedAddr = 0;
+    expectedPending = false;
+}
+
+IndirectMemory::IndirectMemory(const IndirectMemoryPrefetcherParams &p)
+  : Queued(p),
+    streamThreshold(p.stream_confidence_threshold / 100.0),
+    shiftValues(p.shift_values),
+    indexWindow(p.index_window),
+    detectorMisses(p.detector_misses),
+    indexDistance(p.index_distance),
+    scaledIndexDistance(indexDistance),
+    maxPending(p.max_pending_blocks),
+    prefetchTable((name() + ".PrefetchTable").c_str(),
+                  p.pt_table_entries,
+                  p.pt_table_assoc,
+                  p.pt_table_replacement_policy,
+                  p.pt_table_indexing_policy,
+                  PrefetchTableEntry(
+                      SatCounter8(p.stream_counter_bits, 0),
+                      SatCounter8(p.indirect_counter_bits,
+                                  p.indirect_initial_confidence),
+                      genTagExtractor(p.pt_table_indexing_policy))),
+    impStats(this)
+{
+    fatal_if(!useVirtualAddresses, "The indirect addresses are virtual "
+             "addresses, the IMP needs use_virtual_addresses.\n");
+    fatal_if(shiftValues.empty(), "The IMP needs at least one shift.\n");
+    fatal_if(indexWindow == 0, "The IMP index window cannot be empty.\n");
+    fatal_if(maxPending == 0, "The IMP must track at least one block.\n");
+}
+
+IndirectMemory::IndirectMemoryStats::IndirectMemoryStats(
+    statistics::Group *parent)
+  : statistics::Group(parent, "imp"),
+    ADD_STAT(patternsLearnt, statistics::units::Count::get(),
+             "Number of indirect patterns learnt"),
+    ADD_STAT(patternsDropped, statistics::units::Count::get(),
+             "Number of indirect patterns dropped after wrong predictions"),
+    ADD_STAT(detectorTimeouts, statistics::units::Count::get(),
+             "Number of detector allocations that found no pattern"),
+    ADD_STAT(verifiedPredictions, statistics::units::Count::get(),
+             "Number of index values whose predicted block was accessed"),
+    ADD_STAT(pfIndex, statistics::units::Count::get(),
+             "Number of index stream prefetches"),
+    ADD_STAT(pfIndirect, statistics::units::Count::get(),
+             "Number of indirect prefetches")
+{
+}
+
+void
+IndirectMemory::setAggressiveness(double scale)
+{
+    // The index stream is prefetched nearer or further ahead
+    scaledIndexDistance =
+        std::max(1u, unsigned(std::lround(indexDistance * scale)));
+}
+
+void
+IndirectMemory::addLoadValueProbe(SimObject *obj)
+{
+    loadValueListeners.emplace_back(new LoadValueListener(
+        *this, obj->getProbeManager(), "LoadValue"));
+}
+
+void
+IndirectMemory::boundPending(std::unordered_map<Addr, Addr> &pending)
+{
+    // The oldest events are likely stale, but any of them will do
+    if (pending.size() >= maxPending) {
+        pending.erase(pending.begin());
+    }
+}
+
+void
+IndirectMemory::notifyLoadValue(const probing::LoadValueInfo &info)
+{
+    PrefetchTableEntry *entry =
+        prefetchTable.findEntry(PrefetchTableEntry::KeyType{info.pc, false});
+    if (entry == nullptr || !isStreaming(*entry)) {
+        return;
+    }
+    entry->indexSize = info.size;
+
+    if (entry->enabled) {
+        // The previous prediction was never accessed
+        if (entry->expectedPending) {
+            entry->indirectCounter--;
+            if (entry->indirectCounter == 0) {
+                DPRINTF(HWPrefetch, "IMP: dropping pattern of PC %#x\n",
+                        info.pc);
+                entry->enabled = false;
+                entry->expectedPending = false;
+                impStats.patternsDropped++;
+                return;
+            }
+        }
+        entry->expectedAddr =
+            blockAddress(entry->baseAddr + (info.value << entry->shift));
+        entry->expectedPending = true;
+        boundPending(expectedBlocks);
+        expectedBlocks[entry->expectedAddr] = info.pc;
+        return;
+    }
+
+    // Learn the pattern of one load at a time
+    if (!detector.valid) {
+        detector.valid = true;
+        detector.pc = info.pc;
+        detector.values.clear();
+        detector.bases.clear();
+        detector.misses = 0;
+    } else if (detector.pc != info.pc) {
+        return;
+    }
+    detector.values.push_back(info.value);
+    if (detector.values.size() > indexWindow) {
+        detector.values.pop_front();
+    }
+}
+
+void
+IndirectMemory::detectorMiss(Addr addr)
+{
+    for (uint64_t value : detector.values) {
+        for (unsigned shift : shiftValues) {
+            const Addr base = addr - (value << shift);
+            auto [it, inserted] =
+                detector.bases.emplace(std::make_pair(base, shift), value);
+            // Two index values that give the same base for their misses
+            // reveal the pattern
+            if (inserted || it->second == value) {
+                continue;
+            }
+            PrefetchTableEntry *entry = prefetchTable.findEntry(
+                PrefetchTableEntry::KeyType{detector.pc, false});
+            if (entry != nullptr) {
+                DPRINTF(HWPrefetch, "IMP: PC %#x indexes base %#x with "
+                        "shift %d\n", detector.pc, base, shift);
+                entry->enabled = true;
+                entry->baseAddr = base;
+                entry->shift = shift;
+                entry->indirectCounter.reset();
+                entry->expectedPending = false;
+                impStats.patternsLearnt++;
+            }
+            detector.valid = false;
+            return;
+        }
+    }
+
+    if (++detector.misses >= detectorMisses) {
+        detector.valid = false;
+        impStats.detectorTimeouts++;
+    }
+}
+
+void
+IndirectMemory::readIndexBlock(const PrefetchTableEntry &entry,
+                               const uint8_t *data)
+{
+    const ByteOrder order = system->getGuestByteOrder();
+    const unsigned size = entry.indexSize;
+    for (unsigned offset = 0; offset + size <= blkSize; offset += size) {
+        if (pendingIndirect.size() >= maxPending) {
+            break;
+        }
+        uint64_t value;
+        switch (size) {
+          case 1:
+            value = data[offset];
+            break;
+          case 2:
+            value = readValue<uint16_t>(data + offset, order);
+            break;
+          case 4:
+            value = readValue<uint32_t>(data + offset, order);
+            break;
+          case 8:
+            value = readValue<uint64_t>(data + offset, order);
+            break;
+          default:
+            return;
+        }
+        // Indices are signed, as the load value probe reports them
+        value = sext(value, size * 8);
+        pendingIndirect.push_back(
+            blockAddress(entry.baseAddr + (value << entry.shift)));
+    }
+}
+
+void
+IndirectMemory::notifyFill(const CacheAccessProbeArg &acc)
+{
+    const PacketPtr pkt = acc.pkt;
+    // The fills from a tag-only cache carry no index values
+    if (pendingIndexBlocks.empty() || !pkt->hasData() ||
+        pkt->hasPlaceholderData() || pkt->getSize() != blkSize) {
+        return;
+    }
+
+    auto it = pendingIndexBlocks.find(blockAddress(pkt->getAddr()));
+    if (it == pendingIndexBlocks.end()) {
+        return;
+    }
+    const PrefetchTableEntry *entry =
+        prefetchTable.findEntry(PrefetchTableEntry::KeyType{it->second,
+                                                            false});
+    pendingIndexBlocks.erase(it);
+    if (entry != nullptr && entry->enabled) {
+        readIndexBlock(*entry, pkt->getConstPtr<uint8_t>());
+    }
+}
+
+void
+IndirectMemory::calculatePrefetch(const PrefetchInfo &pfi,
+                                  std::vector<AddrPriority> &addresses,
+                                  const CacheAccessor &cache)
+{
+    // Queue the targets of the index blocks that arrived since the last
+    // access, ahead of the index stream
+    for (Addr target : pendingIndirect) {
+        addresses.push_back(AddrPriority(target, 1));
+    }
+    impStats.pfIndirect += pendingIndirect.size();
+    pendingIndirect.clear();
+
+    const Addr addr = pfi.getAddr();
+
+    // Check the predictions of the learnt patterns
+    auto expected = expectedBlocks.find(blockAddress(addr));
+    if (expected != expectedBlocks.end()) {
+        PrefetchTableEntry *entry = prefetchTable.findEntry(
+            PrefetchTableEntry::KeyType{expected->second, false});
+        if (entry != nullptr && entry->expectedPending &&
+            entry->expectedAddr == expected->first) {
+            entry->indirectCounter++;
+            entry->expectedPending = false;
+            impStats.verifiedPredictions++;
+        }
+        expectedBlocks.erase(expected);
+    }
+
+    if (detector.valid && pfi.isCacheMiss()) {
+        detectorMiss(addr);
+    }
+
+    if (!pfi.hasPC()) {
+        return;
+    }
+
+    // Track the stride of the load
+    const PrefetchTableEntry::KeyType key{pfi.getPC(), false};
+    PrefetchTableEntry *entry = prefetchTable.findEntry(key);
+    if (entry == nullptr) {
+        entry = prefetchTable.findVictim(key);
+        prefetchTable.insertEntry(key, entry);
+        entry->lastAddr = addr;
+        return;
+    }
+    prefetchTable.accessEntry(entry);
+
+    const int64_t stride = addr - entry->lastAddr;
+    if (stride == 0) {
+        return;
+    }
+    if (stride == entry->stride) {
+        entry->streamCounter++;
+    } else {
+        entry->streamCounter--;
+        if (!isStreaming(*entry)) {
+            entry->stride = stride;
+        }
+    }
+    entry->lastAddr = addr;
+
+    // Prefetch the index stream ahead, remembering the physical address
+    // of the block to read its indices when it arrives
+    if (entry->enabled && isStreaming(*entry)) {
+        const Addr index_addr = addr + scaledIndexDistance * entry->stride;
+        if (samePage(index_addr, addr)) {
+            addresses.push_back(AddrPriority(blockAddress(index_addr), 0));
+            impStats.pfIndex++;
+            boundPending(pendingIndexBlocks);
+            pendingIndexBlocks[blockAddress(pfi.getPaddr() +
+                                            (index_addr - addr))] =
+                pfi.getPC();
+        }
+    }
+}
+
+} // namespace prefetch
+} // namespace gem5
@@ -0,0 +1,239 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes an Indirect Memory Prefetcher (IMP).
+ *
+ * The prefetcher targets A[B[i]] patterns. It detects the streaming loads
+ * of the index array B, and learns from the values they return, which the
+ * core provides through its LoadValue probe point, the base address and
+ * the element size of the indirectly accessed array A: a miss at address
+ * X following an index value v matches base + (v << shift) = X. Once the
+ * pattern is learnt, the index stream is prefetched a few elements ahead,
+ * and when a prefetched block of indices arrives, the elements of A that
+ * they point to are prefetched too.
+ *
+ * X. Yu, C. J. Hughes, N. Satish and S. Devadas, "IMP: Indirect memory
+ * prefetcher", MICRO 2015.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_INDIRECT_MEMORY_HH__
+#define __MEM_CACHE_PREFETCH_INDIRECT_MEMORY_HH__
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/cache/associative_cache.hh"
+#include "base/sat_counter.hh"
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/cache/prefetch/queued.hh"
+#include "mem/cache/tags/tagged_entry.hh"
+#include "mem/packet.hh"
+#include "sim/probe/mem.hh"
+
+namespace gem5
+{
+
+struct IndirectMemoryPrefetcherParams;
+
+namespace prefetch
+{
+
+class IndirectMemory : public Queued
+{
+  protected:
+    /** Confidence a stride needs for its PC to be an index stream */
+    const double streamThreshold;
+
+    /** Candidate shifts, log2 of the element size of the indirect array */
+    const std::vector<unsigned> shiftValues;
+
+    /** Number of recent index values matched against the misses */
+    const unsigned indexWindow;
+
+    /** Number of misses the detector waits for a match before it gives up */
+    const unsigned detectorMisses;
+
+    /** Number of strides ahead of the index stream that are prefetched */
+    const unsigned indexDistance;
+
+    /** Index distance scaled by the feedback throttle */
+    unsigned scaledIndexDistance;
+
+    /** Largest number of blocks tracked for each kind of pending event */
+    const unsigned maxPending;
+
+    /** A streaming load, and the indirect pattern that depends on it */
+    struct PrefetchTableEntry : public TaggedEntry
+    {
+        PrefetchTableEntry(const SatCounter8 &init_stream_counter,
+                           const SatCounter8 &init_indirect_counter,
+                           TagExtractor ext);
+
+        void invalidate() override;
+
+        /** Last address and stride of the stream */
+        Addr lastAddr;
+        int64_t stride;
+        SatCounter8 streamCounter;
+
+        /** Whether an indirect pattern was learnt */
+        bool enabled;
+        Addr baseAddr;
+        unsigned shift;
+        /** Size of the index values, in bytes */
+        unsigned indexSize;
+        /** Predictions of the pattern that turned out right */
+        SatCounter8 indirectCounter;
+        /** Block the last index value points to, until it is accessed */
+        Addr expectedAddr;
+        bool expectedPending;
+    };
+    AssociativeCache<PrefetchTableEntry> prefetchTable;
+
+    /** Learns the pattern of one streaming load at a time */
+    struct IndirectPatternDetector
+    {
+        bool valid = false;
+        Addr pc = 0;
+        /** Last index values of the load */
+        std::deque<uint64_t> values;
+        /** Base candidates, under their shift, and the value they match */
+        std::map<std::pair<Addr, unsigned>, uint64_t> bases;
+        /** Misses seen since the detector was allocated */
+        unsigned misses = 0;
+    } detector;
+
+    /** Index blocks prefetched, by physical address, and their load PC */
+    std::unordered_map<Addr, Addr> pendingIndexBlocks;
+
+    /** Blocks predicted by an index value, and the PC of its load */
+    std::unordered_map<Addr, Addr> expectedBlocks;
+
+    /** Indirect prefetches waiting for the next access to be queued */
+    std::vector<Addr> pendingIndirect;
+
+    /** Listens to the load values of a core */
+    class LoadValueListener
+        : public ProbeListenerArgBase<probing::LoadValueInfo>
+    {
+      public:
+        LoadValueListener(IndirectMemory &_parent, ProbeManager *pm,
+                          const std::string &name)
+          : ProbeListenerArgBase(pm, name), parent(_parent)
+        {
+        }
+
+        void
+        notify(const probing::LoadValueInfo &info) override
+        {
+            parent.notifyLoadValue(info);
+        }
+
+      protected:
+        IndirectMemory &parent;
+    };
+    std::vector<std::unique_ptr<LoadValueListener>> loadValueListeners;
+
+    struct IndirectMemoryStats : public statistics::Group
+    {
+        IndirectMemoryStats(statistics::Group *parent);
+
+        /** Indirect patterns learnt by the detector */
+        statistics::Scalar patternsLearnt;
+        /** Indirect patterns dropped after too many wrong predictions */
+        statistics::Scalar patternsDropped;
+        /** Detector allocations that ended without a pattern */
+        statistics::Scalar detectorTimeouts;
+        /** Index values whose predicted block was accessed */
+        statistics::Scalar verifiedPredictions;
+        statistics::Scalar pfIndex;
+        statistics::Scalar pfIndirect;
+    } impStats;
+
+    /** @return Whether the stride of an entry is confident enough */
+    bool
+    isStreaming(const PrefetchTableEntry &entry) const
+    {
+        return entry.stride != 0 &&
+            entry.streamCounter.calcSaturation() >= streamThreshold;
+    }
+
+    /** Keep a map of pending blocks within its bound */
+    void boundPending(std::unordered_map<Addr, Addr> &pending);
+
+    /**
+     * Feed a miss to the detector, which learns the pattern of its load
+     * when the miss matches two of its index values with the same base.
+     * @param addr The address of the miss
+     */
+    void detectorMiss(Addr addr);
+
+    /**
+     * Read the index values of a block and prefetch what they point to.
+     * @param entry The entry of the index load
+     * @param data The data of the block
+     */
+    void readIndexBlock(const PrefetchTableEntry &entry,
+                        const uint8_t *data);
+
+  public:
+    IndirectMemory(const IndirectMemoryPrefetcherParams &p);
+
+    void calculatePrefetch(const PrefetchInfo &pfi,
+                           std::vector<AddrPriority> &addresses,
+                           const CacheAccessor &cache) override;
+
+    void notifyFill(const CacheAccessProbeArg &acc) override;
+
+    void setAggressiveness(double scale) override;
+
+    /**
+     * Learn from the value returned to a load.
+     * @param info The load and its value
+     */
+    void notifyLoadValue(const probing::LoadValueInfo &info);
+
+    /**
+     * Listen to the LoadValue probe point of an object, usually a core.
+     * @param obj The object
+     */
+    void addLoadValueProbe(SimObject *obj);
+};
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif // __MEM_CACHE_PREFETCH_INDIRECT_MEMORY_HH__
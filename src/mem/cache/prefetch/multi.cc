@@ -37,6 +37,12 @@
 
 #include "mem/cache/prefetch/multi.hh"
 
+#include <algorithm>
+#include <cmath>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
 #include "params/MultiPrefetcher.hh"
 
 namespace gem5
@@ -48,15 +54,68 @@ namespace prefetch
 Multi::Multi(const MultiPrefetcherParams &p)
   : Base(p),
     prefetchers(p.prefetchers.begin(), p.prefetchers.end()),
-    lastChosenPf(0)
+    lastChosenPf(0),
+    weights(p.weights.empty() ?
+            std::vector<unsigned>(prefetchers.size(), 1) :
+            std::vector<unsigned>(p.weights.begin(), p.weights.end())),
+    accuracyWeighting(p.accuracy_weighting),
+    accuracyInterval(p.accuracy_interval),
+    accuracySlots(p.accuracy_slots),
+    slots(prefetchers.size(), 0),
+    accuracy(prefetchers.size(), 1.0),
+    lastFeedback(prefetchers.size()),
+    issuedSinceUpdate(0),
+    recentLines(p.dedup_entries),
+    statsMulti(this)
+{
+    fatal_if(weights.size() != prefetchers.size(),
+             "%s needs one weight per prefetcher.\n", name());
+    fatal_if(std::find(weights.begin(), weights.end(), 0) != weights.end(),
+             "The weights of %s must be at least 1.\n", name());
+    fatal_if(accuracyWeighting && (accuracyInterval == 0 ||
+                                   accuracySlots == 0),
+             "%s needs an accuracy interval and slots to weight the "
+             "prefetchers by accuracy.\n", name());
+}
+
+Multi::MultiStats::MultiStats(statistics::Group *parent)
+  : statistics::Group(parent, "multi"),
+    ADD_STAT(pfIssuedBy, statistics::units::Count::get(),
+             "number of prefetches issued by each prefetcher"),
+    ADD_STAT(pfDuplicates, statistics::units::Count::get(),
+             "number of prefetches dropped as duplicates of a recent one"),
+    ADD_STAT(rounds, statistics::units::Count::get(),
+             "number of rounds of arbitration")
 {
 }
 
 void
-Multi::setParentInfo(System *sys, ProbeManager *pm, unsigned blk_size)
+Multi::regStats()
+{
+    Base::regStats();
+
+    statsMulti.pfIssuedBy
+        .init(prefetchers.size())
+        .flags(statistics::nozero);
+    for (int pf = 0; pf < prefetchers.size(); pf++) {
+        statsMulti.pfIssuedBy.subname(pf, prefetchers[pf]->name());
+    }
+}
+
+void
+Multi::setParentInfo(System *sys, ProbeManager *pm, CacheAccessor &cache,
+                     unsigned blk_size)
 {
     for (auto pf : prefetchers)
-        pf->setParentInfo(sys, pm, blk_size);
+        pf->setParentInfo(sys, pm, cache, blk_size);
+}
+
+void
+Multi::warmAtomic(const CacheAccessProbeArg &acc, bool miss, bool filled)
+{
+    // Each prefetcher decides whether it warms functionally
+    for (auto pf : prefetchers)
+        pf->warmAtomic(acc, miss, filled);
 }
 
 Tick
@@ -70,21 +129,121 @@ Multi::nextPrefetchReadyTime() const
     return next_ready;
 }
 
+void
+Multi::notifyPrefetchUnused(Addr addr, bool is_secure)
+{
+    for (auto pf : prefetchers)
+        pf->notifyPrefetchUnused(addr, is_secure);
+}
+
+void
+Multi::startRound()
+{
+    statsMulti.rounds++;
+    for (int pf = 0; pf < prefetchers.size(); pf++) {
+        slots[pf] = weights[pf];
+        if (accuracyWeighting) {
+            // Inaccurate prefetchers keep a slot, so that their accuracy
+            // can still be measured
+            slots[pf] = std::max(1L, std::lround(weights[pf] * accuracySlots *
+                                                 accuracy[pf]));
+        }
+    }
+}
+
+void
+Multi::updateAccuracy()
+{
+    for (int pf = 0; pf < prefetchers.size(); pf++) {
+        const Feedback now = prefetchers[pf]->feedback();
+        Feedback &last = lastFeedback[pf];
+
+        // The counters restart when the statistics are reset
+        if (now.issued < last.issued || now.useful < last.useful) {
+            last = Feedback();
+        }
+        const uint64_t issued = now.issued - last.issued;
+        const uint64_t useful = now.useful - last.useful;
+        last = now;
+        if (issued == 0) {
+            continue;
+        }
+
+        // Prefetches issued in an earlier interval may be used in this
+        // one, so the sample is capped
+        const double sample = std::min(1.0, double(useful) / issued);
+        accuracy[pf] = (accuracy[pf] + sample) / 2;
+        DPRINTF(HWPrefetch, "Multi: accuracy of %s is %.2f\n",
+                prefetchers[pf]->name(), accuracy[pf]);
+    }
+}
+
+PacketPtr
+Multi::takePacket(unsigned pf)
+{
+    while (prefetchers[pf]->nextPrefetchReadyTime() <= curTick()) {
+        PacketPtr pkt = prefetchers[pf]->getPacket();
+        panic_if(!pkt, "Prefetcher is ready but didn't return a packet.");
+        if (recentLines.empty()) {
+            return pkt;
+        }
+
+        const Addr blk_addr = blockAddress(pkt->getAddr());
+        IssuedLine &line = recentLines[blockIndex(blk_addr) %
+                                       recentLines.size()];
+        if (line.addr != blk_addr || line.secure != pkt->isSecure()) {
+            line.addr = blk_addr;
+            line.secure = pkt->isSecure();
+            return pkt;
+        }
+
+        DPRINTF(HWPrefetch, "Multi: dropping duplicate prefetch %#x from "
+                "%s\n", blk_addr, prefetchers[pf]->name());
+        statsMulti.pfDuplicates++;
+        delete pkt;
+    }
+    return nullptr;
+}
+
 PacketPtr
 Multi::getPacket()
 {
-    lastChosenPf = (lastChosenPf + 1) % prefetchers.size();
-    uint8_t pf_turn = lastChosenPf;
+    // Weighted round robin: the last chosen prefetcher keeps issuing
+    // until it runs out of slots, then the next ready one takes over
+    for (int round = 0; round < 2; round++) {
+        bool out_of_slots = false;
+        for (int i = 0; i < prefetchers.size(); i++) {
+            const unsigned pf = (lastChosenPf + i) % prefetchers.size();
+            if (prefetchers[pf]->nextPrefetchReadyTime() > curTick()) {
+                continue;
+            }
+            if (slots[pf] == 0) {
+                out_of_slots = true;
+                continue;
+            }
 
-    for (int pf = 0 ;  pf < prefetchers.size(); pf++) {
-        if (prefetchers[pf_turn]->nextPrefetchReadyTime() <= curTick()) {
-            PacketPtr pkt = prefetchers[pf_turn]->getPacket();
-            panic_if(!pkt, "Prefetcher is ready but didn't return a packet.");
+            PacketPtr pkt = takePacket(pf);
+            if (!pkt) {
+                continue;
+            }
+
+            lastChosenPf = pf;
+            slots[pf]--;
+            statsMulti.pfIssuedBy[pf]++;
             prefetchStats.pfIssued++;
             issuedPrefetches++;
+            if (accuracyWeighting && ++issuedSinceUpdate == accuracyInterval) {
+                issuedSinceUpdate = 0;
+                updateAccuracy();
+            }
             return pkt;
         }
-        pf_turn = (pf_turn + 1) % prefetchers.size();
+
+        // Every ready prefetcher used its slots
+        if (!out_of_slots) {
+            break;
+        }
+        startRound();
     }
 
     return nullptr;
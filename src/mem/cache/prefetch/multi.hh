@@ -40,6 +40,8 @@
 
 #include <vector>
 
+#include "base/statistics.hh"
+#include "base/types.hh"
 #include "mem/cache/prefetch/base.hh"
 
 namespace gem5
@@ -56,11 +58,13 @@ class Multi : public Base
     Multi(const MultiPrefetcherParams &p);
 
   public:
-    void
-    setParentInfo(System *sys, ProbeManager *pm, unsigned blk_size) override;
+    void setParentInfo(System *sys, ProbeManager *pm, CacheAccessor &cache,
+                       unsigned blk_size) override;
     PacketPtr getPacket() override;
     Tick nextPrefetchReadyTime() const override;
 
+    void regStats() override;
+
     /** @{ */
     /**
      * Ignore notifications since each sub-prefetcher already gets a
@@ -73,10 +77,87 @@ class Multi : public Base
     void notifyFill(const CacheAccessProbeArg &arg) override {};
     /** @} */
 
+    /** Atomic accesses are not probed, so they are forwarded */
+    void warmAtomic(const CacheAccessProbeArg &acc, bool miss,
+                    bool filled) override;
+
+    /**
+     * The cache only reports unused prefetches to this prefetcher, so
+     * forward them to the sub-prefetchers, which know their own blocks.
+     */
+    void notifyPrefetchUnused(Addr addr, bool is_secure) override;
+
   protected:
     /** List of sub-prefetchers ordered by priority. */
     std::vector<Base*> prefetchers;
     uint8_t lastChosenPf;
+
+    /**
+     * Issue slots of each prefetcher per round of arbitration. A round
+     * ends when every ready prefetcher has used its slots.
+     */
+    const std::vector<unsigned> weights;
+
+    /** Whether the slots of a prefetcher also follow its accuracy */
+    const bool accuracyWeighting;
+
+    /** Prefetches issued between two updates of the accuracies */
+    const unsigned accuracyInterval;
+
+    /** Slots per unit of weight of a fully accurate prefetcher */
+    const unsigned accuracySlots;
+
+    /** Slots left to each prefetcher in the current round */
+    std::vector<unsigned> slots;
+
+    /** Accuracy of each prefetcher, averaged over the intervals */
+    std::vector<double> accuracy;
+
+    /** Counters of each prefetcher at the last update of its accuracy */
+    std::vector<Feedback> lastFeedback;
+
+    /** Prefetches issued since the last update of the accuracies */
+    unsigned issuedSinceUpdate;
+
+    /** A line recently issued by one of the prefetchers */
+    struct IssuedLine
+    {
+        Addr addr = MaxAddr;
+        bool secure = false;
+    };
+
+    /**
+     * Direct-mapped filter of the recently issued lines, shared by the
+     * prefetchers, so that a line generated by several of them is only
+     * issued once. Empty if duplicates are not filtered.
+     */
+    std::vector<IssuedLine> recentLines;
+
+    struct MultiStats : public statistics::Group
+    {
+        MultiStats(statistics::Group *parent);
+
+        /** Prefetches issued by each prefetcher */
+        statistics::Vector pfIssuedBy;
+        /** Prefetches dropped as duplicates of a recent one */
+        statistics::Scalar pfDuplicates;
+        /** Rounds of arbitration */
+        statistics::Scalar rounds;
+    } statsMulti;
+
+    /** Give every prefetcher its slots for a new round */
+    void startRound();
+
+    /** Update the accuracy of every prefetcher from its counters */
+    void updateAccuracy();
+
+    /**
+     * Take the next prefetch of a ready prefetcher, dropping the ones
+     * that duplicate a recently issued line.
+     * @param pf Index of the prefetcher
+     * @return The prefetch, or nullptr if it only had duplicates
+     */
+    PacketPtr takePacket(unsigned pf);
 };
 
 } // namespace prefetch
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/prefetch/perceptron_filter.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+#include "params/PerceptronPrefetchFilter.hh"
+
+namespace gem5
+{
+
+namespace prefetch
+{
+
+PerceptronFilter::PerceptronFilter(const PerceptronPrefetchFilterParams &p)
+  : SimObject(p),
+    tableEntries(p.table_entries),
+    minWeight(-(1 << (p.weight_bits - 1))),
+    maxWeight((1 << (p.weight_bits - 1)) - 1),
+    threshold(p.threshold),
+    trainingMargin(p.training_margin),
+    prefetchTable(p.prefetch_table_entries),
+    rejectTable(p.reject_table_entries),
+    filterStats(this)
+{
+    fatal_if(tableEntries == 0, "The perceptron needs weights.\n");
+    fatal_if(p.weight_bits < 2 || p.weight_bits > 8,
+             "The weights of the perceptron must have 2 to 8 bits.\n");
+    fatal_if(prefetchTable.empty() || rejectTable.empty(),
+             "The prefetch and reject tables cannot be empty.\n");
+    for (auto &table : weights) {
+        table.assign(tableEntries, 0);
+    }
+}
+
+PerceptronFilter::PerceptronFilterStats::PerceptronFilterStats(
+    statistics::Group *parent)
+  : statistics::Group(parent),
+    ADD_STAT(accepted, statistics::units::Count::get(),
+             "Number of candidates accepted"),
+    ADD_STAT(rejected, statistics::units::Count::get(),
+             "Number of candidates rejected"),
+    ADD_STAT(trainedUseful, statistics::units::Count::get(),
+             "Number of trainings on prefetches that were used"),
+    ADD_STAT(trainedUnused, statistics::units::Count::get(),
+             "Number of trainings on prefetches evicted unused"),
+    ADD_STAT(trainedRejected, statistics::units::Count::get(),
+             "Number of trainings on rejected candidates that were "
+             "demanded")
+{
+}
+
+uint64_t
+PerceptronFilter::hash(uint64_t value, unsigned salt)
+{
+    // Fibonacci hashing keeps the high bits, which mix all the input bits
+    value ^= uint64_t(salt) << 59;
+    value *= 0x9e3779b97f4a7c15ULL;
+    return value >> 32;
+}
+
+PerceptronFilter::Features
+PerceptronFilter::score(Addr pc, Addr page, Addr page_offset,
+                        int32_t priority, RequestorID origin,
+                        int64_t delta) const
+{
+    const std::array<uint64_t, NumFeatures> values = {
+        pc, page_offset, page, uint64_t(int64_t(priority)), origin,
+        uint64_t(delta)};
+
+    Features features;
+    for (unsigned f = 0; f < NumFeatures; f++) {
+        features.index[f] = hash(values[f], f) % tableEntries;
+        features.sum += weights[f][features.index[f]];
+    }
+    return features;
+}
+
+bool
+PerceptronFilter::accept(const Features &features, Addr addr, bool is_secure)
+{
+    if (features.sum >= threshold) {
+        filterStats.accepted++;
+        return true;
+    }
+
+    filterStats.rejected++;
+    recordOf(rejectTable, addr) = Record{true, is_secure, addr, features};
+    DPRINTF(HWPrefetch, "Perceptron filter rejects %#x, score %d\n", addr,
+            features.sum);
+    return false;
+}
+
+void
+PerceptronFilter::issued(const Features &features, Addr paddr,
+                         bool is_secure)
+{
+    recordOf(prefetchTable, paddr) = Record{true, is_secure, paddr, features};
+}
+
+const PerceptronFilter::Features *
+PerceptronFilter::take(std::vector<Record> &table, Addr addr, bool is_secure)
+{
+    Record &record = recordOf(table, addr);
+    if (!record.valid || record.addr != addr ||
+        record.isSecure != is_secure) {
+        return nullptr;
+    }
+    record.valid = false;
+    return &record.features;
+}
+
+bool
+PerceptronFilter::train(const Features &features, bool useful)
+{
+    if (useful ? features.sum >= threshold + trainingMargin :
+                 features.sum < threshold - trainingMargin) {
+        return false;
+    }
+
+    const int step = useful ? 1 : -1;
+    for (unsigned f = 0; f < NumFeatures; f++) {
+        int8_t &weight = weights[f][features.index[f]];
+        weight = std::clamp(weight + step, minWeight, maxWeight);
+    }
+    return true;
+}
+
+void
+PerceptronFilter::prefetchUseful(Addr paddr, bool is_secure)
+{
+    const Features *features = take(prefetchTable, paddr, is_secure);
+    if (features != nullptr && train(*features, true)) {
+        filterStats.trainedUseful++;
+    }
+}
+
+void
+PerceptronFilter::prefetchUnused(Addr paddr, bool is_secure)
+{
+    const Features *features = take(prefetchTable, paddr, is_secure);
+    if (features != nullptr && train(*features, false)) {
+        filterStats.trainedUnused++;
+    }
+}
+
+void
+PerceptronFilter::demandMiss(Addr addr, bool is_secure)
+{
+    const Features *features = take(rejectTable, addr, is_secure);
+    if (features != nullptr && train(*features, true)) {
+        filterStats.trainedRejected++;
+    }
+}
+
+} // namespace prefetch
+} // namespace gem5
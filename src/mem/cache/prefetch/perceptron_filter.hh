@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes a perceptron-based prefetch filter.
+ *
+ * The filter scores each candidate of a prefetcher with a hashed
+ * perceptron: every feature of the candidate indexes a table of weights,
+ * and the candidate is prefetched only if the sum of its weights reaches
+ * a threshold. Issued prefetches are remembered in a prefetch table and
+ * rejected candidates in a reject table, so that the weights can be
+ * trained when the outcome is known: a prefetch that is used, or a
+ * rejected candidate that is demanded, trains the weights up, while a
+ * prefetch evicted unused trains them down.
+ *
+ * E. Bhatia, G. Chacon, S. Pugsley, E. Teran, P. V. Gratz and
+ * D. A. Jiménez, "Perceptron-based prefetch filtering", ISCA 2019.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_PERCEPTRON_FILTER_HH__
+#define __MEM_CACHE_PREFETCH_PERCEPTRON_FILTER_HH__
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/request.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+struct PerceptronPrefetchFilterParams;
+
+namespace prefetch
+{
+
+class PerceptronFilter : public SimObject
+{
+  public:
+    /** Features of a candidate, each of which has its table of weights */
+    enum Feature
+    {
+        /** PC of the access that triggered the candidate */
+        PC,
+        /** Block of the candidate within its page */
+        PageOffset,
+        /** Page of the candidate */
+        PageAddr,
+        /** Priority the prefetcher gave to the candidate */
+        Confidence,
+        /** Prefetcher that generated the candidate */
+        Origin,
+        /** Distance from the trigger access to the candidate, in blocks */
+        Delta,
+        NumFeatures
+    };
+
+    /** A scored candidate: the weights of its features, and their sum */
+    struct Features
+    {
+        std::array<uint32_t, NumFeatures> index{};
+        int sum = 0;
+    };
+
+  protected:
+    /** Number of weights of each feature */
+    const unsigned tableEntries;
+
+    /** Range of a weight */
+    const int minWeight;
+    const int maxWeight;
+
+    /** Score a candidate needs to be prefetched */
+    const int threshold;
+
+    /** Scores this far from the threshold, on the right side, are not
+     *  trained, so that the weights do not all saturate */
+    const int trainingMargin;
+
+    std::array<std::vector<int8_t>, NumFeatures> weights;
+
+    /** A candidate waiting for its outcome */
+    struct Record
+    {
+        bool valid = false;
+        bool isSecure = false;
+        Addr addr = 0;
+        Features features;
+    };
+
+    /** Issued prefetches, direct-mapped by physical block address */
+    std::vector<Record> prefetchTable;
+
+    /** Rejected candidates, direct-mapped by block address */
+    std::vector<Record> rejectTable;
+
+    struct PerceptronFilterStats : public statistics::Group
+    {
+        PerceptronFilterStats(statistics::Group *parent);
+
+        statistics::Scalar accepted;
+        statistics::Scalar rejected;
+        /** Issued prefetches that were used */
+        statistics::Scalar trainedUseful;
+        /** Issued prefetches that were evicted unused */
+        statistics::Scalar trainedUnused;
+        /** Rejected candidates that were demanded */
+        statistics::Scalar trainedRejected;
+    } filterStats;
+
+    /** Mix a value, salted so that each table hashes it differently */
+    static uint64_t hash(uint64_t value, unsigned salt);
+
+    /** @return The record of a block in a table */
+    static Record &
+    recordOf(std::vector<Record> &table, Addr addr)
+    {
+        return table[hash(addr, NumFeatures) % table.size()];
+    }
+
+    /**
+     * Find a block in a table, and remove it.
+     * @return The features of the block, nullptr if it is not there
+     */
+    const Features *take(std::vector<Record> &table, Addr addr,
+                         bool is_secure);
+
+    /**
+     * Train the weights of a candidate towards an outcome, unless its
+     * score already agrees by more than the training margin.
+     * @param features The candidate
+     * @param useful Whether prefetching the candidate was right
+     * @return Whether the weights were trained
+     */
+    bool train(const Features &features, bool useful);
+
+  public:
+    PerceptronFilter(const PerceptronPrefetchFilterParams &p);
+
+    /**
+     * Score a candidate.
+     * @param pc PC of the trigger access, 0 if it has none
+     * @param page Page of the candidate
+     * @param page_offset Block of the candidate within its page
+     * @param priority Priority of the candidate
+     * @param origin Requestor ID of the prefetcher of the candidate
+     * @param delta Distance from the trigger access, in blocks
+     * @return The features of the candidate and its score
+     */
+    Features score(Addr pc, Addr page, Addr page_offset, int32_t priority,
+                   RequestorID origin, int64_t delta) const;
+
+    /**
+     * Decide whether a scored candidate is prefetched, and remember it in
+     * the reject table if it is not.
+     * @param features The candidate
+     * @param addr The block address of the candidate
+     * @param is_secure Whether the block belongs to the secure space
+     * @return Whether the candidate is prefetched
+     */
+    bool accept(const Features &features, Addr addr, bool is_secure);
+
+    /** Remember a prefetch when it is issued */
+    void issued(const Features &features, Addr paddr, bool is_secure);
+
+    /** Train on a prefetch used by a demand access */
+    void prefetchUseful(Addr paddr, bool is_secure);
+
+    /** Train on a prefetch evicted before it was used */
+    void prefetchUnused(Addr paddr, bool is_secure);
+
+    /** Train on a demand miss to a candidate that was rejected */
+    void demandMiss(Addr addr, bool is_secure);
+};
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif // __MEM_CACHE_PREFETCH_PERCEPTRON_FILTER_HH__
@@ -0,0 +1,477 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_PREFETCH_QUEUE_HH__
+#define __MEM_CACHE_PREFETCH_PREFETCH_QUEUE_HH__
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "base/logging.hh"
+#include "base/types.hh"
+
+namespace gem5
+{
+
+namespace prefetch
+{
+
+/**
+ * Fixed-capacity queue of deferred packets. Packets live in a pool
+ * allocated once, so they keep their address while their translation is
+ * in flight. They are linked in queue order and indexed by address, so
+ * that duplicate detection, squashes and translation completions do not
+ * scan the queue.
+ *
+ * The order is the one of the std::list the queue replaced, quirks
+ * included, so that prefetchers issue in the same order as before. It
+ * is mostly by decreasing priority and then by age, but a packet of a
+ * higher priority than the last one is inserted before the last packet
+ * of priority at least its own, rather than after it, and a priority
+ * update swaps packets rather than moving them.
+ *
+ * @tparam Packet The packet type. It has an int32_t priority, and a
+ *         pfInfo member providing getAddr() and isSecure().
+ */
+template <class Packet>
+class PrefetchQueue
+{
+  public:
+    /** Position of a packet in the pool */
+    using Index = uint32_t;
+    static constexpr Index Invalid = std::numeric_limits<Index>::max();
+
+    PrefetchQueue(unsigned capacity);
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    bool full() const { return count == slots.size(); }
+
+    /** @return The first packet of the queue, Invalid if empty */
+    Index head() const { return first; }
+
+    /** @return The packet following the given one in the queue */
+    Index next(Index idx) const { return slots[idx].next; }
+
+    Packet &at(Index idx) { return *slots[idx].packet; }
+    const Packet &at(Index idx) const { return *slots[idx].packet; }
+
+    Packet &front() { return at(first); }
+    const Packet &front() const { return at(first); }
+
+    /**
+     * Find a packet by the address of its prefetch.
+     * @param addr Address of the prefetch
+     * @param is_secure Whether the address belongs to the secure space
+     * @return A packet with this address, Invalid if there is none
+     */
+    Index find(Addr addr, bool is_secure) const;
+
+    /**
+     * Look a prefetch up as the list this queue replaced did. The list
+     * was searched in order for the first packet of the same address,
+     * but the search stopped one packet past it, so the packet following
+     * the match is the one that counts as the buffer hit and takes the
+     * priority update.
+     * @param addr Address of the prefetch
+     * @param is_secure Whether the address belongs to the secure space
+     * @param hit The packet following the match, Invalid if none
+     * @return Whether a packet with this address is queued
+     */
+    bool findDuplicate(Addr addr, bool is_secure, Index &hit) const;
+
+    /** @return Another packet with the address of the given one */
+    Index nextSameAddr(Index idx) const { return slots[idx].nextAddr; }
+
+    /** @return The position of a packet of this queue */
+    Index indexOf(const Packet &dp) const;
+
+    /**
+     * @return The first packet of the run of packets at the end of the
+     * queue that have the priority of the last one
+     */
+    Index lowest() const;
+
+    /**
+     * Insert a packet. A packet of at most the priority of the last one
+     * is appended, otherwise it goes before the last packet, scanning
+     * from the end, of at least its priority. The queue must not be full.
+     * @param dp The packet
+     */
+    void push(const Packet &dp);
+
+    /**
+     * Append a packet at the end of the queue, whatever its priority.
+     * Used to rebuild a queue in a known order. The queue must not be
+     * full.
+     * @param dp The packet
+     */
+    void pushBack(const Packet &dp);
+
+    /** Remove a packet, without deleting its memory packet */
+    void erase(Index idx);
+
+    /**
+     * Raise the priority of a packet. Walking towards the head of the
+     * queue, the packet swaps places with every packet of a lower
+     * priority than its own.
+     */
+    void setPriority(Index idx, int32_t priority);
+
+  private:
+    struct Slot
+    {
+        std::optional<Packet> packet;
+        /** Neighbours in queue order */
+        Index prev = Invalid;
+        Index next = Invalid;
+        /** Neighbours in the list of packets of the same address */
+        Index prevAddr = Invalid;
+        Index nextAddr = Invalid;
+    };
+
+    struct AddrKey
+    {
+        Addr addr;
+        bool isSecure;
+
+        bool
+        operator==(const AddrKey &other) const
+        {
+            return addr == other.addr && isSecure == other.isSecure;
+        }
+    };
+
+    struct AddrKeyHash
+    {
+        size_t
+        operator()(const AddrKey &key) const
+        {
+            return std::hash<Addr>()(key.addr ^ key.isSecure);
+        }
+    };
+
+    static AddrKey
+    keyOf(const Packet &dp)
+    {
+        return AddrKey{dp.pfInfo.getAddr(), dp.pfInfo.isSecure()};
+    }
+
+    /** Allocate a slot for a packet, and index it by address */
+    Index allocate(const Packet &dp);
+
+    /**
+     * Link a packet in queue order.
+     * @param idx The packet
+     * @param next The packet to link it before, Invalid for the end
+     */
+    void link(Index idx, Index next);
+
+    /** Unlink a packet from the queue order */
+    void unlink(Index idx);
+
+    /** Exchange the places of two packets in the queue */
+    void swap(Index a, Index b);
+
+    std::vector<Slot> slots;
+    std::vector<Index> freeSlots;
+
+    Index first = Invalid;
+    Index last = Invalid;
+    size_t count = 0;
+
+    /**
+     * Cached result of lowest(), Invalid when it has to be looked up
+     * again. It is kept up to date by the frequent operations, i.e.,
+     * appending and popping packets.
+     */
+    mutable Index lowestRun = Invalid;
+
+    /** First packet of each address */
+    std::unordered_map<AddrKey, Index, AddrKeyHash> addrIndex;
+};
+
+template <class Packet>
+PrefetchQueue<Packet>::PrefetchQueue(unsigned capacity)
+    : slots(capacity)
+{
+    fatal_if(capacity == 0 || capacity >= Invalid,
+             "Invalid prefetch queue size %d.\n", capacity);
+    freeSlots.reserve(capacity);
+    for (Index idx = capacity; idx > 0; idx--) {
+        freeSlots.push_back(idx - 1);
+    }
+    addrIndex.reserve(capacity);
+}
+
+template <class Packet>
+typename PrefetchQueue<Packet>::Index
+PrefetchQueue<Packet>::find(Addr addr, bool is_secure) const
+{
+    auto it = addrIndex.find(AddrKey{addr, is_secure});
+    return it == addrIndex.end() ? Invalid : it->second;
+}
+
+template <class Packet>
+bool
+PrefetchQueue<Packet>::findDuplicate(Addr addr, bool is_secure,
+                                     Index &hit) const
+{
+    Index match = find(addr, is_secure);
+    if (match == Invalid) {
+        hit = Invalid;
+        return false;
+    }
+
+    // The packets of an address are not kept in queue order, so the
+    // first one in the queue is only known for sure if it is alone
+    if (nextSameAddr(match) != Invalid) {
+        const AddrKey key{addr, is_secure};
+        match = first;
+        while (!(keyOf(at(match)) == key)) {
+            match = next(match);
+        }
+    }
+
+    hit = next(match);
+    return true;
+}
+
+template <class Packet>
+typename PrefetchQueue<Packet>::Index
+PrefetchQueue<Packet>::indexOf(const Packet &dp) const
+{
+    const AddrKey key = keyOf(dp);
+    for (Index idx = find(key.addr, key.isSecure); idx != Invalid;
+         idx = slots[idx].nextAddr) {
+        if (&*slots[idx].packet == &dp) {
+            return idx;
+        }
+    }
+    return Invalid;
+}
+
+template <class Packet>
+typename PrefetchQueue<Packet>::Index
+PrefetchQueue<Packet>::lowest() const
+{
+    assert(!empty());
+    if (lowestRun == Invalid) {
+        const int32_t priority = at(last).priority;
+        lowestRun = last;
+        while (lowestRun != first &&
+               at(slots[lowestRun].prev).priority == priority) {
+            lowestRun = slots[lowestRun].prev;
+        }
+    }
+    return lowestRun;
+}
+
+template <class Packet>
+typename PrefetchQueue<Packet>::Index
+PrefetchQueue<Packet>::allocate(const Packet &dp)
+{
+    assert(!full());
+    const Index idx = freeSlots.back();
+    freeSlots.pop_back();
+    count++;
+
+    Slot &slot = slots[idx];
+    slot.packet.emplace(dp);
+
+    // Packets of the same address are not kept in queue order, the head
+    // of their list is the one found first
+    auto [it, inserted] = addrIndex.try_emplace(keyOf(dp), idx);
+    slot.prevAddr = Invalid;
+    slot.nextAddr = inserted ? Invalid : it->second;
+    if (!inserted) {
+        slots[it->second].prevAddr = idx;
+        it->second = idx;
+    }
+    return idx;
+}
+
+template <class Packet>
+void
+PrefetchQueue<Packet>::link(Index idx, Index next)
+{
+    Slot &slot = slots[idx];
+    Index prev = (next == Invalid) ? last : slots[next].prev;
+    slot.prev = prev;
+    slot.next = next;
+    if (prev == Invalid) {
+        first = idx;
+    } else {
+        slots[prev].next = idx;
+    }
+    if (next == Invalid) {
+        last = idx;
+    } else {
+        slots[next].prev = idx;
+    }
+}
+
+template <class Packet>
+void
+PrefetchQueue<Packet>::unlink(Index idx)
+{
+    Slot &slot = slots[idx];
+    if (slot.prev == Invalid) {
+        first = slot.next;
+    } else {
+        slots[slot.prev].next = slot.next;
+    }
+    if (slot.next == Invalid) {
+        last = slot.prev;
+    } else {
+        slots[slot.next].prev = slot.prev;
+    }
+    slot.prev = slot.next = Invalid;
+}
+
+template <class Packet>
+void
+PrefetchQueue<Packet>::swap(Index a, Index b)
+{
+    const Index a_next = slots[a].next;
+    const Index b_next = slots[b].next;
+    if (a_next == b) {
+        unlink(b);
+        link(b, a);
+    } else if (b_next == a) {
+        unlink(a);
+        link(a, b);
+    } else {
+        unlink(a);
+        unlink(b);
+        link(a, b_next);
+        link(b, a_next);
+    }
+}
+
+template <class Packet>
+void
+PrefetchQueue<Packet>::push(const Packet &dp)
+{
+    if (empty() || dp.priority <= at(last).priority) {
+        pushBack(dp);
+        return;
+    }
+
+    // Insertions before the last packet leave the run of lowest priority
+    // packets at the end of the queue as is
+    Index next = last;
+    while (next != first && dp.priority > at(next).priority) {
+        next = slots[next].prev;
+    }
+    if (next == first && dp.priority <= at(first).priority) {
+        next = slots[first].next;
+    }
+    link(allocate(dp), next);
+}
+
+template <class Packet>
+void
+PrefetchQueue<Packet>::pushBack(const Packet &dp)
+{
+    const bool same_run = !empty() && dp.priority == at(last).priority;
+    const Index idx = allocate(dp);
+    link(idx, Invalid);
+    if (!same_run) {
+        lowestRun = idx;
+    }
+}
+
+template <class Packet>
+void
+PrefetchQueue<Packet>::erase(Index idx)
+{
+    Slot &slot = slots[idx];
+    assert(slot.packet);
+
+    // Removing a packet right before the run of lowest priority packets
+    // may join it to the packets before
+    if (idx == lowestRun) {
+        lowestRun = slot.next;
+    } else if (slot.next == lowestRun) {
+        lowestRun = Invalid;
+    }
+    unlink(idx);
+
+    if (slot.prevAddr == Invalid) {
+        auto it = addrIndex.find(keyOf(*slot.packet));
+        assert(it != addrIndex.end() && it->second == idx);
+        if (slot.nextAddr == Invalid) {
+            addrIndex.erase(it);
+        } else {
+            it->second = slot.nextAddr;
+        }
+    } else {
+        slots[slot.prevAddr].nextAddr = slot.nextAddr;
+    }
+    if (slot.nextAddr != Invalid) {
+        slots[slot.nextAddr].prevAddr = slot.prevAddr;
+    }
+    slot.prevAddr = slot.nextAddr = Invalid;
+
+    slot.packet.reset();
+    freeSlots.push_back(idx);
+    count--;
+}
+
+template <class Packet>
+void
+PrefetchQueue<Packet>::setPriority(Index idx, int32_t priority)
+{
+    slots[idx].packet->priority = priority;
+    lowestRun = Invalid;
+
+    // The packet is compared with each packet before the place it was
+    // in, in turn, and swapped with the lower priority ones
+    Index pos = idx;
+    while (pos != first) {
+        const Index prev = slots[pos].prev;
+        if (priority > at(prev).priority) {
+            swap(idx, prev);
+            pos = idx;
+        } else {
+            pos = prev;
+        }
+    }
+}
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif // __MEM_CACHE_PREFETCH_PREFETCH_QUEUE_HH__
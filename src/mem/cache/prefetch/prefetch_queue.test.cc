@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <list>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "mem/cache/prefetch/prefetch_queue.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+struct FakeInfo
+{
+    Addr addr;
+    bool secure;
+
+    Addr getAddr() const { return addr; }
+    bool isSecure() const { return secure; }
+
+    bool
+    sameAddr(const FakeInfo &other) const
+    {
+        return addr == other.addr && secure == other.secure;
+    }
+};
+
+struct FakePacket
+{
+    FakeInfo pfInfo;
+    int32_t priority;
+    /** Identifies the packet when comparing queues */
+    unsigned id;
+
+    bool operator>(const FakePacket &that) const
+    {
+        return priority > that.priority;
+    }
+    bool operator<=(const FakePacket &that) const { return !(*this > that); }
+};
+
+using Queue = prefetch::PrefetchQueue<FakePacket>;
+
+/**
+ * The std::list based queue the indexed queue replaced, as
+ * Queued::addToQueue and Queued::alreadyInQueue implemented it.
+ */
+class ListQueue
+{
+  public:
+    ListQueue(unsigned capacity) : capacity(capacity) {}
+
+    void
+    add(const FakePacket &dpp)
+    {
+        if (queue.size() == capacity) {
+            auto it = queue.end();
+            --it;
+            auto prev = it;
+            bool cont = true;
+            while (cont && prev != queue.begin()) {
+                prev--;
+                cont = prev->priority == it->priority;
+                if (cont)
+                    it = prev;
+            }
+            queue.erase(it);
+        }
+
+        if ((queue.size() == 0) || (dpp <= queue.back())) {
+            queue.emplace_back(dpp);
+        } else {
+            auto it = queue.end();
+            do {
+                --it;
+            } while (it != queue.begin() && dpp > *it);
+            if (it == queue.begin() && dpp <= *it)
+                it++;
+            queue.insert(it, dpp);
+        }
+    }
+
+    /** @return Whether the address was found, and the buffer hits */
+    std::pair<bool, unsigned>
+    alreadyIn(const FakeInfo &pfi, int32_t priority)
+    {
+        bool found = false;
+        unsigned hits = 0;
+        auto it = queue.begin();
+        for (; it != queue.end() && !found; it++) {
+            found = it->pfInfo.sameAddr(pfi);
+        }
+
+        if (it != queue.end()) {
+            hits++;
+            if (it->priority < priority) {
+                it->priority = priority;
+                auto prev = it;
+                while (prev != queue.begin()) {
+                    prev--;
+                    if (*it > *prev) {
+                        std::swap(*it, *prev);
+                        it = prev;
+                    }
+                }
+            }
+        }
+        return {found, hits};
+    }
+
+    void pop() { queue.pop_front(); }
+
+    void
+    squash(const FakeInfo &pfi)
+    {
+        queue.remove_if([&pfi](const FakePacket &dp)
+                        { return dp.pfInfo.sameAddr(pfi); });
+    }
+
+    bool empty() const { return queue.empty(); }
+
+    std::vector<std::pair<unsigned, int32_t>>
+    contents() const
+    {
+        std::vector<std::pair<unsigned, int32_t>> ids;
+        for (const auto &dp : queue) {
+            ids.emplace_back(dp.id, dp.priority);
+        }
+        return ids;
+    }
+
+  private:
+    const unsigned capacity;
+    std::list<FakePacket> queue;
+};
+
+/** The same operations on the indexed queue, as Queued does them. */
+void
+add(Queue &queue, const FakePacket &dpp)
+{
+    if (queue.full()) {
+        queue.erase(queue.lowest());
+    }
+    queue.push(dpp);
+}
+
+std::pair<bool, unsigned>
+alreadyIn(Queue &queue, const FakeInfo &pfi, int32_t priority)
+{
+    Queue::Index idx;
+    const bool found = queue.findDuplicate(pfi.addr, pfi.secure, idx);
+    unsigned hits = 0;
+    if (idx != Queue::Invalid) {
+        hits++;
+        if (queue.at(idx).priority < priority) {
+            queue.setPriority(idx, priority);
+        }
+    }
+    return {found, hits};
+}
+
+void
+squash(Queue &queue, const FakeInfo &pfi)
+{
+    auto idx = queue.find(pfi.addr, pfi.secure);
+    while (idx != Queue::Invalid) {
+        auto next = queue.nextSameAddr(idx);
+        queue.erase(idx);
+        idx = next;
+    }
+}
+
+std::vector<std::pair<unsigned, int32_t>>
+contents(const Queue &queue)
+{
+    std::vector<std::pair<unsigned, int32_t>> ids;
+    for (auto idx = queue.head(); idx != Queue::Invalid;
+         idx = queue.next(idx)) {
+        ids.emplace_back(queue.at(idx).id, queue.at(idx).priority);
+    }
+    return ids;
+}
+
+/**
+ * Run the same random operations on both queues and compare them after
+ * each one.
+ * @param filter Whether packets already queued are filtered, as with
+ *        queue_filter, or queued again
+ */
+void
+compareWithList(bool filter, unsigned seed)
+{
+    const unsigned capacity = 8;
+    Queue queue(capacity);
+    ListQueue reference(capacity);
+    std::mt19937 rng(seed);
+
+    for (unsigned id = 0; id < 20000; id++) {
+        const FakeInfo pfi{(rng() % 16) * 64, rng() % 4 == 0};
+        const int32_t priority = rng() % 4;
+
+        const unsigned op = rng() % 8;
+        if (op < 2 && !reference.empty()) {
+            reference.pop();
+            queue.erase(queue.head());
+        } else if (op == 2) {
+            reference.squash(pfi);
+            squash(queue, pfi);
+        } else if (filter) {
+            const auto expected = reference.alreadyIn(pfi, priority);
+            ASSERT_EQ(alreadyIn(queue, pfi, priority), expected);
+            if (!expected.first) {
+                reference.add(FakePacket{pfi, priority, id});
+                add(queue, FakePacket{pfi, priority, id});
+            }
+        } else {
+            ASSERT_EQ(alreadyIn(queue, pfi, priority),
+                      reference.alreadyIn(pfi, priority));
+            reference.add(FakePacket{pfi, priority, id});
+            add(queue, FakePacket{pfi, priority, id});
+        }
+
+        ASSERT_EQ(contents(queue), reference.contents());
+    }
+}
+
+} // anonymous namespace
+
+/**
+ * Packets are mostly ordered by decreasing priority, then by age, with
+ * the insertion quirks of the list.
+ */
+TEST(PrefetchQueueTest, PushOrder)
+{
+    Queue queue(8);
+    const int32_t priorities[] = {1, 3, 1, 2, 3, 0};
+    for (unsigned id = 0; id < 6; id++) {
+        queue.push(FakePacket{{id * 64, false}, priorities[id], id});
+    }
+
+    std::vector<std::pair<unsigned, int32_t>> expected = {
+        {1, 3}, {4, 3}, {3, 2}, {0, 1}, {2, 1}, {5, 0}};
+    ASSERT_EQ(contents(queue), expected);
+    ASSERT_EQ(queue.at(queue.lowest()).id, 5);
+
+    // A packet above the last priority goes before the last packet of
+    // at least its priority, here before an older one of its priority
+    queue.push(FakePacket{{6 * 64, false}, 2, 6});
+    expected = {{1, 3}, {4, 3}, {6, 2}, {3, 2}, {0, 1}, {2, 1}, {5, 0}};
+    ASSERT_EQ(contents(queue), expected);
+
+    queue.erase(queue.head());
+    queue.erase(queue.lowest());
+    ASSERT_EQ(queue.front().id, 4);
+    ASSERT_EQ(queue.at(queue.lowest()).id, 0);
+}
+
+/** Higher priorities can even be inserted after lower ones. */
+TEST(PrefetchQueueTest, PushBeforeHigherPriority)
+{
+    Queue queue(8);
+    queue.push(FakePacket{{0, false}, 3, 0});
+    queue.push(FakePacket{{64, false}, 3, 1});
+    queue.push(FakePacket{{128, false}, 1, 2});
+    queue.push(FakePacket{{192, false}, 2, 3});
+
+    const std::vector<std::pair<unsigned, int32_t>> expected = {
+        {0, 3}, {3, 2}, {1, 3}, {2, 1}};
+    ASSERT_EQ(contents(queue), expected);
+}
+
+/**
+ * As with the list, a duplicate counts as a hit on, and raises the
+ * priority of, the packet following the match.
+ */
+TEST(PrefetchQueueTest, DuplicateUpdatesNextPacket)
+{
+    Queue queue(8);
+    for (unsigned id = 0; id < 3; id++) {
+        queue.push(FakePacket{{id * 64, false}, 0, id});
+    }
+
+    ASSERT_EQ(alreadyIn(queue, {0, false}, 1), std::make_pair(true, 1u));
+    const std::vector<std::pair<unsigned, int32_t>> expected = {
+        {1, 1}, {0, 0}, {2, 0}};
+    ASSERT_EQ(contents(queue), expected);
+
+    // A match at the end of the queue is found, without any hit
+    ASSERT_EQ(alreadyIn(queue, {128, false}, 2), std::make_pair(true, 0u));
+    ASSERT_EQ(contents(queue), expected);
+
+    // Secure and non-secure addresses are distinct
+    ASSERT_EQ(alreadyIn(queue, {0, true}, 2), std::make_pair(false, 0u));
+}
+
+/** Random operations give the same queue as the list, filtering. */
+TEST(PrefetchQueueTest, MatchesListFiltered)
+{
+    for (unsigned seed = 0; seed < 4; seed++) {
+        compareWithList(true, seed);
+    }
+}
+
+/** Random operations give the same queue as the list, with duplicates. */
+TEST(PrefetchQueueTest, MatchesListUnfiltered)
+{
+    for (unsigned seed = 0; seed < 4; seed++) {
+        compareWithList(false, seed);
+    }
+}
@@ -37,7 +37,9 @@
 
 #include "mem/cache/prefetch/queued.hh"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 #include "arch/generic/tlb.hh"
 #include "base/logging.hh"
@@ -45,6 +47,7 @@
 #include "debug/HWPrefetch.hh"
 #include "debug/HWPrefetchQueue.hh"
 #include "mem/cache/base.hh"
+#include "mem/cache/prefetch/throttle.hh"
 #include "mem/request.hh"
 #include "params/QueuedPrefetcher.hh"
 
@@ -60,8 +63,7 @@ Queued::DeferredPacket::createPkt(Addr paddr, unsigned blk_size,
                                             bool tag_prefetch,
                                             Tick t) {
     /* Create a prefetch memory request */
-    RequestPtr req = std::make_shared<Request>(paddr, blk_size,
-                                                0, requestor_id);
+    RequestPtr req = Request::create(paddr, blk_size, 0, requestor_id);
 
     if (pfInfo.isSecure()) {
         req->setFlags(Request::SECURE);
@@ -98,26 +100,107 @@ Queued::DeferredPacket::finish(const Fault &fault,
 }
 
 Queued::Queued(const QueuedPrefetcherParams &p)
-    : Base(p), queueSize(p.queue_size),
+    : Base(p), pfq(p.queue_size), pfqMissingTranslation(p.queue_size),
+      queueSize(p.queue_size),
       missingTranslationQueueSize(
         p.max_prefetch_requests_with_pending_translation),
       latency(p.latency), queueSquash(p.queue_squash),
       queueFilter(p.queue_filter), cacheSnoop(p.cache_snoop),
       tagPrefetch(p.tag_prefetch),
-      throttleControlPct(p.throttle_control_percentage), statsQueued(this)
+      throttleControlPct(p.throttle_control_percentage), filter(p.filter),
+      aggressiveness(1.0), lowerPrefetcher(p.lower_prefetcher),
+      fillThresholds(p.fill_thresholds.begin(), p.fill_thresholds.end()),
+      forwardHints(p.forward_hints),
+      hintedBlocks(p.hint_table_entries, MaxAddr), statsQueued(this)
 {
+    if (p.throttle) {
+        p.throttle->registerPrefetcher(this);
+    }
+
+    fatal_if(fillThresholds.size() > 1 && !lowerPrefetcher,
+             "%s fills candidates at lower levels, it needs the prefetcher "
+             "of the next level.\n", name());
+    fatal_if(!std::is_sorted(fillThresholds.rbegin(), fillThresholds.rend()),
+             "The fill thresholds of %s must decrease with the level.\n",
+             name());
+    fatal_if(forwardHints && !lowerPrefetcher,
+             "%s forwards hints, it needs the prefetcher of the next "
+             "level.\n", name());
+    fatal_if(lowerPrefetcher && lowerPrefetcher->useVirtualAddresses,
+             "Candidates are forwarded by physical address, the prefetcher "
+             "of the level below %s cannot use virtual addresses.\n",
+             name());
 }
 
 Queued::~Queued()
 {
     // Delete the queued prefetch packets
-    for (DeferredPacket &p : pfq) {
-        delete p.pkt;
+    for (auto idx = pfq.head(); idx != DeferredQueue::Invalid;
+         idx = pfq.next(idx)) {
+        delete pfq.at(idx).pkt;
+    }
+}
+
+void
+Queued::serialize(CheckpointOut &cp) const
+{
+    Base::serialize(cp);
+
+    // Prefetches waiting for their translation are not checkpointed, as
+    // the translation would have to be restarted
+    Serializable::ScopedCheckpointSection sec(cp, "pfq");
+    size_t num_pfs = pfq.size();
+    SERIALIZE_SCALAR(num_pfs);
+    size_t pos = 0;
+    for (auto idx = pfq.head(); idx != DeferredQueue::Invalid;
+         idx = pfq.next(idx)) {
+        const DeferredPacket &dp = pfq.at(idx);
+        Serializable::ScopedCheckpointSection entry_sec(
+            cp, csprintf("entry%d", pos++));
+        dp.pfInfo.serialize(cp);
+        paramOut(cp, "paddr", dp.pkt->getAddr());
+        paramOut(cp, "priority", dp.priority);
+        paramOut(cp, "tick", dp.tick);
+    }
+}
+
+void
+Queued::unserialize(CheckpointIn &cp)
+{
+    Base::unserialize(cp);
+
+    if (!cp.sectionExists(Serializable::currentSection() + ".pfq"))
+        return;
+
+    // The queue is rebuilt in the order it was saved in
+    Serializable::ScopedCheckpointSection sec(cp, "pfq");
+    size_t num_pfs;
+    UNSERIALIZE_SCALAR(num_pfs);
+    if (num_pfs > 0 && !parentCache) {
+        warn("%s is not attached to a cache, dropping the %d prefetches "
+             "of its checkpointed queue.\n", name(), num_pfs);
+        return;
+    }
+    for (size_t pos = 0; pos < num_pfs && !pfq.full();
+         pos++) {
+        Serializable::ScopedCheckpointSection entry_sec(
+            cp, csprintf("entry%d", pos));
+        Addr paddr;
+        int32_t priority;
+        Tick tick;
+        paramIn(cp, "paddr", paddr);
+        paramIn(cp, "priority", priority);
+        paramIn(cp, "tick", tick);
+
+        DeferredPacket dpp(this, PrefetchInfo(cp), 0, priority,
+                           *parentCache);
+        dpp.createPkt(paddr, blkSize, requestorId, tagPrefetch, tick);
+        pfq.pushBack(dpp);
     }
 }
 
 void
-Queued::printQueue(const std::list<DeferredPacket> &queue) const
+Queued::printQueue(const DeferredQueue &queue) const
 {
     int pos = 0;
     std::string queue_name = "";
@@ -128,13 +211,14 @@ Queued::printQueue(const std::list<DeferredPacket> &queue) const
         queue_name = "PFTransQ";
     }
 
-    for (const_iterator it = queue.cbegin(); it != queue.cend();
-                                                            it++, pos++) {
-        Addr vaddr = it->pfInfo.getAddr();
+    for (auto idx = queue.head(); idx != DeferredQueue::Invalid;
+         idx = queue.next(idx), pos++) {
+        const DeferredPacket &dp = queue.at(idx);
+        Addr vaddr = dp.pfInfo.getAddr();
         /* Set paddr to 0 if not yet translated */
-        Addr paddr = it->pkt ? it->pkt->getAddr() : 0;
+        Addr paddr = dp.pkt ? dp.pkt->getAddr() : 0;
         DPRINTF(HWPrefetchQueue, "%s[%d]: Prefetch Req VA: %#x PA: %#x "
-                "prio: %3d\n", queue_name, pos, vaddr, paddr, it->priority);
+                "prio: %3d\n", queue_name, pos, vaddr, paddr, dp.priority);
     }
 }
 
@@ -165,9 +249,45 @@ Queued::getMaxPermittedPrefetches(size_t total) const
         max_pfs = min_pfs + (total - min_pfs) *
             usefulPrefetches / issuedPrefetches;
     }
+
+    // A throttled prefetcher only queues its first candidates
+    if (total > 0 && aggressiveness < 1.0) {
+        max_pfs = std::min(max_pfs, std::max<size_t>(1,
+            std::ceil(total * aggressiveness)));
+    }
     return max_pfs;
 }
 
+unsigned
+Queued::fillLevel(int32_t priority) const
+{
+    if (fillThresholds.empty()) {
+        return 0;
+    }
+    for (unsigned level = 0; level < fillThresholds.size(); level++) {
+        if (priority >= fillThresholds[level]) {
+            return level;
+        }
+    }
+    return DropLevel;
+}
+
+bool
+Queued::candidatePaddr(const PrefetchInfo &pfi, Addr addr,
+                       Addr &paddr) const
+{
+    if (!useVirtualAddresses) {
+        paddr = addr;
+        return true;
+    }
+    if (!samePage(addr, pfi.getAddr())) {
+        return false;
+    }
+    // The page offset is the same in both address spaces
+    paddr = pageAddress(pfi.getPaddr()) + pageOffset(addr);
+    return true;
+}
+
 void
 Queued::notify(const CacheAccessProbeArg &acc, const PrefetchInfo &pfi)
 {
@@ -178,32 +298,49 @@ Queued::notify(const CacheAccessProbeArg &acc, const PrefetchInfo &pfi)
 
     // Squash queued prefetches if demand miss to same line
     if (queueSquash) {
-        auto itr = pfq.begin();
-        while (itr != pfq.end()) {
-            if (blockAddress(itr->pfInfo.getAddr()) == blk_addr &&
-                itr->pfInfo.isSecure() == is_secure) {
-                DPRINTF(HWPrefetch, "Removing pf candidate addr: %#x "
-                        "(cl: %#x), demand request going to the same addr\n",
-                        itr->pfInfo.getAddr(),
-                        blockAddress(itr->pfInfo.getAddr()));
-                delete itr->pkt;
-                itr = pfq.erase(itr);
-                statsQueued.pfRemovedDemand++;
-            } else {
-                ++itr;
-            }
+        // Queued prefetches are block aligned, so they are found by the
+        // block address of the demand
+        auto idx = pfq.find(blk_addr, is_secure);
+        while (idx != DeferredQueue::Invalid) {
+            auto next = pfq.nextSameAddr(idx);
+            DeferredPacket &dp = pfq.at(idx);
+            DPRINTF(HWPrefetch, "Removing pf candidate addr: %#x "
+                    "(cl: %#x), demand request going to the same addr\n",
+                    dp.pfInfo.getAddr(), blockAddress(dp.pfInfo.getAddr()));
+            delete dp.pkt;
+            pfq.erase(idx);
+            statsQueued.pfRemovedDemand++;
+            idx = next;
         }
     }
 
+    // A demand miss on a rejected candidate shows the filter was wrong
+    if (filter && pfi.isCacheMiss()) {
+        filter->demandMiss(blk_addr, is_secure);
+    }
+
+    // The prefetcher above already trained this one with the block when
+    // it predicted it
+    if (pkt->cmd.isHWPrefetch() && takeHint(blk_addr, is_secure)) {
+        statsQueued.pfHintsNotRetrained++;
+        return;
+    }
+
     // Calculate prefetches given this access
     std::vector<AddrPriority> addresses;
     calculatePrefetch(pfi, addresses, cache);
 
+    // Functional warming only trains the prefetcher
+    if (warming) {
+        return;
+    }
+
     // Get the maximu number of prefetches that we are allowed to generate
     size_t max_pfs = getMaxPermittedPrefetches(addresses.size());
 
     // Queue up generated prefetches
     size_t num_pfs = 0;
+    std::vector<Addr> hints;
     for (AddrPriority& addr_prio : addresses) {
 
         // Block align prefetch address
@@ -219,12 +356,59 @@ Queued::notify(const CacheAccessProbeArg &acc, const PrefetchInfo &pfi)
 
         bool can_cross_page = (mmu != nullptr);
         if (can_cross_page || samePage(addr_prio.first, pfi.getAddr())) {
+            // Confident candidates are filled here, the others further
+            // down if their physical address is known, and dropped if not
+            const unsigned levels = fillLevel(addr_prio.second);
+            if (levels == DropLevel) {
+                statsQueued.pfLowConfidence++;
+                continue;
+            }
+
+            Addr paddr = 0;
+            const bool has_paddr =
+                candidatePaddr(pfi, addr_prio.first, paddr);
+            if (levels > 0) {
+                // A candidate with no known physical address cannot go
+                // down, and is not confident enough to fill this level
+                if (!has_paddr) {
+                    statsQueued.pfLowerUntranslated++;
+                    continue;
+                }
+                fillAt(PrefetchInfo(pfi, paddr, paddr, false),
+                       addr_prio.second, levels);
+                if (forwardHints) {
+                    hints.push_back(paddr);
+                }
+                num_pfs += 1;
+                if (num_pfs == max_pfs) {
+                    break;
+                }
+                continue;
+            }
+
+            PerceptronFilter::Features features;
+            if (filter) {
+                features = filter->score(
+                    pfi.hasPC() ? pfi.getPC() : 0,
+                    pageAddress(addr_prio.first),
+                    pageOffset(addr_prio.first) >> lBlkSize,
+                    addr_prio.second, requestorId,
+                    (int64_t(addr_prio.first) - int64_t(blk_addr)) >>
+                        lBlkSize);
+                if (!filter->accept(features, addr_prio.first, is_secure)) {
+                    continue;
+                }
+            }
+
             PrefetchInfo new_pfi(pfi,addr_prio.first);
             statsQueued.pfIdentified++;
             DPRINTF(HWPrefetch, "Found a pf candidate addr: %#x, "
                     "inserting into prefetch queue.\n", new_pfi.getAddr());
             // Create and insert the request
-            insert(pkt, new_pfi, addr_prio.second, cache);
+            insert(pkt, new_pfi, addr_prio.second, cache, features);
+            if (forwardHints && has_paddr) {
+                hints.push_back(paddr);
+            }
             num_pfs += 1;
             if (num_pfs == max_pfs) {
                 break;
@@ -233,6 +417,112 @@ Queued::notify(const CacheAccessProbeArg &acc, const PrefetchInfo &pfi)
             DPRINTF(HWPrefetch, "Ignoring page crossing prefetch.\n");
         }
     }
+
+    // The level below learns from the candidates of this one, rather
+    // than relearning the stream from the misses of this level
+    for (Addr hint : hints) {
+        lowerPrefetcher->prefetchHint(PrefetchInfo(pfi, hint, hint, false));
+    }
+}
+
+void
+Queued::forwardedPrefetch(const PrefetchInfo &pfi, int32_t priority,
+                          unsigned levels)
+{
+    statsQueued.pfReceived++;
+    fillAt(pfi, priority, levels);
+}
+
+void
+Queued::fillAt(const PrefetchInfo &pfi, int32_t priority, unsigned levels)
+{
+    if (levels > 0 && lowerPrefetcher) {
+        statsQueued.pfForwarded++;
+        lowerPrefetcher->forwardedPrefetch(pfi, priority, levels - 1);
+        return;
+    }
+
+    // The prefetcher learns its cache when the cache is set up
+    const Addr addr = pfi.getAddr();
+    if (!parentCache || alreadyQueued(pfi, priority)) {
+        return;
+    }
+
+    PerceptronFilter::Features features;
+    if (filter) {
+        features = filter->score(pfi.hasPC() ? pfi.getPC() : 0,
+                                 pageAddress(addr),
+                                 pageOffset(addr) >> lBlkSize, priority,
+                                 requestorId, 0);
+        if (!filter->accept(features, addr, pfi.isSecure())) {
+            return;
+        }
+    }
+
+    DPRINTF(HWPrefetch, "Forwarded pf candidate addr: %#x, inserting into "
+            "prefetch queue.\n", addr);
+    queuePhysical(pfi, addr, priority, *parentCache, features);
+
+    // The cache is not busy with an access of its own, so it must be
+    // told to send the prefetch
+    parentCache->prefetchQueued();
+}
+
+bool
+Queued::takeHint(Addr blk_addr, bool is_secure)
+{
+    if (hintedBlocks.empty()) {
+        return false;
+    }
+    Addr &hint = hintedBlocks[(blk_addr >> lBlkSize) % hintedBlocks.size()];
+    if (hint != (blk_addr | is_secure)) {
+        return false;
+    }
+    hint = MaxAddr;
+    return true;
+}
+
+void
+Queued::prefetchHint(const PrefetchInfo &pfi)
+{
+    if (!parentCache) {
+        return;
+    }
+    statsQueued.pfHints++;
+
+    if (!hintedBlocks.empty()) {
+        const Addr blk_addr = blockAddress(pfi.getAddr());
+        hintedBlocks[(blk_addr >> lBlkSize) % hintedBlocks.size()] =
+            blk_addr | pfi.isSecure();
+    }
+
+    std::vector<AddrPriority> addresses;
+    calculatePrefetch(pfi, addresses, *parentCache);
+
+    size_t max_pfs = getMaxPermittedPrefetches(addresses.size());
+    size_t num_pfs = 0;
+    for (const AddrPriority &addr_prio : addresses) {
+        if (num_pfs == max_pfs) {
+            break;
+        }
+
+        // Without an access of this cache, candidates crossing the page
+        // cannot be translated
+        const Addr addr = blockAddress(addr_prio.first);
+        if (!samePage(addr, pfi.getAddr())) {
+            continue;
+        }
+        const unsigned levels = fillLevel(addr_prio.second);
+        if (levels == DropLevel) {
+            statsQueued.pfLowConfidence++;
+            continue;
+        }
+
+        statsQueued.pfIdentified++;
+        fillAt(PrefetchInfo(pfi, addr, addr, false), addr_prio.second,
+               levels);
+        num_pfs += 1;
+    }
 }
 
 PacketPtr
@@ -252,7 +542,11 @@ Queued::getPacket()
     }
 
     PacketPtr pkt = pfq.front().pkt;
-    pfq.pop_front();
+    if (filter) {
+        filter->issued(pfq.front().features, pkt->getAddr(), pkt->isSecure());
+    }
+    notifyPrefetchIssued(pfq.front().pfInfo, pkt);
+    pfq.erase(pfq.head());
 
     prefetchStats.pfIssued++;
     issuedPrefetches += 1;
@@ -263,6 +557,22 @@ Queued::getPacket()
     return pkt;
 }
 
+void
+Queued::notifyPrefetchUseful(Addr addr, bool is_secure)
+{
+    if (filter) {
+        filter->prefetchUseful(blockAddress(addr), is_secure);
+    }
+}
+
+void
+Queued::notifyPrefetchUnused(Addr addr, bool is_secure)
+{
+    if (filter) {
+        filter->prefetchUnused(blockAddress(addr), is_secure);
+    }
+}
+
 Queued::QueuedStats::QueuedStats(statistics::Group *parent)
     : statistics::Group(parent),
     ADD_STAT(pfIdentified, statistics::units::Count::get(),
@@ -279,7 +589,21 @@ Queued::QueuedStats::QueuedStats(statistics::Group *parent)
     ADD_STAT(pfSpanPage, statistics::units::Count::get(),
              "number of prefetches that crossed the page"),
     ADD_STAT(pfUsefulSpanPage, statistics::units::Count::get(),
-             "number of prefetches that is useful and crossed the page")
+             "number of prefetches that is useful and crossed the page"),
+    ADD_STAT(pfForwarded, statistics::units::Count::get(),
+             "number of prefetch candidates forwarded to a lower level"),
+    ADD_STAT(pfReceived, statistics::units::Count::get(),
+             "number of prefetch candidates received from an upper level"),
+    ADD_STAT(pfHints, statistics::units::Count::get(),
+             "number of prefetch candidates of an upper level trained on"),
+    ADD_STAT(pfHintsNotRetrained, statistics::units::Count::get(),
+             "number of prefetches of an upper level not trained on again, "
+             "as their candidate was"),
+    ADD_STAT(pfLowConfidence, statistics::units::Count::get(),
+             "number of prefetch candidates dropped for their low priority"),
+    ADD_STAT(pfLowerUntranslated, statistics::units::Count::get(),
+             "number of prefetch candidates of a lower level dropped for "
+             "lack of a physical address")
 {
 }
 
@@ -288,12 +612,12 @@ void
 Queued::processMissingTranslations(unsigned max)
 {
     unsigned count = 0;
-    iterator it = pfqMissingTranslation.begin();
-    while (it != pfqMissingTranslation.end() && count < max) {
-        DeferredPacket &dp = *it;
-        // Increase the iterator first because dp.startTranslation can end up
-        // calling finishTranslation, which will erase "it"
-        it++;
+    auto idx = pfqMissingTranslation.head();
+    while (idx != DeferredQueue::Invalid && count < max) {
+        DeferredPacket &dp = pfqMissingTranslation.at(idx);
+        // Advance the index first because dp.startTranslation can end up
+        // calling finishTranslation, which will erase "idx"
+        idx = pfqMissingTranslation.next(idx);
         dp.startTranslation(mmu);
         count += 1;
     }
@@ -303,14 +627,9 @@ void
 Queued::translationComplete(DeferredPacket *dp, bool failed,
                             const CacheAccessor &cache)
 {
-    auto it = pfqMissingTranslation.begin();
-    while (it != pfqMissingTranslation.end()) {
-        if (&(*it) == dp) {
-            break;
-        }
-        it++;
-    }
-    assert(it != pfqMissingTranslation.end());
+    auto idx = pfqMissingTranslation.indexOf(*dp);
+    assert(idx != DeferredQueue::Invalid);
+    DeferredPacket *it = &pfqMissingTranslation.at(idx);
     if (!failed) {
         DPRINTF(HWPrefetch, "%s Translation of vaddr %#x succeeded: "
                 "paddr %#x \n", mmu->name(),
@@ -335,34 +654,22 @@ Queued::translationComplete(DeferredPacket *dp, bool failed,
                 "prefetch request %#x \n", mmu->name(),
                 it->translationRequest->getVaddr());
     }
-    pfqMissingTranslation.erase(it);
+    pfqMissingTranslation.erase(idx);
 }
 
 bool
-Queued::alreadyInQueue(std::list<DeferredPacket> &queue,
+Queued::alreadyInQueue(DeferredQueue &queue,
                                  const PrefetchInfo &pfi, int32_t priority)
 {
-    bool found = false;
-    iterator it;
-    for (it = queue.begin(); it != queue.end() && !found; it++) {
-        found = it->pfInfo.sameAddr(pfi);
-    }
+    DeferredQueue::Index idx;
+    bool found = queue.findDuplicate(pfi.getAddr(), pfi.isSecure(), idx);
 
     /* If the address is already in the queue, update priority and leave */
-    if (it != queue.end()) {
+    if (idx != DeferredQueue::Invalid) {
         statsQueued.pfBufferHit++;
-        if (it->priority < priority) {
+        if (queue.at(idx).priority < priority) {
             /* Update priority value and position in the queue */
-            it->priority = priority;
-            iterator prev = it;
-            while (prev != queue.begin()) {
-                prev--;
-                /* If the packet has higher priority, swap */
-                if (*it > *prev) {
-                    std::swap(*it, *prev);
-                    it = prev;
-                }
-            }
+            queue.setPriority(idx, priority);
             DPRINTF(HWPrefetch, "Prefetch addr already in "
                 "prefetch queue, priority updated\n");
         } else {
@@ -377,24 +684,52 @@ RequestPtr
 Queued::createPrefetchRequest(Addr addr, PrefetchInfo const &pfi,
                                         PacketPtr pkt)
 {
-    RequestPtr translation_req = std::make_shared<Request>(
+    RequestPtr translation_req = Request::create(
             addr, blkSize, pkt->req->getFlags(), requestorId, pfi.getPC(),
             pkt->req->contextId());
     translation_req->setFlags(Request::PREFETCH);
     return translation_req;
 }
 
+bool
+Queued::alreadyQueued(const PrefetchInfo &pfi, int32_t priority)
+{
+    return queueFilter &&
+        (alreadyInQueue(pfq, pfi, priority) ||
+         alreadyInQueue(pfqMissingTranslation, pfi, priority));
+}
+
+void
+Queued::queuePhysical(const PrefetchInfo &new_pfi, Addr paddr,
+                      int32_t priority, const CacheAccessor &cache,
+                      const PerceptronFilter::Features &features)
+{
+    if (cacheSnoop &&
+            (cache.inCache(paddr, new_pfi.isSecure()) ||
+             cache.inMissQueue(paddr, new_pfi.isSecure()))) {
+        statsQueued.pfInCache++;
+        DPRINTF(HWPrefetch, "Dropping redundant in "
+                "cache/MSHR prefetch addr:%#x\n", paddr);
+        return;
+    }
+
+    DeferredPacket dpp(this, new_pfi, 0, priority, cache);
+    dpp.features = features;
+    Tick pf_time = curTick() + clockPeriod() * latency;
+    dpp.createPkt(paddr, blkSize, requestorId, tagPrefetch, pf_time);
+    DPRINTF(HWPrefetch, "Prefetch queued. "
+            "addr:%#x priority: %3d tick:%lld.\n",
+            new_pfi.getAddr(), priority, pf_time);
+    addToQueue(pfq, dpp);
+}
+
 void
 Queued::insert(const PacketPtr &pkt, PrefetchInfo &new_pfi,
-               int32_t priority, const CacheAccessor &cache)
+               int32_t priority, const CacheAccessor &cache,
+               const PerceptronFilter::Features &features)
 {
-    if (queueFilter) {
-        if (alreadyInQueue(pfq, new_pfi, priority)) {
-            return;
-        }
-        if (alreadyInQueue(pfqMissingTranslation, new_pfi, priority)) {
-            return;
-        }
+    if (alreadyQueued(new_pfi, priority)) {
+        return;
     }
 
     /*
@@ -454,80 +789,39 @@ Queued::insert(const PacketPtr &pkt, PrefetchInfo &new_pfi,
             return;
         }
     }
-    if (has_target_pa && cacheSnoop &&
-            (cache.inCache(target_paddr, new_pfi.isSecure()) ||
-             cache.inMissQueue(target_paddr, new_pfi.isSecure()))) {
-        statsQueued.pfInCache++;
-        DPRINTF(HWPrefetch, "Dropping redundant in "
-                "cache/MSHR prefetch addr:%#x\n", target_paddr);
+    if (has_target_pa) {
+        queuePhysical(new_pfi, target_paddr, priority, cache, features);
         return;
     }
 
-    /* Create the packet and find the spot to insert it */
+    // Add the translation request and try to resolve it later
     DeferredPacket dpp(this, new_pfi, 0, priority, cache);
-    if (has_target_pa) {
-        Tick pf_time = curTick() + clockPeriod() * latency;
-        dpp.createPkt(target_paddr, blkSize, requestorId, tagPrefetch,
-                      pf_time);
-        DPRINTF(HWPrefetch, "Prefetch queued. "
-                "addr:%#x priority: %3d tick:%lld.\n",
-                new_pfi.getAddr(), priority, pf_time);
-        addToQueue(pfq, dpp);
-    } else {
-        // Add the translation request and try to resolve it later
-        dpp.setTranslationRequest(translation_req);
-        dpp.tc = system->threads[translation_req->contextId()];
-        DPRINTF(HWPrefetch, "Prefetch queued with no translation. "
-                "addr:%#x priority: %3d\n", new_pfi.getAddr(), priority);
-        addToQueue(pfqMissingTranslation, dpp);
-    }
+    dpp.features = features;
+    dpp.setTranslationRequest(translation_req);
+    dpp.tc = system->threads[translation_req->contextId()];
+    DPRINTF(HWPrefetch, "Prefetch queued with no translation. "
+            "addr:%#x priority: %3d\n", new_pfi.getAddr(), priority);
+    addToQueue(pfqMissingTranslation, dpp);
 }
 
 void
-Queued::addToQueue(std::list<DeferredPacket> &queue,
+Queued::addToQueue(DeferredQueue &queue,
                              DeferredPacket &dpp)
 {
     /* Verify prefetch buffer space for request */
-    if (queue.size() == queueSize) {
+    if (queue.full()) {
         statsQueued.pfRemovedFull++;
-        /* Lowest priority packet */
-        iterator it = queue.end();
-        panic_if (it == queue.begin(),
-            "Prefetch queue is both full and empty!");
-        --it;
-        /* Look for oldest in that level of priority */
-        panic_if (it == queue.begin(),
-            "Prefetch queue is full with 1 element!");
-        iterator prev = it;
-        bool cont = true;
-        /* While not at the head of the queue */
-        while (cont && prev != queue.begin()) {
-            prev--;
-            /* While at the same level of priority */
-            cont = prev->priority == it->priority;
-            if (cont)
-                /* update pointer */
-                it = prev;
-        }
+        /* Oldest packet of the lowest priority */
+        auto idx = queue.lowest();
+        DeferredPacket &victim = queue.at(idx);
         DPRINTF(HWPrefetch, "Prefetch queue full, removing lowest priority "
-                            "oldest packet, addr: %#x\n",it->pfInfo.getAddr());
-        delete it->pkt;
-        queue.erase(it);
+                            "oldest packet, addr: %#x\n",
+                            victim.pfInfo.getAddr());
+        delete victim.pkt;
+        queue.erase(idx);
     }
 
-    if ((queue.size() == 0) || (dpp <= queue.back())) {
-        queue.emplace_back(dpp);
-    } else {
-        iterator it = queue.end();
-        do {
-            --it;
-        } while (it != queue.begin() && dpp > *it);
-        /* If we reach the head, we have to see if the new element is new head
-         * or not */
-        if (it == queue.begin() && dpp <= *it)
-            it++;
-        queue.insert(it, dpp);
-    }
+    queue.push(dpp);
 
     if (debug::HWPrefetchQueue)
         printQueue(queue);
@@ -39,13 +39,16 @@
 #define __MEM_CACHE_PREFETCH_QUEUED_HH__
 
 #include <cstdint>
-#include <list>
+#include <limits>
 #include <utility>
+#include <vector>
 
 #include "arch/generic/mmu.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/cache/prefetch/base.hh"
+#include "mem/cache/prefetch/perceptron_filter.hh"
+#include "mem/cache/prefetch/prefetch_queue.hh"
 #include "mem/packet.hh"
 
 namespace gem5
@@ -76,6 +79,8 @@ class Queued : public Base
         ThreadContext *tc;
         bool ongoingTranslation;
         const CacheAccessor *cache;
+        /** How the filter scored this prefetch, to train it later */
+        PerceptronFilter::Features features;
 
         /**
          * Constructor
@@ -141,11 +146,10 @@ class Queued : public Base
         void startTranslation(BaseMMU *mmu);
     };
 
-    std::list<DeferredPacket> pfq;
-    std::list<DeferredPacket> pfqMissingTranslation;
+    using DeferredQueue = PrefetchQueue<DeferredPacket>;
 
-    using const_iterator = std::list<DeferredPacket>::const_iterator;
-    using iterator = std::list<DeferredPacket>::iterator;
+    DeferredQueue pfq;
+    DeferredQueue pfqMissingTranslation;
 
     // PARAMETERS
 
@@ -176,6 +180,40 @@ class Queued : public Base
     /** Percentage of requests that can be throttled */
     const unsigned int throttleControlPct;
 
+    /** Filter of the candidates, if any */
+    PerceptronFilter *filter;
+
+    /**
+     * Aggressiveness set by the feedback throttle, relative to the
+     * configuration. Below 1, only this fraction of the candidates of an
+     * access, the first ones, are queued.
+     */
+    double aggressiveness;
+
+    /** Prefetcher of the next cache level, if any */
+    Queued *lowerPrefetcher;
+
+    /**
+     * Priorities a candidate needs to be filled at this level, then at
+     * each level below. Candidates below the last one are dropped. If
+     * empty, every candidate is filled at this level.
+     */
+    const std::vector<int32_t> fillThresholds;
+
+    /** Train the lower prefetcher on the candidates of this one */
+    const bool forwardHints;
+
+    /**
+     * Blocks this prefetcher was hinted, direct mapped by block address,
+     * tagged with their security. The prefetch of the level above for a
+     * hinted block is then not trained on again when it misses here.
+     */
+    std::vector<Addr> hintedBlocks;
+
+    /** Fill level of the candidates that are not prefetched at all */
+    static constexpr unsigned DropLevel =
+        std::numeric_limits<unsigned>::max();
+
     struct QueuedStats : public statistics::Group
     {
         QueuedStats(statistics::Group *parent);
@@ -187,6 +225,12 @@ class Queued : public Base
         statistics::Scalar pfRemovedFull;
         statistics::Scalar pfSpanPage;
         statistics::Scalar pfUsefulSpanPage;
+        statistics::Scalar pfForwarded;
+        statistics::Scalar pfReceived;
+        statistics::Scalar pfHints;
+        statistics::Scalar pfHintsNotRetrained;
+        statistics::Scalar pfLowConfidence;
+        statistics::Scalar pfLowerUntranslated;
     } statsQueued;
   public:
     using AddrPriority = std::pair<Addr, int32_t>;
@@ -194,11 +238,69 @@ class Queued : public Base
     Queued(const QueuedPrefetcherParams &p);
     virtual ~Queued();
 
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
     void
     notify(const CacheAccessProbeArg &acc, const PrefetchInfo &pfi) override;
 
     void insert(const PacketPtr &pkt, PrefetchInfo &new_pfi, int32_t priority,
-                const CacheAccessor &cache);
+                const CacheAccessor &cache,
+                const PerceptronFilter::Features &features);
+
+    void notifyPrefetchUseful(Addr addr, bool is_secure) override;
+    void notifyPrefetchUnused(Addr addr, bool is_secure) override;
+
+    /**
+     * Notify the prefetcher that one of its prefetches leaves the queue
+     * to be issued by the cache.
+     * @param pfi Information of the prefetch, with the triggering PC
+     * @param pkt The prefetch packet, by physical address
+     */
+    virtual void notifyPrefetchIssued(const PrefetchInfo &pfi,
+                                      const PacketPtr &pkt)
+    {}
+
+    /**
+     * Adjust how aggressively the prefetcher prefetches. Prefetchers with
+     * a degree, a distance or a lookahead scale it, e.g. Stride, TDT,
+     * SPP, SMS, Temporal, IMP and FDIP. The others only respond below
+     * their configured aggressiveness, by queueing a fraction of their
+     * candidates, and always at least one.
+     * @param scale Aggressiveness relative to the configuration
+     */
+    virtual void
+    setAggressiveness(double scale)
+    {
+        aggressiveness = scale;
+    }
+
+    /**
+     * Take a candidate of the prefetcher of the level above, to be filled
+     * at this level or further down.
+     * @param pfi The candidate, by physical address
+     * @param priority Priority of the candidate
+     * @param levels Number of levels below this one to fill it at
+     */
+    void forwardedPrefetch(const PrefetchInfo &pfi, int32_t priority,
+                           unsigned levels);
+
+    /**
+     * Train on a candidate of the prefetcher of the level above, as if it
+     * were an access to this level, and queue what it predicts from it.
+     * The candidate is remembered, so that its prefetch does not train
+     * this prefetcher a second time.
+     * @param pfi The candidate, by physical address
+     */
+    void prefetchHint(const PrefetchInfo &pfi);
+
+    /**
+     * Check whether a block was hinted, forgetting the hint.
+     * @param blk_addr Block address, physical
+     * @param is_secure Whether the block is secure
+     * @return Whether a hint for the block was pending
+     */
+    bool takeHint(Addr blk_addr, bool is_secure);
 
     virtual void calculatePrefetch(const PrefetchInfo &pfi,
                                    std::vector<AddrPriority> &addresses,
@@ -210,7 +312,7 @@ class Queued : public Base
         return pfq.empty() ? MaxTick : pfq.front().tick;
     }
 
-    void printQueue(const std::list<DeferredPacket> &queue) const;
+    void printQueue(const DeferredQueue &queue) const;
 
   private:
 
@@ -219,7 +321,7 @@ class Queued : public Base
      * @param queue selected queue to use
      * @param dpp DeferredPacket to add
      */
-    void addToQueue(std::list<DeferredPacket> &queue, DeferredPacket &dpp);
+    void addToQueue(DeferredQueue &queue, DeferredPacket &dpp);
 
     /**
      * Starts the translations of the queued prefetches with a
@@ -249,7 +351,7 @@ class Queued : public Base
      * @param priority priority of the prefetch request to be added
      * @return True if the prefetch request was found in the queue
      */
-    bool alreadyInQueue(std::list<DeferredPacket> &queue,
+    bool alreadyInQueue(DeferredQueue &queue,
                         const PrefetchInfo &pfi, int32_t priority);
 
     /**
@@ -262,6 +364,51 @@ class Queued : public Base
      */
     size_t getMaxPermittedPrefetches(size_t total) const;
 
+    /**
+     * Select the level a candidate is filled at from its priority.
+     * @param priority Priority of the candidate
+     * @return The number of levels below this one, or DropLevel
+     */
+    unsigned fillLevel(int32_t priority) const;
+
+    /**
+     * Compute the physical address of a candidate, if it is known
+     * without a translation.
+     * @param pfi The access that generated the candidate
+     * @param addr The candidate
+     * @param paddr Its physical address, if known
+     * @return Whether the physical address is known
+     */
+    bool candidatePaddr(const PrefetchInfo &pfi, Addr addr,
+                        Addr &paddr) const;
+
+    /**
+     * Check whether a prefetch is already queued, if the queues filter
+     * redundant prefetches.
+     */
+    bool alreadyQueued(const PrefetchInfo &pfi, int32_t priority);
+
+    /**
+     * Queue a prefetch whose physical address is known.
+     * @param new_pfi The prefetch
+     * @param paddr Its physical address
+     * @param priority Its priority
+     * @param cache Accessor of the cache of the prefetcher
+     * @param features How the filter scored the prefetch
+     */
+    void queuePhysical(const PrefetchInfo &new_pfi, Addr paddr,
+                       int32_t priority, const CacheAccessor &cache,
+                       const PerceptronFilter::Features &features);
+
+    /**
+     * Queue a candidate known by its physical address at this level, or
+     * forward it to a lower level.
+     * @param pfi The candidate
+     * @param priority Its priority
+     * @param levels Number of levels below this one to fill it at
+     */
+    void fillAt(const PrefetchInfo &pfi, int32_t priority, unsigned levels);
+
     RequestPtr createPrefetchRequest(Addr addr, PrefetchInfo const &pfi,
                                         PacketPtr pkt);
 };
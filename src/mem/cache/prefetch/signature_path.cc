@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/prefetch/signature_path.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "params/SignaturePathPrefetcher.hh"
+
+namespace gem5
+{
+
+namespace prefetch
+{
+
+SignaturePath::SignatureEntry::SignatureEntry(TagExtractor ext)
+  : TaggedEntry()
+{
+    registerTagExtractor(ext);
+    invalidate();
+}
+
+void
+SignaturePath::SignatureEntry::invalidate()
+{
+    TaggedEntry::invalidate();
+    signature = 0;
+    lastBlock = 0;
+}
+
+SignaturePath::PatternEntry::PatternEntry(size_t num_deltas,
+                                          const SatCounter8 &init_counter,
+                                          TagExtractor ext)
+  : TaggedEntry(), signatureCounter(init_counter),
+    deltas(num_deltas, DeltaCounter(init_counter))
+{
+    registerTagExtractor(ext);
+    invalidate();
+}
+
+void
+SignaturePath::PatternEntry::invalidate()
+{
+    TaggedEntry::invalidate();
+    signatureCounter.reset();
+    for (DeltaCounter &dc : deltas) {
+        dc.delta = 0;
+        dc.counter.reset();
+    }
+}
+
+void
+SignaturePath::PatternEntry::update(Delta delta)
+{
+    auto it = std::find_if(deltas.begin(), deltas.end(),
+        [delta](const DeltaCounter &dc) { return dc.delta == delta; });
+    if (it == deltas.end()) {
+        it = std::min_element(deltas.begin(), deltas.end(),
+            [](const DeltaCounter &a, const DeltaCounter &b)
+            { return a.counter < b.counter; });
+        it->delta = delta;
+        it->counter.reset();
+    }
+
+    // Halve all counters rather than saturating, so that the ratio of a
+    // delta counter to the signature counter stays a frequency
+    if (signatureCounter.isSaturated() || it->counter.isSaturated()) {
+        signatureCounter >>= 1;
+        for (DeltaCounter &dc : deltas) {
+            dc.counter >>= 1;
+        }
+    }
+    signatureCounter++;
+    it->counter++;
+}
+
+const SignaturePath::DeltaCounter *
+SignaturePath::PatternEntry::best() const
+{
+    const DeltaCounter *best = nullptr;
+    for (const DeltaCounter &dc : deltas) {
+        if (dc.counter > 0 && (!best || dc.counter > best->counter)) {
+            best = &dc;
+        }
+    }
+    return best;
+}
+
+SignaturePath::SignaturePath(const SignaturePathPrefetcherParams &p)
+  : Queued(p),
+    signatureBits(p.signature_bits),
+    signatureShift(p.signature_shift),
+    blocksPerPage(p.page_bytes / p.block_size),
+    deltaBits(ceilLog2(p.page_bytes / p.block_size)),
+    prefetchThreshold(p.prefetch_confidence_threshold / 100.0),
+    lookaheadThreshold(p.lookahead_confidence_threshold / 100.0),
+    maxLookaheadDepth(p.max_lookahead_depth),
+    scaledLookaheadDepth(maxLookaheadDepth),
+    signatureTable((name() + ".SignatureTable").c_str(),
+                   p.signature_table_entries,
+                   p.signature_table_assoc,
+                   p.signature_table_replacement_policy,
+                   p.signature_table_indexing_policy,
+                   SignatureEntry(genTagExtractor(
+                       p.signature_table_indexing_policy))),
+    patternTable((name() + ".PatternTable").c_str(),
+                 p.pattern_table_entries,
+                 p.pattern_table_assoc,
+                 p.pattern_table_replacement_policy,
+                 p.pattern_table_indexing_policy,
+                 PatternEntry(p.strides_per_pattern_entry,
+                              SatCounter8(p.num_counter_bits, 0),
+                              genTagExtractor(
+                                  p.pattern_table_indexing_policy))),
+    globalHistory(p.global_history_register_entries),
+    nextGlobalHistory(0),
+    sppStats(this, p.max_lookahead_depth)
+{
+    fatal_if(signatureBits == 0 || signatureBits > 32,
+             "The signatures must have between 1 and 32 bits.\n");
+    fatal_if(p.strides_per_pattern_entry == 0,
+             "The pattern entries must hold at least one delta.\n");
+    fatal_if(globalHistory.empty(),
+             "The global history register needs at least one entry.\n");
+    fatal_if(prefetchThreshold > lookaheadThreshold,
+             "The prefetch confidence threshold must not be above the "
+             "lookahead one.\n");
+}
+
+SignaturePath::SignaturePathStats::SignaturePathStats(
+    statistics::Group *parent, unsigned max_lookahead_depth)
+  : statistics::Group(parent, "spp"),
+    ADD_STAT(lookaheadDepth, statistics::units::Count::get(),
+             "Number of lookahead steps taken per access"),
+    ADD_STAT(ghrInserts, statistics::units::Count::get(),
+             "Number of paths recorded in the global history when leaving "
+             "a page"),
+    ADD_STAT(ghrHits, statistics::units::Count::get(),
+             "Number of new pages whose signature was resumed from the "
+             "global history"),
+    ADD_STAT(pfPageCrossing, statistics::units::Count::get(),
+             "Number of candidates dropped because they left the page")
+{
+    lookaheadDepth.init(0, max_lookahead_depth, 1);
+}
+
+uint32_t
+SignaturePath::updateSignature(uint32_t signature, Delta delta) const
+{
+    // Deltas are added in sign-magnitude form, with the sign right above
+    // the magnitude
+    uint32_t encoded = delta < 0 ? (-delta) | (1 << deltaBits) : delta;
+    return ((signature << signatureShift) ^ encoded) & mask(signatureBits);
+}
+
+void
+SignaturePath::recordGlobalHistory(uint32_t signature, double confidence,
+                                   unsigned last_block, Delta delta)
+{
+    for (GlobalHistoryEntry &entry : globalHistory) {
+        if (entry.valid && entry.signature == signature &&
+            entry.lastBlock == last_block && entry.delta == delta) {
+            entry.confidence = confidence;
+            return;
+        }
+    }
+
+    GlobalHistoryEntry &entry = globalHistory[nextGlobalHistory];
+    nextGlobalHistory = (nextGlobalHistory + 1) % globalHistory.size();
+    entry.valid = true;
+    entry.signature = signature;
+    entry.confidence = confidence;
+    entry.lastBlock = last_block;
+    entry.delta = delta;
+    sppStats.ghrInserts++;
+}
+
+const SignaturePath::GlobalHistoryEntry *
+SignaturePath::findGlobalHistory(unsigned block) const
+{
+    const GlobalHistoryEntry *found = nullptr;
+    for (const GlobalHistoryEntry &entry : globalHistory) {
+        if (!entry.valid) {
+            continue;
+        }
+        // Block of the neighbouring page the path went to
+        int target = int(entry.lastBlock) + entry.delta;
+        if (target < 0) {
+            target += blocksPerPage;
+        } else if (target >= int(blocksPerPage)) {
+            target -= blocksPerPage;
+        }
+        if (target == int(block) &&
+            (!found || entry.confidence > found->confidence)) {
+            found = &entry;
+        }
+    }
+    return found;
+}
+
+SignaturePath::SignatureEntry &
+SignaturePath::getSignatureEntry(Addr page, bool is_secure, unsigned block,
+                                 bool &is_new)
+{
+    const SignatureEntry::KeyType key{page, is_secure};
+    SignatureEntry *entry = signatureTable.findEntry(key);
+    is_new = (entry == nullptr);
+    if (!is_new) {
+        signatureTable.accessEntry(entry);
+        return *entry;
+    }
+
+    entry = signatureTable.findVictim(key);
+    signatureTable.insertEntry(key, entry);
+    entry->lastBlock = block;
+
+    const GlobalHistoryEntry *ghr = findGlobalHistory(block);
+    if (ghr != nullptr) {
+        entry->signature = updateSignature(ghr->signature, ghr->delta);
+        sppStats.ghrHits++;
+        DPRINTF(HWPrefetch, "SPP: page %#x resumes signature %#x\n", page,
+                entry->signature);
+    }
+    return *entry;
+}
+
+void
+SignaturePath::updatePatternTable(uint32_t signature, Delta delta)
+{
+    const PatternEntry::KeyType key{signature, false};
+    PatternEntry *entry = patternTable.findEntry(key);
+    if (entry != nullptr) {
+        patternTable.accessEntry(entry);
+    } else {
+        entry = patternTable.findVictim(key);
+        patternTable.insertEntry(key, entry);
+    }
+    entry->update(delta);
+}
+
+void
+SignaturePath::setAggressiveness(double scale)
+{
+    // The lookahead goes further or stops earlier along the path
+    scaledLookaheadDepth =
+        std::max(1u, unsigned(std::lround(maxLookaheadDepth * scale)));
+}
+
+void
+SignaturePath::lookahead(Addr page_addr, unsigned block, uint32_t signature,
+                         std::vector<AddrPriority> &addresses)
+{
+    double path_confidence = 1.0;
+    unsigned depth = 0;
+    while (depth < scaledLookaheadDepth) {
+        const PatternEntry *entry =
+            patternTable.findEntry(PatternEntry::KeyType{signature, false});
+        if (entry == nullptr || entry->signatureCounter == 0) {
+            break;
+        }
+        const double occurrences = entry->signatureCounter;
+
+        for (const DeltaCounter &dc : entry->deltas) {
+            if (dc.counter == 0) {
+                continue;
+            }
+            const double confidence =
+                path_confidence * dc.counter / occurrences;
+            if (confidence < prefetchThreshold) {
+                continue;
+            }
+            const int target = int(block) + dc.delta;
+            if (target < 0 || target >= int(blocksPerPage)) {
+                // The next page is not known from here; leave the path to
+                // its first access
+                recordGlobalHistory(signature, confidence, block, dc.delta);
+                sppStats.pfPageCrossing++;
+                continue;
+            }
+            addresses.push_back(AddrPriority(
+                pageIthBlockAddress(page_addr, target),
+                int32_t(confidence * 100)));
+        }
+
+        // Follow the most likely delta
+        const DeltaCounter *best = entry->best();
+        if (best == nullptr) {
+            break;
+        }
+        path_confidence *= best->counter / occurrences;
+        depth++;
+        const int next = int(block) + best->delta;
+        if (path_confidence < lookaheadThreshold || next < 0 ||
+            next >= int(blocksPerPage)) {
+            break;
+        }
+        block = next;
+        signature = updateSignature(signature, best->delta);
+    }
+    sppStats.lookaheadDepth.sample(depth);
+}
+
+void
+SignaturePath::calculatePrefetch(const PrefetchInfo &pfi,
+                                 std::vector<AddrPriority> &addresses,
+                                 const CacheAccessor &cache)
+{
+    const Addr addr = pfi.getAddr();
+    const Addr page_addr = pageAddress(addr);
+    const unsigned block = pageOffset(addr) >> lBlkSize;
+
+    bool is_new;
+    SignatureEntry &entry = getSignatureEntry(page_addr / pageBytes,
+                                              pfi.isSecure(), block, is_new);
+    if (!is_new) {
+        const Delta delta = Delta(block) - Delta(entry.lastBlock);
+        // Repeated accesses to a block carry no new information
+        if (delta == 0) {
+            return;
+        }
+        updatePatternTable(entry.signature, delta);
+        entry.signature = updateSignature(entry.signature, delta);
+        entry.lastBlock = block;
+    }
+
+    DPRINTF(HWPrefetch, "SPP: access %#x, block %d, signature %#x\n", addr,
+            block, entry.signature);
+    lookahead(page_addr, block, entry.signature, addresses);
+}
+
+} // namespace prefetch
+} // namespace gem5
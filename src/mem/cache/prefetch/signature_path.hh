@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes a Signature Path Prefetcher (SPP).
+ *
+ * The prefetcher compresses the history of the block deltas seen within a
+ * page into a signature, and learns in a pattern table which deltas follow
+ * each signature. On every access it walks the most likely path of deltas
+ * ahead of the access, prefetching the deltas whose path confidence is
+ * high enough, for as long as the confidence of the path itself is high
+ * enough. A global history register records the paths that leave a page,
+ * so that the first access to the next page resumes them instead of
+ * learning from scratch.
+ *
+ * J. Kim, S. H. Pugsley, P. V. Gratz, A. L. N. Reddy, C. Wilkerson and
+ * Z. Chishti, "Path confidence based lookahead prefetching", MICRO 2016.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_SIGNATURE_PATH_HH__
+#define __MEM_CACHE_PREFETCH_SIGNATURE_PATH_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/cache/associative_cache.hh"
+#include "base/sat_counter.hh"
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/cache/prefetch/queued.hh"
+#include "mem/cache/tags/tagged_entry.hh"
+#include "mem/packet.hh"
+
+namespace gem5
+{
+
+struct SignaturePathPrefetcherParams;
+
+namespace prefetch
+{
+
+class SignaturePath : public Queued
+{
+  protected:
+    /** Signed distance between two blocks of a page, in blocks */
+    using Delta = int16_t;
+
+    /** Number of bits of the signatures */
+    const unsigned signatureBits;
+
+    /** Number of bits a signature is shifted by before adding a delta */
+    const unsigned signatureShift;
+
+    /** Number of blocks of a page */
+    const unsigned blocksPerPage;
+
+    /** Number of bits of the magnitude of an encoded delta */
+    const unsigned deltaBits;
+
+    /** Confidence a path needs for its delta to be prefetched */
+    const double prefetchThreshold;
+
+    /** Confidence a path needs for the lookahead to go on */
+    const double lookaheadThreshold;
+
+    /** Largest number of lookahead steps per access */
+    const unsigned maxLookaheadDepth;
+
+    /** Lookahead depth scaled by the feedback throttle */
+    unsigned scaledLookaheadDepth;
+
+    /** Signature of the delta history of a page */
+    struct SignatureEntry : public TaggedEntry
+    {
+        SignatureEntry(TagExtractor ext);
+
+        void invalidate() override;
+
+        /** Signature of the deltas seen in the page */
+        uint32_t signature;
+        /** Block of the page accessed last */
+        unsigned lastBlock;
+    };
+    AssociativeCache<SignatureEntry> signatureTable;
+
+    /** A delta that follows a signature, and how often it does */
+    struct DeltaCounter
+    {
+        DeltaCounter(const SatCounter8 &init_counter)
+          : delta(0), counter(init_counter)
+        {
+        }
+
+        Delta delta;
+        SatCounter8 counter;
+    };
+
+    /** Deltas that follow a signature */
+    struct PatternEntry : public TaggedEntry
+    {
+        PatternEntry(size_t num_deltas, const SatCounter8 &init_counter,
+                     TagExtractor ext);
+
+        void invalidate() override;
+
+        /**
+         * Count an occurrence of a delta after this signature. A missing
+         * delta replaces the least frequent one, and all counters are
+         * halved when one of them saturates.
+         * @param delta The delta
+         */
+        void update(Delta delta);
+
+        /** @return The most frequent delta, nullptr if there is none */
+        const DeltaCounter *best() const;
+
+        /** Number of occurrences of the signature */
+        SatCounter8 signatureCounter;
+        std::vector<DeltaCounter> deltas;
+    };
+    AssociativeCache<PatternEntry> patternTable;
+
+    /** A path that left a page, to resume in the next page */
+    struct GlobalHistoryEntry
+    {
+        bool valid = false;
+        uint32_t signature = 0;
+        double confidence = 0.0;
+        /** Block of the page the path left */
+        unsigned lastBlock = 0;
+        /** Delta that left the page */
+        Delta delta = 0;
+    };
+    std::vector<GlobalHistoryEntry> globalHistory;
+
+    /** Entry of the global history that is replaced next */
+    size_t nextGlobalHistory;
+
+    struct SignaturePathStats : public statistics::Group
+    {
+        SignaturePathStats(statistics::Group *parent,
+                           unsigned max_lookahead_depth);
+
+        /** Lookahead steps taken per access */
+        statistics::Distribution lookaheadDepth;
+        /** Paths recorded in the global history when leaving a page */
+        statistics::Scalar ghrInserts;
+        /** New pages whose signature was resumed from the global history */
+        statistics::Scalar ghrHits;
+        /** Candidates dropped because they left the page */
+        statistics::Scalar pfPageCrossing;
+    } sppStats;
+
+    /**
+     * Compute the signature following a delta.
+     * @param signature The current signature
+     * @param delta The delta
+     * @return The new signature
+     */
+    uint32_t updateSignature(uint32_t signature, Delta delta) const;
+
+    /**
+     * Record a path leaving the page in the global history.
+     * @param signature Signature of the path when it left
+     * @param confidence Confidence of the path when it left
+     * @param last_block Block of the page the path left from
+     * @param delta Delta that left the page
+     */
+    void recordGlobalHistory(uint32_t signature, double confidence,
+                             unsigned last_block, Delta delta);
+
+    /**
+     * Find the most confident path of the global history that leads to
+     * a block of a new page.
+     * @param block The block of the new page
+     * @return The entry of the path, nullptr if there is none
+     */
+    const GlobalHistoryEntry *findGlobalHistory(unsigned block) const;
+
+    /**
+     * Look up, or allocate, the signature entry of the page of an access.
+     * A new page starts from a path of the global history if one leads to
+     * it, or else from an empty signature.
+     * @param page The page number
+     * @param is_secure Whether the page belongs to the secure space
+     * @param block The block of the page being accessed
+     * @param is_new Set to whether the entry was allocated
+     * @return The signature entry of the page
+     */
+    SignatureEntry &getSignatureEntry(Addr page, bool is_secure,
+                                      unsigned block, bool &is_new);
+
+    /**
+     * Count a delta following a signature in the pattern table.
+     * @param signature The signature
+     * @param delta The delta that followed it
+     */
+    void updatePatternTable(uint32_t signature, Delta delta);
+
+    /**
+     * Walk the delta paths starting at a signature and generate the
+     * confident enough prefetches.
+     * @param page_addr Address of the page
+     * @param block Block of the page the walk starts from
+     * @param signature Signature the walk starts from
+     * @param addresses Generated prefetches
+     */
+    void lookahead(Addr page_addr, unsigned block, uint32_t signature,
+                   std::vector<AddrPriority> &addresses);
+
+  public:
+    SignaturePath(const SignaturePathPrefetcherParams &p);
+
+    void calculatePrefetch(const PrefetchInfo &pfi,
+                           std::vector<AddrPriority> &addresses,
+                           const CacheAccessor &cache) override;
+
+    void setAggressiveness(double scale) override;
+};
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif // __MEM_CACHE_PREFETCH_SIGNATURE_PATH_HH__
@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/prefetch/sms.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "params/SMSPrefetcher.hh"
+
+namespace gem5
+{
+
+namespace prefetch
+{
+
+SMS::AccumulationEntry::AccumulationEntry(TagExtractor ext)
+  : TaggedEntry()
+{
+    registerTagExtractor(ext);
+    invalidate();
+}
+
+void
+SMS::AccumulationEntry::invalidate()
+{
+    TaggedEntry::invalidate();
+    region = 0;
+    pc = 0;
+    offset = 0;
+    footprint = 0;
+}
+
+SMS::AccumulationEntry *
+SMS::AccumulationTable::findVictim(const KeyType &key)
+{
+    auto candidates = localCandidates(key);
+    auto victim =
+        static_cast<AccumulationEntry*>(replPolicy->getVictim(candidates));
+
+    // The generation of the victim ends here, so learn its footprint
+    // before the entry is reused
+    if (victim->isValid()) {
+        owner.endGeneration(*victim);
+    }
+    invalidate(victim);
+    return victim;
+}
+
+SMS::PatternEntry::PatternEntry(TagExtractor ext)
+  : TaggedEntry()
+{
+    registerTagExtractor(ext);
+    invalidate();
+}
+
+void
+SMS::PatternEntry::invalidate()
+{
+    TaggedEntry::invalidate();
+    footprint = 0;
+}
+
+SMS::SMS(const SMSPrefetcherParams &p)
+  : Queued(p),
+    regionSize(p.region_size),
+    blocksPerRegion(p.region_size / p.block_size),
+    regionBlockBits(floorLog2(p.region_size / p.block_size)),
+    maxDistance(blocksPerRegion),
+    accumulationTable(*this, (name() + ".AccumulationTable").c_str(),
+                      p.accumulation_table_entries,
+                      p.accumulation_table_assoc,
+                      p.accumulation_table_replacement_policy,
+                      p.accumulation_table_indexing_policy,
+                      AccumulationEntry(genTagExtractor(
+                          p.accumulation_table_indexing_policy))),
+    patternHistoryTable((name() + ".PatternHistoryTable").c_str(),
+                        p.pattern_history_table_entries,
+                        p.pattern_history_table_assoc,
+                        p.pattern_history_table_replacement_policy,
+                        p.pattern_history_table_indexing_policy,
+                        PatternEntry(genTagExtractor(
+                            p.pattern_history_table_indexing_policy))),
+    smsStats(this, p.region_size / p.block_size)
+{
+    fatal_if(!isPowerOf2(p.region_size) || p.region_size < p.block_size,
+             "The region size must be a power of 2 of at least a block.\n");
+    fatal_if(blocksPerRegion > sizeof(Footprint) * 8,
+             "A region can have at most %d blocks.\n",
+             sizeof(Footprint) * 8);
+    fatal_if(p.region_size > p.page_bytes,
+             "A region must not be larger than a page.\n");
+}
+
+SMS::SMSStats::SMSStats(statistics::Group *parent,
+                        unsigned blocks_per_region)
+  : statistics::Group(parent, "sms"),
+    ADD_STAT(generations, statistics::units::Count::get(),
+             "Number of generations whose footprint was learnt"),
+    ADD_STAT(singleBlockGenerations, statistics::units::Count::get(),
+             "Number of generations of a single block, not learnt"),
+    ADD_STAT(patternHits, statistics::units::Count::get(),
+             "Number of trigger accesses whose footprint was known"),
+    ADD_STAT(footprintBlocks, statistics::units::Count::get(),
+             "Number of blocks of the learnt footprints")
+{
+    footprintBlocks.init(2, blocks_per_region, 1);
+}
+
+Addr
+SMS::patternKey(Addr pc, unsigned offset) const
+{
+    return (pc << regionBlockBits) | offset;
+}
+
+void
+SMS::endGeneration(AccumulationEntry &entry)
+{
+    const unsigned blocks = popCount(entry.footprint);
+    if (blocks < 2) {
+        smsStats.singleBlockGenerations++;
+        return;
+    }
+
+    const PatternEntry::KeyType key{patternKey(entry.pc, entry.offset),
+                                    entry.isSecure()};
+    PatternEntry *pattern = patternHistoryTable.findEntry(key);
+    if (pattern != nullptr) {
+        patternHistoryTable.accessEntry(pattern);
+    } else {
+        pattern = patternHistoryTable.findVictim(key);
+        patternHistoryTable.insertEntry(key, pattern);
+    }
+    pattern->footprint = entry.footprint;
+
+    smsStats.generations++;
+    smsStats.footprintBlocks.sample(blocks);
+    DPRINTF(HWPrefetch, "SMS: region %#x, trigger PC %#x offset %d, "
+            "footprint %#x\n", entry.region, entry.pc, entry.offset,
+            entry.footprint);
+}
+
+void
+SMS::calculatePrefetch(const PrefetchInfo &pfi,
+                       std::vector<AddrPriority> &addresses,
+                       const CacheAccessor &cache)
+{
+    if (!pfi.hasPC()) {
+        DPRINTF(HWPrefetch, "Ignoring request with no PC.\n");
+        return;
+    }
+
+    const Addr addr = pfi.getAddr();
+    const Addr region = addr / regionSize;
+    const unsigned offset = (addr % regionSize) >> lBlkSize;
+    const bool is_secure = pfi.isSecure();
+
+    // Accesses of a generation in progress only add to its footprint
+    const AccumulationEntry::KeyType key{region, is_secure};
+    AccumulationEntry *entry = accumulationTable.findEntry(key);
+    if (entry != nullptr) {
+        accumulationTable.accessEntry(entry);
+        entry->footprint |= Footprint(1) << offset;
+        return;
+    }
+
+    // This is a trigger access: replay the footprint it led to last time
+    const Addr pc = pfi.getPC();
+    const PatternEntry::KeyType pattern_key{patternKey(pc, offset),
+                                            is_secure};
+    PatternEntry *pattern = patternHistoryTable.findEntry(pattern_key);
+    if (pattern != nullptr) {
+        patternHistoryTable.accessEntry(pattern);
+        smsStats.patternHits++;
+        const Addr region_addr = region * regionSize;
+        for (unsigned block = 0; block < blocksPerRegion; block++) {
+            const unsigned distance =
+                block > offset ? block - offset : offset - block;
+            if (block != offset && distance <= maxDistance &&
+                bits(pattern->footprint, block)) {
+                addresses.push_back(AddrPriority(
+                    region_addr + (Addr(block) << lBlkSize), 0));
+            }
+        }
+    }
+
+    entry = accumulationTable.findVictim(key);
+    accumulationTable.insertEntry(key, entry);
+    entry->region = region;
+    entry->pc = pc;
+    entry->offset = offset;
+    entry->footprint = Footprint(1) << offset;
+}
+
+void
+SMS::setAggressiveness(double scale)
+{
+    maxDistance = std::clamp(unsigned(std::lround(blocksPerRegion * scale)),
+                             1u, blocksPerRegion);
+}
+
+void
+SMS::notifyEvict(const CacheDataUpdateProbeArg &info)
+{
+    // Evictions carry physical addresses, which only match the regions
+    // when training on physical addresses
+    if (useVirtualAddresses) {
+        return;
+    }
+
+    const Addr region = info.addr / regionSize;
+    const unsigned offset = (info.addr % regionSize) >> lBlkSize;
+    AccumulationEntry *entry =
+        accumulationTable.findEntry({region, info.isSecure});
+    if (entry != nullptr && bits(entry->footprint, offset)) {
+        endGeneration(*entry);
+        accumulationTable.invalidate(entry);
+    }
+}
+
+} // namespace prefetch
+} // namespace gem5
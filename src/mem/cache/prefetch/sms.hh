@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes a Spatial Memory Streaming (SMS) prefetcher.
+ *
+ * The prefetcher divides memory into fixed-size regions. The blocks of a
+ * region accessed during a generation, which starts with a trigger access
+ * and ends when one of those blocks is evicted, form its footprint. The
+ * footprint is learnt in a pattern history table under the PC and the
+ * region offset of the trigger access, and replayed as a whole the next
+ * time the same trigger starts a generation in any region.
+ *
+ * S. Somogyi, T. F. Wenisch, A. Ailamaki, B. Falsafi and A. Moshovos,
+ * "Spatial memory streaming", ISCA 2006.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_SMS_HH__
+#define __MEM_CACHE_PREFETCH_SMS_HH__
+
+#include <cstdint>
+#include <vector>
+
+#include "base/cache/associative_cache.hh"
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/cache/prefetch/queued.hh"
+#include "mem/cache/tags/tagged_entry.hh"
+#include "mem/packet.hh"
+
+namespace gem5
+{
+
+struct SMSPrefetcherParams;
+
+namespace prefetch
+{
+
+class SMS : public Queued
+{
+  protected:
+    /** Footprint of a region, one bit per block */
+    using Footprint = uint64_t;
+
+    /** Size of a region, in bytes */
+    const unsigned regionSize;
+
+    /** Number of blocks of a region */
+    const unsigned blocksPerRegion;
+
+    /** Number of bits of the block offset within a region */
+    const unsigned regionBlockBits;
+
+    /**
+     * Largest distance, in blocks, from the trigger of the footprint
+     * blocks that are prefetched, scaled by the feedback throttle
+     */
+    unsigned maxDistance;
+
+    /** A generation in progress */
+    struct AccumulationEntry : public TaggedEntry
+    {
+        AccumulationEntry(TagExtractor ext);
+
+        void invalidate() override;
+
+        /** Region number */
+        Addr region;
+        /** PC of the trigger access */
+        Addr pc;
+        /** Block of the region of the trigger access */
+        unsigned offset;
+        /** Blocks of the region accessed during the generation */
+        Footprint footprint;
+    };
+
+    /** Accumulation table, which ends the generation of its victims */
+    class AccumulationTable : public AssociativeCache<AccumulationEntry>
+    {
+      public:
+        AccumulationTable(SMS &owner, const char *name, size_t num_entries,
+                          size_t assoc, replacement_policy::Base *repl_policy,
+                          TaggedIndexingPolicy *indexing_policy,
+                          const AccumulationEntry &init_val)
+          : AssociativeCache<AccumulationEntry>(name, num_entries, assoc,
+                                                repl_policy, indexing_policy,
+                                                init_val),
+            owner(owner)
+        {
+        }
+
+        AccumulationEntry *findVictim(const KeyType &key) override;
+
+      private:
+        SMS &owner;
+    } accumulationTable;
+
+    /** The last footprint of a trigger */
+    struct PatternEntry : public TaggedEntry
+    {
+        PatternEntry(TagExtractor ext);
+
+        void invalidate() override;
+
+        Footprint footprint;
+    };
+    AssociativeCache<PatternEntry> patternHistoryTable;
+
+    struct SMSStats : public statistics::Group
+    {
+        SMSStats(statistics::Group *parent, unsigned blocks_per_region);
+
+        /** Generations whose footprint was learnt */
+        statistics::Scalar generations;
+        /** Generations of a single block, not learnt */
+        statistics::Scalar singleBlockGenerations;
+        /** Trigger accesses whose footprint was known */
+        statistics::Scalar patternHits;
+        /** Blocks of the learnt footprints */
+        statistics::Distribution footprintBlocks;
+    } smsStats;
+
+    /**
+     * Key of the pattern history table for a trigger access.
+     * @param pc The PC of the trigger access
+     * @param offset The block of the region of the trigger access
+     * @return The key
+     */
+    Addr patternKey(Addr pc, unsigned offset) const;
+
+    /**
+     * End a generation and learn its footprint. Generations of a single
+     * block carry no spatial pattern and are not learnt.
+     * @param entry The accumulation entry of the generation
+     */
+    void endGeneration(AccumulationEntry &entry);
+
+  public:
+    SMS(const SMSPrefetcherParams &p);
+
+    void calculatePrefetch(const PrefetchInfo &pfi,
+                           std::vector<AddrPriority> &addresses,
+                           const CacheAccessor &cache) override;
+
+    /** End the generation of the region of an evicted block */
+    void notifyEvict(const CacheDataUpdateProbeArg &info) override;
+
+    /**
+     * Only prefetch the footprint blocks closest to the trigger below the
+     * configured aggressiveness. Above it, the whole footprint already is.
+     * @param scale Aggressiveness relative to the configuration
+     */
+    void setAggressiveness(double scale) override;
+};
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif // __MEM_CACHE_PREFETCH_SMS_HH__
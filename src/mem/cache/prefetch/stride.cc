@@ -46,7 +46,9 @@
 
 #include "mem/cache/prefetch/stride.hh"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 #include "base/intmath.hh"
 #include "base/logging.hh"
@@ -79,6 +81,28 @@ Stride::StrideEntry::invalidate()
     confidence.reset();
 }
 
+void
+Stride::StrideEntry::serialize(CheckpointOut &cp) const
+{
+    TaggedEntry::serialize(cp);
+    SERIALIZE_SCALAR(lastAddr);
+    SERIALIZE_SCALAR(stride);
+    paramOut(cp, "confidence", uint8_t(confidence));
+}
+
+void
+Stride::StrideEntry::unserialize(CheckpointIn &cp)
+{
+    TaggedEntry::unserialize(cp);
+    UNSERIALIZE_SCALAR(lastAddr);
+    UNSERIALIZE_SCALAR(stride);
+    uint8_t value;
+    paramIn(cp, "confidence", value);
+    // Counters can only be moved, and saturate at 0
+    confidence -= uint8_t(confidence);
+    confidence += value;
+}
+
 Stride::Stride(const StridePrefetcherParams &p)
   : Queued(p),
     initConfidence(p.confidence_counter_bits, p.initial_confidence),
@@ -86,6 +110,7 @@ Stride::Stride(const StridePrefetcherParams &p)
     useRequestorId(p.use_requestor_id),
     degree(p.degree),
     distance(p.distance),
+    scaledDegree(degree), scaledDistance(distance),
     pcTableInfo(p.table_assoc, p.table_entries, p.table_indexing_policy,
                 p.table_replacement_policy),
     useCachelineAddr(p.use_cache_line_address)
@@ -124,6 +149,52 @@ Stride::allocateNewContext(int context)
     return *(pcTables[context]);
 }
 
+void
+Stride::serialize(CheckpointOut &cp) const
+{
+    Queued::serialize(cp);
+
+    std::vector<int> contexts;
+    for (const auto &table : pcTables) {
+        contexts.push_back(table.first);
+    }
+    std::sort(contexts.begin(), contexts.end());
+
+    Serializable::ScopedCheckpointSection sec(cp, "pcTables");
+    SERIALIZE_CONTAINER(contexts);
+    for (int context : contexts) {
+        Serializable::ScopedCheckpointSection table_sec(
+            cp, csprintf("context%d", context));
+        pcTables.at(context)->serialize(cp);
+    }
+}
+
+void
+Stride::unserialize(CheckpointIn &cp)
+{
+    Queued::unserialize(cp);
+
+    if (!cp.sectionExists(Serializable::currentSection() + ".pcTables"))
+        return;
+
+    Serializable::ScopedCheckpointSection sec(cp, "pcTables");
+    std::vector<int> contexts;
+    UNSERIALIZE_CONTAINER(contexts);
+    for (int context : contexts) {
+        Serializable::ScopedCheckpointSection table_sec(
+            cp, csprintf("context%d", context));
+        findTable(context).unserialize(cp);
+    }
+}
+
+void
+Stride::setAggressiveness(double scale)
+{
+    // The stream itself is throttled, rather than its candidates
+    scaledDegree = std::max(1, int(std::lround(degree * scale)));
+    scaledDistance = int(std::lround(distance * scale));
+}
+
 void
 Stride::calculatePrefetch(const PrefetchInfo &pfi,
                                     std::vector<AddrPriority> &addresses,
@@ -189,9 +260,9 @@ Stride::calculatePrefetch(const PrefetchInfo &pfi,
             prefetch_stride = (prefetch_stride < 0) ? -blkSize : blkSize;
         }
 
-        Addr new_addr = pf_addr + distance * prefetch_stride;
+        Addr new_addr = pf_addr + scaledDistance * prefetch_stride;
         // Generate up to degree prefetches
-        for (int d = 1; d <= degree; d++) {
+        for (int d = 1; d <= scaledDegree; d++) {
             new_addr += prefetch_stride;
             addresses.push_back(AddrPriority(new_addr, 0));
         }
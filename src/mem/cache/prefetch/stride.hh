@@ -113,6 +113,10 @@ class Stride : public Queued
      */
     const int distance;
 
+    /** Degree and distance scaled by the feedback throttle */
+    int scaledDegree;
+    int scaledDistance;
+
     /**
      * Information used to create a new PC table. All of them behave equally.
      */
@@ -140,6 +144,9 @@ class Stride : public Queued
 
         void invalidate() override;
 
+        void serialize(CheckpointOut &cp) const;
+        void unserialize(CheckpointIn &cp);
+
         Addr lastAddr;
         int stride;
         SatCounter8 confidence;
@@ -174,9 +181,14 @@ class Stride : public Queued
   public:
     Stride(const StridePrefetcherParams &p);
 
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
     void calculatePrefetch(const PrefetchInfo &pfi,
                            std::vector<AddrPriority> &addresses,
                            const CacheAccessor &cache) override;
+
+    void setAggressiveness(double scale) override;
 };
 
 } // namespace prefetch
@@ -1,8 +1,16 @@
 
 #include "mem/cache/prefetch/tdt_prefetcher.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
 #include "debug/HWPrefetch.hh"
 #include "mem/cache/replacement_policies/base.hh"
 #include "params/TDTPrefetcher.hh"
+#include "sim/system.hh"
 
 namespace gem5
 {
@@ -11,8 +19,9 @@ namespace gem5
   namespace prefetch
   {
 
-    TDTPrefetcher::TDTEntry::TDTEntry(TagExtractor ext)
-        : TaggedEntry()
+    TDTPrefetcher::TDTEntry::TDTEntry(const SatCounter8 &init_confidence,
+                                      TagExtractor ext)
+        : TaggedEntry(), confidence(init_confidence)
     {
       registerTagExtractor(ext);
       invalidate();
@@ -22,164 +31,713 @@ namespace gem5
     TDTPrefetcher::TDTEntry::invalidate()
     {
       TaggedEntry::invalidate();
+      lastAddr = 0;
+      stride = 0;
+      confidence.reset();
+    }
+
+    void
+    TDTPrefetcher::TDTEntry::serialize(CheckpointOut &cp) const
+    {
+      TaggedEntry::serialize(cp);
+      SERIALIZE_SCALAR(lastAddr);
+      SERIALIZE_SCALAR(stride);
+      paramOut(cp, "confidence", uint8_t(confidence));
+    }
+
+    void
+    TDTPrefetcher::TDTEntry::unserialize(CheckpointIn &cp)
+    {
+      TaggedEntry::unserialize(cp);
+      UNSERIALIZE_SCALAR(lastAddr);
+      UNSERIALIZE_SCALAR(stride);
+      uint8_t value;
+      paramIn(cp, "confidence", value);
+      // Counters can only be moved, and saturate at 0
+      confidence -= uint8_t(confidence);
+      confidence += value;
+    }
+
+    TDTPrefetcher::ContextState::ContextState(const std::string &name,
+        const TDTPrefetcherParams &p, const PCTableInfo &pc_table_info,
+        const SatCounter8 &init_confidence)
+        : bestOffsetPrefetcher(name + ".BO", p),
+          pcTable((name + ".PCTable").c_str(),
+                  pc_table_info.numEntries,
+                  pc_table_info.assoc,
+                  pc_table_info.replacementPolicy,
+                  pc_table_info.indexingPolicy,
+                  TDTEntry(init_confidence,
+                           genTagExtractor(pc_table_info.indexingPolicy)))
+    {
     }
 
     TDTPrefetcher::TDTPrefetcher(const TDTPrefetcherParams &params)
         : Queued(params),
-          bestOffsetPrefetcher(255, 256, 31, 20),
           pcTableInfo(params.table_assoc, params.table_entries,
                       params.table_indexing_policy,
-                      params.table_replacement_policy)
+                      params.table_replacement_policy),
+          initConfidence(params.table_confidence_counter_bits,
+                         params.table_initial_confidence),
+          threshConf(params.table_confidence_threshold / 100.0),
+          strideDegree(params.stride_degree),
+          arbiter(params.arbiter),
+          confidencePriority(params.confidence_priority),
+          issuedOffsets(params.issued_offset_entries),
+          pagePolicy(params.bo_page_policy),
+          degreeMode(params.bo_degree_mode),
+          maxDegree(params.bo_max_degree),
+          adaptiveDegree(params.bo_adaptive_degree),
+          accuracyWindow(params.bo_accuracy_window),
+          highAccuracy(params.bo_high_accuracy / 100.0),
+          lowAccuracy(params.bo_low_accuracy / 100.0),
+          offAccuracy(params.bo_off_accuracy / 100.0),
+          degree(params.bo_adaptive_degree ? 1 : params.bo_max_degree),
+          throttledOff(false),
+          throttleScale(1.0),
+          windowUseful(0),
+          windowUnused(0),
+          statsTDT(this)
+    {
+      fatal_if(issuedOffsets.empty(),
+               "At least one issued offset entry is needed\n");
+      fatal_if(maxDegree == 0, "The BO max degree must be at least 1\n");
+      fatal_if(strideDegree == 0,
+               "The stride degree must be at least 1\n");
+      fatal_if(adaptiveDegree && accuracyWindow == 0,
+               "The BO accuracy window must be at least 1\n");
+      fatal_if(offAccuracy > lowAccuracy || lowAccuracy > highAccuracy,
+               "The BO accuracy thresholds must satisfy "
+               "off <= low <= high\n");
+    }
+
+    void
+    TDTPrefetcher::regStats()
+    {
+      Queued::regStats();
+
+      // One element per hardware context of the system
+      const size_t num_contexts = std::max<size_t>(1, system->threads.size());
+      statsTDT.learningPhases
+          .init(num_contexts)
+          .flags(statistics::nozero);
+      statsTDT.pfCandidates
+          .init(num_contexts)
+          .flags(statistics::nozero);
+      statsTDT.latePrefetches
+          .init(num_contexts)
+          .flags(statistics::nozero);
+
+      // One bucket per candidate offset value
+      const std::vector<int> offsets =
+          BestOffsetPrefetcher::candidateOffsets(params());
+      const auto [min_offset, max_offset] =
+          std::minmax_element(offsets.begin(), offsets.end());
+      statsTDT.selectedOffsets
+          .init(*min_offset, *max_offset, 1)
+          .flags(statistics::pdf | statistics::nozero);
+      statsTDT.bestScore
+          .init(0, params().bo_score_max, 1)
+          .flags(statistics::pdf | statistics::nozero);
+      statsTDT.pcIssued
+          .init(0)
+          .flags(statistics::nozero);
+      statsTDT.pcUseful
+          .init(0)
+          .flags(statistics::nozero);
+    }
+
+    void
+    TDTPrefetcher::serialize(CheckpointOut &cp) const
+    {
+      Queued::serialize(cp);
+
+      Serializable::ScopedCheckpointSection sec(cp, "tdt");
+      SERIALIZE_SCALAR(degree);
+      SERIALIZE_SCALAR(throttledOff);
+
+      std::vector<ContextID> context_ids;
+      for (const auto &context : contexts)
+        context_ids.push_back(context.first);
+      std::sort(context_ids.begin(), context_ids.end());
+      SERIALIZE_CONTAINER(context_ids);
+
+      // Prefetches in flight, whose fill trains the BO learner
+      std::vector<size_t> issued_offsets;
+      for (size_t idx = 0; idx < issuedOffsets.size(); ++idx)
+      {
+        if (issuedOffsets[idx].line != MaxAddr)
+          issued_offsets.push_back(idx);
+      }
+      paramOut(cp, "num_issued_offsets", issuedOffsets.size());
+      SERIALIZE_CONTAINER(issued_offsets);
+
+      for (ContextID context : context_ids)
+      {
+        const ContextState &state = *contexts.at(context);
+        Serializable::ScopedCheckpointSection context_sec(
+            cp, csprintf("context%d", context));
+        {
+          Serializable::ScopedCheckpointSection bo_sec(cp, "bo");
+          state.bestOffsetPrefetcher.serialize(cp);
+        }
+        Serializable::ScopedCheckpointSection table_sec(cp, "pcTable");
+        state.pcTable.serialize(cp);
+      }
+
+      for (size_t idx : issued_offsets)
+      {
+        const IssuedOffset &record = issuedOffsets[idx];
+        Serializable::ScopedCheckpointSection record_sec(
+            cp, csprintf("issued%d", idx));
+        paramOut(cp, "line", record.line);
+        paramOut(cp, "context", record.context);
+        paramOut(cp, "base", record.base);
+      }
+    }
+
+    void
+    TDTPrefetcher::unserialize(CheckpointIn &cp)
     {
+      Queued::unserialize(cp);
+
+      if (!cp.sectionExists(Serializable::currentSection() + ".tdt"))
+        return;
+
+      Serializable::ScopedCheckpointSection sec(cp, "tdt");
+      unsigned saved_degree;
+      paramIn(cp, "degree", saved_degree);
+      if (adaptiveDegree)
+        degree = std::clamp(saved_degree, 1u, maxDegree);
+      UNSERIALIZE_SCALAR(throttledOff);
+
+      // The accuracy window restarts with the statistics
+      windowUseful = prefetchStats.pfUseful.value();
+      windowUnused = prefetchStats.pfUnused.value();
+
+      std::vector<ContextID> context_ids;
+      UNSERIALIZE_CONTAINER(context_ids);
+      for (ContextID context : context_ids)
+      {
+        ContextState &state = findContext(context);
+        Serializable::ScopedCheckpointSection context_sec(
+            cp, csprintf("context%d", context));
+        {
+          Serializable::ScopedCheckpointSection bo_sec(cp, "bo");
+          state.bestOffsetPrefetcher.unserialize(cp);
+        }
+        Serializable::ScopedCheckpointSection table_sec(cp, "pcTable");
+        state.pcTable.unserialize(cp);
+      }
+
+      // Records are indexed by line, so they only fit a table of the
+      // same size
+      size_t num_issued_offsets;
+      paramIn(cp, "num_issued_offsets", num_issued_offsets);
+      if (num_issued_offsets != issuedOffsets.size())
+        return;
+      std::vector<size_t> issued_offsets;
+      UNSERIALIZE_CONTAINER(issued_offsets);
+      for (size_t idx : issued_offsets)
+      {
+        fatal_if(idx >= issuedOffsets.size(),
+                 "Invalid issued offset %d in the checkpoint\n", idx);
+        IssuedOffset &record = issuedOffsets[idx];
+        Serializable::ScopedCheckpointSection record_sec(
+            cp, csprintf("issued%d", idx));
+        paramIn(cp, "line", record.line);
+        paramIn(cp, "context", record.context);
+        paramIn(cp, "base", record.base);
+      }
     }
 
-    TDTPrefetcher::PCTable &
-    TDTPrefetcher::findTable(int context)
+    TDTPrefetcher::TDTStats::TDTStats(statistics::Group *parent)
+        : statistics::Group(parent, "tdt"),
+          ADD_STAT(learningPhases, statistics::units::Count::get(),
+                   "number of BO learning phases completed per context"),
+          ADD_STAT(pfCandidates, statistics::units::Count::get(),
+                   "number of prefetch candidates generated per context"),
+          ADD_STAT(degreeIncreases, statistics::units::Count::get(),
+                   "number of accuracy windows that increased the degree"),
+          ADD_STAT(degreeDecreases, statistics::units::Count::get(),
+                   "number of accuracy windows that decreased the degree"),
+          ADD_STAT(throttledOff, statistics::units::Count::get(),
+                   "number of accuracy windows that suspended prefetching"),
+          ADD_STAT(engineChoice, statistics::units::Count::get(),
+                   "number of accesses for which each engine's candidates "
+                   "were issued"),
+          ADD_STAT(selectedOffsets, statistics::units::Count::get(),
+                   "distribution of the offsets selected by the learning "
+                   "phases"),
+          ADD_STAT(phasesScoreMax, statistics::units::Count::get(),
+                   "number of learning phases ended by an offset reaching "
+                   "the score max"),
+          ADD_STAT(phasesRoundMax, statistics::units::Count::get(),
+                   "number of learning phases ended by reaching the round "
+                   "max"),
+          ADD_STAT(bestScore, statistics::units::Count::get(),
+                   "distribution of the highest score of the learning "
+                   "phases"),
+          ADD_STAT(latePrefetches, statistics::units::Count::get(),
+                   "number of demand accesses that found a prefetch in "
+                   "flight per context"),
+          ADD_STAT(pcIssued, statistics::units::Count::get(),
+                   "number of prefetches issued per triggering PC"),
+          ADD_STAT(pcUseful, statistics::units::Count::get(),
+                   "number of prefetched lines used by a demand per "
+                   "triggering PC"),
+          ADD_STAT(pfPageDropped, statistics::units::Count::get(),
+                   "number of BO candidates dropped for crossing a "
+                   "physical page"),
+          ADD_STAT(pfPageClamped, statistics::units::Count::get(),
+                   "number of BO candidates clamped to the page of the "
+                   "access")
     {
-      auto it = pcTables.find(context);
-      if (it != pcTables.end())
+      engineChoice
+          .init(NumEngineChoices)
+          .subname(NoEngine, "none")
+          .subname(StrideEngine, "stride")
+          .subname(BOEngine, "bo")
+          .subname(BothEngines, "both");
+    }
+
+    TDTPrefetcher::ContextState &
+    TDTPrefetcher::findContext(ContextID context)
+    {
+      auto it = contexts.find(context);
+      if (it != contexts.end())
         return *(it->second);
 
       return allocateNewContext(context);
     }
 
-    TDTPrefetcher::PCTable &
-    TDTPrefetcher::allocateNewContext(int context)
+    TDTPrefetcher::ContextState &
+    TDTPrefetcher::allocateNewContext(ContextID context)
     {
-      assert(context == 0);
-      std::string table_name = name() + ".PCTable" + std::to_string(context);
-      pcTables[context].reset(new PCTable(
-          table_name.c_str(),
-          pcTableInfo.numEntries,
-          pcTableInfo.assoc,
-          pcTableInfo.replacementPolicy,
-          pcTableInfo.indexingPolicy,
-          TDTEntry(genTagExtractor(pcTableInfo.indexingPolicy))));
+      std::string context_name = name() + ".context" + std::to_string(context);
+      contexts[context].reset(
+          new ContextState(context_name, params(), pcTableInfo,
+                           initConfidence));
 
       DPRINTF(HWPrefetch, "Adding context %i with tdt4260 entries\n", context);
 
-      return *(pcTables[context]);
+      return *(contexts[context]);
     }
 
-    BestOffsetPrefetcher::BestOffsetPrefetcher(int recentRequestsSize, int offsetTableSize, int maxScore, int maxRound)
-    :     recentRequests(recentRequestsSize),
-          offsetTable(offsetTableSize),
-          maxScore(maxScore),
-          maxRound(maxRound),
-          currentRound(0),  
-          D(1)
-          
+    void
+    TDTPrefetcher::recordIssuedOffset(Addr line, ContextID context,
+                                      Addr base)
     {
-      fillOffsetTable();
+      IssuedOffset &record = issuedOffsets[line % issuedOffsets.size()];
+      record.line = line;
+      record.context = context;
+      record.base = base;
+    }
+
+    bool
+    TDTPrefetcher::physicalLine(const PrefetchInfo &pfi, Addr pf_addr,
+                                Addr &pf_line) const
+    {
+      if (!useVirtualAddresses)
+      {
+        pf_line = blockIndex(pf_addr);
+        return true;
+      }
+
+      // Within the page of the access, the candidate is as far from the
+      // physical address of the access as from its virtual address
+      if (!samePage(pf_addr, pfi.getAddr()))
+        return false;
+      pf_line = blockIndex(pfi.getPaddr() + (pf_addr - pfi.getAddr()));
+      return true;
+    }
+
+    bool
+    TDTPrefetcher::takeIssuedOffset(Addr line, IssuedOffset &record)
+    {
+      IssuedOffset &slot = issuedOffsets[line % issuedOffsets.size()];
+      if (slot.line != line)
+      {
+        return false;
+      }
+      record = slot;
+      slot.line = MaxAddr;
+      return true;
+    }
+
+    bool
+    TDTPrefetcher::takeIssuedPrefetch(Addr addr, bool is_secure,
+                                      IssuedPrefetch &prefetch)
+    {
+      auto it = issuedPrefetches.find(blockAddress(addr));
+      if (it == issuedPrefetches.end() || it->second.secure != is_secure)
+      {
+        return false;
+      }
+      prefetch = it->second;
+      issuedPrefetches.erase(it);
+      return true;
     }
 
     void
-    TDTPrefetcher::notifyFill(const CacheAccessProbeArg &arg)
+    TDTPrefetcher::notifyPrefetchIssued(const PrefetchInfo &pfi,
+                                        const PacketPtr &pkt)
     {
-      // A cache line has been filled in
-      bestOffsetPrefetcher.addRecentRequest(arg.pkt->getAddr() - (bestOffsetPrefetcher.D * blkSize));
-      // What if the current best offset (D) has changed while the cache fill was loading? Then the D would be wrong
+      const Addr pc = pfi.hasPC() ? pfi.getPC() : 0;
+      statsTDT.pcIssued.sample(pc);
+      issuedPrefetches[blockAddress(pkt->getAddr())] = IssuedPrefetch{
+          learningContext(pfi.getContextId()), pc, pkt->isSecure()};
     }
 
     void
-    BestOffsetPrefetcher::fillOffsetTable()
-    {
-    /*   for (int i = 1; i <= 256; ++i)
-      {
-        int num = i;
-        while (num % 2 == 0)
-          num /= 2;
-        while (num % 3 == 0)
-          num /= 3;
-        while (num % 5 == 0)
-          num /= 5;
-        if (num == 1)
+    TDTPrefetcher::notifyPrefetchLate(Addr addr, bool is_secure)
+    {
+      IssuedPrefetch prefetch;
+      if (takeIssuedPrefetch(addr, is_secure, prefetch) &&
+          prefetch.context < statsTDT.latePrefetches.size())
+      {
+        statsTDT.latePrefetches[prefetch.context]++;
+      }
+    }
+
+    void
+    TDTPrefetcher::notifyPrefetchUseful(Addr addr, bool is_secure)
+    {
+      Queued::notifyPrefetchUseful(addr, is_secure);
+
+      IssuedPrefetch prefetch;
+      if (takeIssuedPrefetch(addr, is_secure, prefetch))
+        statsTDT.pcUseful.sample(prefetch.pc);
+    }
+
+    void
+    TDTPrefetcher::notifyEvict(const CacheDataUpdateProbeArg &info)
+    {
+      // The block, prefetched or not, can no longer be used
+      IssuedPrefetch prefetch;
+      takeIssuedPrefetch(info.addr, info.isSecure, prefetch);
+    }
+
+    void
+    TDTPrefetcher::updateDegree()
+    {
+      const statistics::Counter useful = prefetchStats.pfUseful.value();
+      const statistics::Counter unused = prefetchStats.pfUnused.value();
+      if (useful < windowUseful || unused < windowUnused)
+      {
+        // The statistics were reset, start a new window
+        windowUseful = useful;
+        windowUnused = unused;
+        return;
+      }
+
+      const statistics::Counter window_useful = useful - windowUseful;
+      const statistics::Counter outcomes =
+          window_useful + (unused - windowUnused);
+      if (outcomes < accuracyWindow)
+        return;
+
+      const double accuracy = window_useful / outcomes;
+      windowUseful = useful;
+      windowUnused = unused;
+
+      if (accuracy >= highAccuracy)
+      {
+        if (degree < maxDegree)
         {
-          offsetTable[i] = 0;
+          degree++;
+          statsTDT.degreeIncreases++;
         }
-      } */
-     std::vector<int> offsets = {1,2,3,4,5,6,8,9,10,12,15,16,18,20,24,25,27,30,32,36,40,45,48,50,54,60,64,72,75,80,81,90,96,100,108,120,125,128,135,144,150,160,162,180,192,200,216,225,240,243,250,256};
-     for (int offset : offsets)
-     {
-         offsetTable[offset] = 0;
-     }
+      }
+      else if (accuracy < lowAccuracy)
+      {
+        if (degree > 1)
+        {
+          degree--;
+          statsTDT.degreeDecreases++;
+        }
+        else if (accuracy < offAccuracy && !throttledOff)
+        {
+          throttledOff = true;
+          statsTDT.throttledOff++;
+        }
+      }
+
+      DPRINTF(HWPrefetch, "Accuracy %f over %.0f outcomes, degree %d%s\n",
+              accuracy, outcomes, degree, throttledOff ? " (off)" : "");
+    }
+
+    BestOffsetPrefetcher::RREntry::RREntry(TagExtractor ext)
+        : TaggedEntry()
+    {
+      registerTagExtractor(ext);
+      invalidate();
     }
-     
-    uint32_t 
-    BestOffsetPrefetcher::computeRRTableIndex(Addr address)
+
+    BestOffsetPrefetcher::BestOffsetPrefetcher(const std::string &name,
+                                               const TDTPrefetcherParams &p)
+    :     recentRequests((name + ".RRTable").c_str(),
+                         p.rr_entries,
+                         p.rr_assoc,
+                         p.rr_replacement_policy,
+                         p.rr_indexing_policy,
+                         RREntry(genTagExtractor(p.rr_indexing_policy))),
+          offsetList(candidateOffsets(p)),
+          maxScore(p.bo_score_max),
+          maxRound(p.bo_round_max),
+          badScore(p.bo_bad_score),
+          currentRound(0),
+          nextOffset(0),
+          batchWidth(p.bo_batch_width),
+          samePageOnly(!p.use_virtual_addresses),
+          pageLineBits(floorLog2(p.page_bytes / p.block_size)),
+          D(1),
+          prefetchOn(true),
+          lastBestScore(0),
+          maxTopOffsets(p.bo_max_degree),
+          topOffsets{1}
     {
-      // For a 256-entry RR table, we need 8 bits for the index
-      // Extract the 8 least significant line address bits
-      uint32_t lowerBits = (address >> 6) & 0xFF; // Bits 6-13
+      fatal_if(offsetList.empty() || offsetList.size() > MaxOffsets,
+               "The BO learner needs between 1 and %d candidate offsets, "
+               "got %d\n", MaxOffsets, offsetList.size());
+      fatal_if(std::find(offsetList.begin(), offsetList.end(), 0) !=
+               offsetList.end(), "0 is not a valid BO offset\n");
+      fatal_if(batchWidth == 0 || batchWidth > offsetList.size(),
+               "The BO batch width must be between 1 and %d\n",
+               offsetList.size());
+      fatal_if(maxScore == 0 || maxScore > UINT8_MAX,
+               "The BO score max must fit in the 8-bit score array\n");
+      fatal_if(maxRound == 0, "The BO round max must be at least 1\n");
+      fatal_if(badScore >= maxScore,
+               "The BO bad score must be lower than the score max\n");
+      fatal_if(!isPowerOf2(p.page_bytes / p.block_size),
+               "The BO learner needs a power of 2 number of lines per "
+               "page\n");
+      resetScores();
+    }
 
-      // Extract the next 8 bits
-      uint32_t upperBits = (address >> 14) & 0xFF; // Bits 14-21
+    std::vector<int>
+    BestOffsetPrefetcher::generateOffsets(TDTOffsetSet offset_set,
+                                          int max_offset, bool negative)
+    {
+      std::vector<int> offsets;
+      for (int i = 1; i <= max_offset; ++i)
+      {
+        bool candidate = false;
+        switch (offset_set)
+        {
+          case TDTOffsetSet::smooth:
+          {
+            // Offsets whose only prime factors are 2, 3 and 5
+            int num = i;
+            for (int factor : {2, 3, 5})
+            {
+              while (num % factor == 0)
+                num /= factor;
+            }
+            candidate = (num == 1);
+            break;
+          }
+          case TDTOffsetSet::powers_of_two:
+            candidate = isPowerOf2(i);
+            break;
+          case TDTOffsetSet::all:
+            candidate = true;
+            break;
+          default:
+            panic("Unknown BO offset set\n");
+        }
 
-      // XOR the two sets of bits to get the index
-      return lowerBits ^ upperBits;
+        if (candidate)
+        {
+          offsets.push_back(i);
+          if (negative)
+            offsets.push_back(-i);
+        }
+      }
+      return offsets;
     }
-    // Function to extract the 12-bit tag
-    uint32_t 
-    BestOffsetPrefetcher::extractTag(Addr address)
+
+    std::vector<int>
+    BestOffsetPrefetcher::candidateOffsets(const TDTPrefetcherParams &p)
     {
-      // Skip the 8 least significant line address bits
-      // Extract the next 12 bits
-      return (address >> 14) & 0xFFF; // Bits 14-25
+      if (!p.bo_offsets.empty())
+        return p.bo_offsets;
+      return generateOffsets(p.bo_offset_set, p.bo_max_offset,
+                             p.bo_negative_offsets);
     }
 
     void
-    BestOffsetPrefetcher::addRecentRequest(Addr address)
+    TDTPrefetcher::notifyFill(const CacheAccessProbeArg &arg)
     {
-      //We're supposed to just put the tag in the RR, but leaving it for now.
-      uint32_t index = computeRRTableIndex(address);
-      recentRequests[index] = address;
+      // A cache line has been filled in. The base address of a BO prefetch
+      // is the access that triggered it, as the offset that prefetched it
+      // may no longer be D, and goes to the context that generated it.
+      const Addr line = blockIndex(arg.pkt->getAddr());
+      IssuedOffset record;
+      if (takeIssuedOffset(line, record))
+      {
+        findContext(record.context).bestOffsetPrefetcher.addRecentRequest(
+            record.base, arg.pkt->isSecure());
+        return;
+      }
+
+      // Demand fill, or a prefetch whose record was lost
+      const RequestPtr &req = arg.pkt->req;
+      Addr learning_line = line;
+      if (useVirtualAddresses)
+      {
+        // Prefetch requests only carry their physical address
+        if (!req->hasVaddr())
+          return;
+        learning_line = blockIndex(req->getVaddr());
+      }
+
+      const ContextID context = learningContext(
+          req->hasContextId() ? req->contextId() : InvalidContextID);
+      BestOffsetPrefetcher &bo = findContext(context).bestOffsetPrefetcher;
+      bo.addRecentRequest(learning_line - bo.getFillOffset(),
+                          arg.pkt->isSecure());
     }
 
     void
-    BestOffsetPrefetcher::testRecentRequest(Addr addrRequest, int testOffset, int blkSize)
+    BestOffsetPrefetcher::serialize(CheckpointOut &cp) const
     {
-      Addr testAddress = addrRequest - (testOffset * blkSize); // X -d
-      uint32_t index = computeRRTableIndex(testAddress);
+      arrayParamOut(cp, "offsets", offsetList);
+      arrayParamOut(cp, "scores", scores.data(), offsetList.size());
+      SERIALIZE_SCALAR(currentRound);
+      SERIALIZE_SCALAR(nextOffset);
+      SERIALIZE_SCALAR(D);
+      SERIALIZE_SCALAR(prefetchOn);
+      SERIALIZE_SCALAR(lastBestScore);
+      SERIALIZE_CONTAINER(topOffsets);
+
+      Serializable::ScopedCheckpointSection sec(cp, "rr");
+      recentRequests.serialize(cp);
+    }
 
-      // Check if the entry at this index matches the test address
-      if (recentRequests[index] == testAddress)
+    void
+    BestOffsetPrefetcher::unserialize(CheckpointIn &cp)
+    {
+      // Scores are indexed like the offset list
+      std::vector<int> offsets;
+      UNSERIALIZE_CONTAINER(offsets);
+      if (offsets != offsetList)
       {
-        offsetTable[testOffset]++;
-        if (offsetTable[testOffset] == maxScore)
-        {
-          endLearningRound(testOffset);
-        }
+        warn("%s: the checkpoint was taken with other candidate offsets, "
+             "not restoring the BO learner\n", recentRequests.name());
+        return;
       }
+
+      arrayParamIn(cp, "scores", scores.data(), offsetList.size());
+      UNSERIALIZE_SCALAR(currentRound);
+      UNSERIALIZE_SCALAR(nextOffset);
+      UNSERIALIZE_SCALAR(D);
+      UNSERIALIZE_SCALAR(prefetchOn);
+      UNSERIALIZE_SCALAR(lastBestScore);
+      UNSERIALIZE_CONTAINER(topOffsets);
+      if (topOffsets.size() > maxTopOffsets)
+        topOffsets.resize(maxTopOffsets);
+
+      Serializable::ScopedCheckpointSection sec(cp, "rr");
+      recentRequests.unserialize(cp);
+    }
+
+    void
+    BestOffsetPrefetcher::resetScores()
+    {
+      scores.fill(0);
     }
 
     void
-    BestOffsetPrefetcher::endLearningRound(int newBestoffset)
+    BestOffsetPrefetcher::addRecentRequest(Addr line, bool is_secure)
+    {
+      const RREntry::KeyType key{line, is_secure};
+      RREntry *entry = recentRequests.findEntry(key);
+      if (entry != nullptr)
+      {
+        recentRequests.accessEntry(entry);
+        return;
+      }
+
+      RREntry *victim = recentRequests.findVictim(key);
+      recentRequests.insertEntry(key, victim);
+    }
+
+    BestOffsetPrefetcher::PhaseEnd
+    BestOffsetPrefetcher::testOffsets(Addr line, bool is_secure)
     {
-      // if newBestOffset is 0, roundMax was reached
-      if (newBestoffset == 0)
+      const size_t first = nextOffset;
+      const size_t last = std::min(first + batchWidth, offsetList.size());
+
+      // Score the whole batch first, keeping the increment branch-free,
+      // and only then look for an offset that ended the phase
+      for (size_t i = first; i < last; ++i)
       {
-        int highestValue = 0;
-        int bestOffset = 0;
+        const RREntry::KeyType key{line - offsetList[i], is_secure}; // X -d
+        const bool same_page = ((key.address ^ line) >> pageLineBits) == 0;
+        scores[i] += (!samePageOnly || same_page) &&
+                     recentRequests.findEntry(key) != nullptr;
+      }
 
-        for (auto &i : offsetTable)
+      // The first offset of the batch to reach maxScore wins the phase
+      for (size_t i = first; i < last; ++i)
+      {
+        if (scores[i] >= maxScore)
         {
-          if (i.second > highestValue)
-          {
-            bestOffset = i.first;
-            highestValue = i.second;
-          }
+          endLearningPhase();
+          return PhaseEnd::ScoreMax;
         }
+      }
 
-        newBestoffset = bestOffset;
+      nextOffset = last;
+      if (nextOffset == offsetList.size())
+      {
+        nextOffset = 0;
+        if (++currentRound == maxRound)
+        {
+          endLearningPhase();
+          return PhaseEnd::RoundMax;
+        }
       }
-      D = newBestoffset;
+      return PhaseEnd::None;
+    }
+
+    void
+    BestOffsetPrefetcher::endLearningPhase()
+    {
+      // Rank the offsets by decreasing score. Ties keep the order of the
+      // offset list, so the first offset with the highest score wins. When
+      // the phase ends by reaching maxScore, that is the offset that
+      // reached it.
+      std::vector<size_t> ranking(offsetList.size());
+      for (size_t i = 0; i < ranking.size(); ++i)
+        ranking[i] = i;
+      const size_t num_ranked = std::min(maxTopOffsets, ranking.size());
+      std::partial_sort(ranking.begin(), ranking.begin() + num_ranked,
+                        ranking.end(), [this](size_t a, size_t b)
+                        { return scores[a] > scores[b] ||
+                                 (scores[a] == scores[b] && a < b); });
 
-      // reset offsTable
-      for (auto &i : offsetTable)
+      lastBestScore = scores[ranking[0]];
+      prefetchOn = lastBestScore > badScore;
+      if (prefetchOn)
       {
-        i.second = 0;
+        // Only offsets that scored are worth prefetching with. Without
+        // any, D is 0, as in the original learner.
+        const int min_score = std::max(badScore, 0);
+        topOffsets.clear();
+        for (size_t i = 0; i < num_ranked && scores[ranking[i]] > min_score;
+             ++i)
+        {
+          topOffsets.push_back(offsetList[ranking[i]]);
+        }
+        D = topOffsets.empty() ? 0 : topOffsets.front();
       }
+
+      resetScores();
       currentRound = 0;
+      nextOffset = 0;
     }
 
     void
@@ -196,63 +754,256 @@ namespace gem5
       // access_addr is the memory address (of the cache line) requested
       Addr access_addr = pfi.getAddr();
 
-      // test one offset from the offset table, iterating each time calculatePrefetech is called
-      static auto it = bestOffsetPrefetcher.offsetTable.begin();
-      if (it != bestOffsetPrefetcher.offsetTable.end())
+      // The BO learner works on line addresses
+      Addr access_line = blockIndex(access_addr);
+
+      // Every hardware context trains its own learner and PC table
+      const ContextID context = learningContext(pfi.getContextId());
+      ContextState &state = findContext(context);
+      BestOffsetPrefetcher &bestOffsetPrefetcher = state.bestOffsetPrefetcher;
+
+      // test the next batch of offsets from the offset list
+      const BestOffsetPrefetcher::PhaseEnd phase_end =
+          bestOffsetPrefetcher.testOffsets(access_line, pfi.isSecure());
+      if (phase_end != BestOffsetPrefetcher::PhaseEnd::None)
       {
-        bestOffsetPrefetcher.testRecentRequest(access_addr, it->first,blkSize);
-        ++it;
+        recordPhaseEnd(bestOffsetPrefetcher, phase_end, context);
+
+        // A new offset gets a chance even if the throttle suspended the
+        // previous one
+        if (bestOffsetPrefetcher.isPrefetchOn())
+          throttledOff = false;
       }
-      else
+
+      if (adaptiveDegree)
+        updateDegree();
+
+      // Both engines train on every access, then the arbiter decides
+      // whose candidates are issued
+      std::vector<AddrPriority> stride_candidates;
+      calculateStrideCandidates(state.pcTable, pfi, stride_candidates);
+
+      std::vector<AddrPriority> bo_candidates;
+      calculateBOCandidates(bestOffsetPrefetcher, access_addr,
+                            bo_candidates);
+
+      EngineChoice choice = NoEngine;
+      switch (arbiter)
       {
-        it = bestOffsetPrefetcher.offsetTable.begin();
-        bestOffsetPrefetcher.currentRound++;
-        bestOffsetPrefetcher.testRecentRequest(access_addr, it->first,blkSize);
-        ++it;
+        case TDTArbiter::stride_first:
+          // A confident PC-local stride is more precise than the global
+          // offset, which covers the PCs without one
+          if (!stride_candidates.empty())
+            choice = StrideEngine;
+          else if (!bo_candidates.empty())
+            choice = BOEngine;
+          break;
+        case TDTArbiter::bo_first:
+          if (!bo_candidates.empty())
+            choice = BOEngine;
+          else if (!stride_candidates.empty())
+            choice = StrideEngine;
+          break;
+        case TDTArbiter::both:
+          if (!stride_candidates.empty() && !bo_candidates.empty())
+            choice = BothEngines;
+          else if (!stride_candidates.empty())
+            choice = StrideEngine;
+          else if (!bo_candidates.empty())
+            choice = BOEngine;
+          break;
+        case TDTArbiter::bo_only:
+          if (!bo_candidates.empty())
+            choice = BOEngine;
+          break;
+        default:
+          panic("Unknown TDT arbiter\n");
       }
+      statsTDT.engineChoice[choice]++;
 
-      // access pc is the pc of the inst that requests the cache line
-      Addr access_pc = pfi.getPC();
+      if (choice == StrideEngine || choice == BothEngines)
+      {
+        addresses.insert(addresses.end(), stride_candidates.begin(),
+                         stride_candidates.end());
+      }
+      if (choice == BOEngine || choice == BothEngines)
+      {
+        // Only issued BO candidates keep their offset until the fill,
+        // and functional warming drops all of them
+        for (const AddrPriority &candidate : bo_candidates)
+        {
+          Addr pf_line;
+          if (!warming && physicalLine(pfi, candidate.first, pf_line))
+          {
+            recordIssuedOffset(pf_line, context, access_line);
+          }
+        }
+        addresses.insert(addresses.end(), bo_candidates.begin(),
+                         bo_candidates.end());
+      }
+
+      if (context < statsTDT.pfCandidates.size())
+      {
+        statsTDT.pfCandidates[context] += addresses.size();
+      }
+    }
+
+    void
+    TDTPrefetcher::recordPhaseEnd(const BestOffsetPrefetcher &bo,
+                                  BestOffsetPrefetcher::PhaseEnd end,
+                                  ContextID context)
+    {
+      if (context < statsTDT.learningPhases.size())
+        statsTDT.learningPhases[context]++;
 
-      // context can be ignored
-      int context = 0;
+      if (end == BestOffsetPrefetcher::PhaseEnd::ScoreMax)
+        statsTDT.phasesScoreMax++;
+      else
+        statsTDT.phasesRoundMax++;
+
+      statsTDT.bestScore.sample(bo.getLastBestScore());
+      if (bo.isPrefetchOn())
+        statsTDT.selectedOffsets.sample(bo.getBestOffset());
+
+      DPRINTF(HWPrefetch, "Context %d ended a learning phase by %s, best "
+              "score %d, offset %d%s\n", context,
+              end == BestOffsetPrefetcher::PhaseEnd::ScoreMax ?
+              "score max" : "round max", bo.getLastBestScore(),
+              bo.getBestOffset(), bo.isPrefetchOn() ? "" : " (off)");
+    }
 
-      // Currently implemented prefetching algorithm: Next line prefetching
-      // TODO: Implement something better!
-      addresses.push_back(AddrPriority(access_addr + (bestOffsetPrefetcher.D * blkSize), 0));
+    unsigned
+    TDTPrefetcher::scaledDegree(unsigned num) const
+    {
+      return std::lround(num * throttleScale);
+    }
 
-      if (bestOffsetPrefetcher.currentRound == bestOffsetPrefetcher.maxRound)
+    void
+    TDTPrefetcher::setAggressiveness(double scale)
+    {
+      // The engines are throttled, rather than their candidates
+      throttleScale = scale;
+    }
+
+    void
+    TDTPrefetcher::calculateBOCandidates(const BestOffsetPrefetcher &bo,
+        Addr access_addr, std::vector<AddrPriority> &candidates)
+    {
+      const Addr access_line = blockIndex(access_addr);
+      if (!bo.isPrefetchOn() || throttledOff)
+        return;
+
+      // Candidate offsets, best first
+      const std::vector<int> &top = bo.getTopOffsets();
+      unsigned num_candidates = scaledDegree(1);
+      if (degreeMode == TDTDegreeMode::top_offsets)
+        num_candidates = std::min<size_t>(scaledDegree(degree), top.size());
+      else if (degreeMode == TDTDegreeMode::multiples &&
+               bo.getBestOffset() != 0)
+        num_candidates = scaledDegree(degree);
+
+      // The score of D in the last phase tells how often it was timely
+      const int32_t priority = confidencePriority ?
+          std::min(bo.getLastBestScore(), bo.maxScore) * 100 / bo.maxScore :
+          0;
+
+      for (unsigned i = 0; i < num_candidates; ++i)
       {
-        bestOffsetPrefetcher.endLearningRound(0);
+        const int offset = degreeMode == TDTDegreeMode::top_offsets ?
+            top[i] : bo.getBestOffset() * int(i + 1);
+        Addr pf_addr = (access_line + offset) << lBlkSize;
+
+        // Virtual candidates crossing a page are translated by the queue,
+        // but consecutive physical pages are unrelated
+        if (!useVirtualAddresses && !samePage(pf_addr, access_addr))
+        {
+          if (pagePolicy == TDTPagePolicy::drop)
+          {
+            statsTDT.pfPageDropped++;
+            continue;
+          }
+          if (pagePolicy == TDTPagePolicy::clamp)
+          {
+            // Closest line of the page in the direction of the offset
+            statsTDT.pfPageClamped++;
+            pf_addr = offset > 0 ?
+                pageAddress(access_addr) + pageBytes - blkSize :
+                pageAddress(access_addr);
+            if (pf_addr == blockAddress(access_addr) ||
+                std::find_if(candidates.begin(), candidates.end(),
+                             [pf_addr](const AddrPriority &c)
+                             { return c.first == pf_addr; }) !=
+                candidates.end())
+            {
+              continue;
+            }
+          }
+          // TDTPagePolicy::translate: the queue translates the candidate
+          // through the virtual address of the access, if it has one
+        }
+
+        candidates.push_back(AddrPriority(pf_addr, priority));
       }
+    }
 
-      // Can safely be ignored
-      // Get matching storage of entries
-      // Context is 0 due to single-threaded application
-      PCTable &pcTable = findTable(context);
+    void
+    TDTPrefetcher::calculateStrideCandidates(PCTable &pc_table,
+        const PrefetchInfo &pfi, std::vector<AddrPriority> &candidates)
+    {
+      const Addr access_addr = pfi.getAddr();
+      const TDTEntry::KeyType key{pfi.getPC(), pfi.isSecure()};
+      TDTEntry *entry = pc_table.findEntry(key);
 
-      // Get matching entry for your given PC from the PC Table
-      const TDTEntry::KeyType key{access_pc, false};
-      TDTEntry *entry = pcTable.findEntry(key);
+      if (entry == nullptr)
+      {
+        // First access of this PC, nothing to predict yet
+        TDTEntry *victim = pc_table.findVictim(key);
+        victim->lastAddr = access_addr;
+        pc_table.insertEntry(key, victim);
+        return;
+      }
 
-      // Check if you have entry
-      if (entry != nullptr)
+      pc_table.accessEntry(entry);
+
+      const int new_stride = access_addr - entry->lastAddr;
+      if (new_stride == 0)
       {
-        // There is an entry for this PC
-        // You might want to update information for this entry
+        // Repeated access to the same address
+        return;
+      }
+
+      if (new_stride == entry->stride)
+      {
+        entry->confidence++;
       }
       else
       {
-        // No entry for this PC
-        // You might want to make an entry for this PC
+        entry->confidence--;
+        // Train a new stride once the old one is no longer trusted
+        if (entry->confidence.calcSaturation() < threshConf)
+          entry->stride = new_stride;
       }
+      entry->lastAddr = access_addr;
+
+      if (entry->confidence.calcSaturation() < threshConf)
+        return;
 
-      // The following show you how to add an entry to PCTable for a PC
-      // All slots are by default taken, you must replace a previous slot with new data
-      // Find replacement victim for your new data, update information
-      TDTEntry *victim = pcTable.findVictim(key);
-      victim->lastAddr = access_addr;
-      pcTable.insertEntry(key, victim);
+      // Strides shorter than a line still move on to the next line
+      const int blk_size = blkSize;
+      int prefetch_stride = entry->stride;
+      if (std::abs(prefetch_stride) < blk_size)
+        prefetch_stride = prefetch_stride < 0 ? -blk_size : blk_size;
+
+      const int32_t priority = confidencePriority ?
+          entry->confidence.calcSaturation() * 100 : 0;
+
+      Addr pf_addr = access_addr;
+      const unsigned stride_degree = scaledDegree(strideDegree);
+      for (unsigned d = 0; d < stride_degree; ++d)
+      {
+        pf_addr += prefetch_stride;
+        candidates.push_back(AddrPriority(pf_addr, priority));
+      }
     }
 
     uint32_t
@@ -270,5 +1021,27 @@ namespace gem5
       return addr;
     }
 
+    TDTPrefetcherRRHashedSetAssociative::TDTPrefetcherRRHashedSetAssociative(
+        const TDTPrefetcherRRHashedSetAssociativeParams &p)
+        : TaggedSetAssociative(p), tagMask(mask(p.tag_bits))
+    {
+      fatal_if(p.tag_bits == 0, "The RR table needs at least one tag bit\n");
+    }
+
+    uint32_t
+    TDTPrefetcherRRHashedSetAssociative::extractSet(const KeyType &key) const
+    {
+      // XOR the lowest set-index-sized slice of the line address with the
+      // slice right above it
+      const Addr line = key.address >> setShift;
+      return (line ^ (line >> (tagShift - setShift))) & setMask;
+    }
+
+    Addr
+    TDTPrefetcherRRHashedSetAssociative::extractTag(const Addr addr) const
+    {
+      return (addr >> tagShift) & tagMask;
+    }
+
   } // namespace prefetch
 } // namespace gem5
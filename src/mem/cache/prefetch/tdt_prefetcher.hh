@@ -1,6 +1,8 @@
 #ifndef __MEM_CACHE_PREFETCH_TDT_PREFETCHER_HH__
 #define __MEM_CACHE_PREFETCH_TDT_PREFETCHER_HH__
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -8,12 +10,17 @@
 #include "base/cache/associative_cache.hh"
 #include "base/sat_counter.hh"
 #include "base/types.hh"
+#include "enums/TDTArbiter.hh"
+#include "enums/TDTDegreeMode.hh"
+#include "enums/TDTOffsetSet.hh"
+#include "enums/TDTPagePolicy.hh"
 #include "mem/cache/prefetch/queued.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/indexing_policies/set_associative.hh"
 #include "mem/cache/tags/tagged_entry.hh"
 #include "mem/packet.hh"
 #include "params/TDTPrefetcherHashedSetAssociative.hh"
+#include "params/TDTPrefetcherRRHashedSetAssociative.hh"
 
 namespace gem5
 {
@@ -36,31 +43,161 @@ namespace prefetch
 //Here we will create a class that will be used to include Recent requests table
 class BestOffsetPrefetcher
 {
+public:
+    /** Maximum number of candidate offsets evaluated by the learner */
+    static constexpr size_t MaxOffsets = 512;
+
+    /**
+     * Generate a list of candidate offsets, ordered by increasing
+     * magnitude, with each negative offset right after its positive
+     * counterpart.
+     * @param offset_set Which offsets of [1, max_offset] are candidates
+     * @param max_offset Largest offset magnitude
+     * @param negative Whether negative offsets are candidates too
+     * @return The list of candidates
+     */
+    static std::vector<int> generateOffsets(TDTOffsetSet offset_set,
+                                            int max_offset, bool negative);
+
+    /**
+     * Candidate offsets of a learner: the explicit list of the
+     * parameters, or the generated one if it is empty.
+     */
+    static std::vector<int> candidateOffsets(const TDTPrefetcherParams &p);
+
+    /** How a call to testOffsets ended */
+    enum class PhaseEnd
+    {
+        None,
+        ScoreMax,
+        RoundMax
+    };
+
+    /** An entry of the Recent Requests table, tagged by line address */
+    struct RREntry : public TaggedEntry
+    {
+        RREntry(TagExtractor ext);
+    };
+    using RRTable = AssociativeCache<RREntry>;
+
 private:
-    Addr addr; // If this is needed
-    
-    std::vector<Addr> recentRequests;
-    std::unordered_map<int, int> offsetTable; // offset, score
-    int offsetTableSize;
-    int recentRequestsSize; 
+    /**
+     * Base line addresses (Y - D) of recently completed fills. Entries
+     * only hold the partial tag extracted by the indexing policy.
+     */
+    RRTable recentRequests;
+
+    /**
+     * Candidate offsets. The position of an offset in this list is also
+     * its index in the score array.
+     */
+    const std::vector<int> offsetList;
+
+    /**
+     * Score of each candidate, indexed like offsetList. Contiguous and
+     * cache-line aligned, so the default 52 offsets fit in a single line.
+     */
+    alignas(64) std::array<uint8_t, MaxOffsets> scores;
+
     int maxScore;
     int maxRound;
+
+    /**
+     * A learning phase whose best score does not exceed this value turns
+     * prefetching off until a later phase finds a better offset. If
+     * negative, prefetching stays on, with D = 0 after a phase in which
+     * no offset scored.
+     */
+    const int badScore;
+
     int currentRound;
+
+    /** Index in offsetList of the next offset to be tested */
+    size_t nextOffset;
+
+    /** Number of offsets tested against the RR table on every access */
+    const size_t batchWidth;
+
+    /**
+     * Only score the offsets whose base address is in the page of the
+     * access. Set when learning on physical addresses, as consecutive
+     * physical pages are unrelated.
+     */
+    const bool samePageOnly;
+
+    /** Log2 of the number of lines in a page */
+    const unsigned pageLineBits;
+
     int D;
 
+    /** Whether the last learning phase found an offset worth using */
+    bool prefetchOn;
+
+    /** Highest score of the last learning phase */
+    int lastBestScore;
+
+    /** Maximum number of offsets kept in topOffsets */
+    const size_t maxTopOffsets;
+
+    /**
+     * Offsets of the last learning phase scoring above badScore, and
+     * above 0, by decreasing score. The first one is D, if any.
+     */
+    std::vector<int> topOffsets;
+
 public:
-    
-    BestOffsetPrefetcher(int recentRequestsSize, int offsetTableSize, int maxScore, int maxRound);
-    
-    void fillOffsetTable();
-    void addRecentRequest(Addr addr);
-    void testRecentRequest(Addr addrRequest, int testOffset, int blkSize);
-    uint32_t computeRRTableIndex(Addr address);
-    uint32_t extractTag(Addr address);
-    //void updateOffsetScore(int offset, int score);
-    void endLearningRound(int newBestoffset);
+
+    BestOffsetPrefetcher(const std::string &name,
+                         const TDTPrefetcherParams &p);
+
+    /**
+     * Checkpoint the learning state: the RR table, the scores of the
+     * current phase and the offsets selected by the last one.
+     */
+    void serialize(CheckpointOut &cp) const;
+
+    /**
+     * Restore the learning state. A checkpoint taken with other
+     * candidate offsets is ignored, and the learner starts cold.
+     */
+    void unserialize(CheckpointIn &cp);
+
+    void resetScores();
+
+    /**
+     * Insert a base line address in the RR table.
+     * @param line Line address of the fill minus the offset that fetched it
+     * @param is_secure Whether the address belongs to the secure space
+     */
+    void addRecentRequest(Addr line, bool is_secure);
+
+    /**
+     * Test the next batchWidth offsets of the current round against the
+     * RR table, ending the learning phase when an offset reaches maxScore
+     * or when maxRound rounds have been completed.
+     * @param line Line address of the triggering access
+     * @param is_secure Whether the address belongs to the secure space
+     * @return Whether, and how, this test ended a learning phase
+     */
+    PhaseEnd testOffsets(Addr line, bool is_secure);
+
+    /**
+     * Select the highest scoring offset as the new D, or turn prefetching
+     * off if its score is not above badScore, and start a new phase.
+     */
+    void endLearningPhase();
     int getBestOffset() const { return D; }
-    // void printOffsets() const; // Method to print offsets
+    bool isPrefetchOn() const { return prefetchOn; }
+    int getLastBestScore() const { return lastBestScore; }
+
+    /** @return The best offsets of the last learning phase, D first */
+    const std::vector<int> &getTopOffsets() const { return topOffsets; }
+
+    /**
+     * Offset used to compute the base address of a fill that was not
+     * prefetched: D while prefetching, the fill address itself otherwise.
+     */
+    int getFillOffset() const { return prefetchOn ? D : 0; }
 
     // Add friend declaration to allow TDTPrefetcher access
     friend class TDTPrefetcher;
@@ -81,11 +218,31 @@ class TDTPrefetcherHashedSetAssociative : public TaggedSetAssociative
         ~TDTPrefetcherHashedSetAssociative() = default;
 };
 
+/**
+ * Indexing policy of the Recent Requests table. The set is a hash of two
+ * consecutive slices of the line address, and only a partial tag made of
+ * the tag_bits bits above the set index is kept.
+ */
+class TDTPrefetcherRRHashedSetAssociative : public TaggedSetAssociative
+{
+    protected:
+        /** Mask selecting the partial tag bits */
+        const Addr tagMask;
+
+        uint32_t extractSet(const KeyType &key) const override;
+        Addr extractTag(const Addr addr) const override;
+
+    public:
+        TDTPrefetcherRRHashedSetAssociative(
+            const TDTPrefetcherRRHashedSetAssociativeParams &p);
+
+        ~TDTPrefetcherRRHashedSetAssociative() = default;
+};
+
 class TDTPrefetcher : public Queued
 {
 
   protected:
-   BestOffsetPrefetcher bestOffsetPrefetcher;
     const struct PCTableInfo
     {
         const int assoc;
@@ -104,40 +261,326 @@ class TDTPrefetcher : public Queued
         }
     } pcTableInfo;
 
-    // A basic entry you can use for designing your prefetcher
-    // You can extend this type of entry with more data like cycle accessed
-    // Recommend to store this in a a map and look through to find matching entries
+    /** Initial confidence of a new PC table entry */
+    const SatCounter8 initConfidence;
+
+    /** Confidence needed for the stride engine to issue prefetches */
+    const double threshConf;
+
+    /** Number of prefetches issued by the stride engine per access */
+    const unsigned strideDegree;
+
+    /** How the arbiter chooses between the stride and BO engines */
+    const TDTArbiter arbiter;
+
+    /**
+     * Whether candidates carry the confidence of their engine as their
+     * priority, from 0 to 100, instead of 0
+     */
+    const bool confidencePriority;
+
+    /** Engine whose candidates were issued for an access */
+    enum EngineChoice
+    {
+        NoEngine,
+        StrideEngine,
+        BOEngine,
+        BothEngines,
+        NumEngineChoices
+    };
+
+    /** Stride of the accesses of a PC, with its confidence */
     struct TDTEntry : public TaggedEntry
     {
-        TDTEntry(TagExtractor ext);
+        TDTEntry(const SatCounter8 &init_confidence, TagExtractor ext);
         void invalidate() override;
 
-        
+        void serialize(CheckpointOut &cp) const;
+        void unserialize(CheckpointIn &cp);
 
         Addr lastAddr = 0;
-
-
+        int stride = 0;
+        SatCounter8 confidence;
     };
 
     // This redefines an associative set as the PC Table, a Set can be indexed
     // into by a PC, so a PC will go to a single TDTEntry (or return nullptr)
     using PCTable = AssociativeCache<TDTEntry>;
 
-    // The following can safely be ignored
-    std::unordered_map<int, std::unique_ptr<PCTable>> pcTables;
+    /**
+     * Learning state of a hardware context. Each context trains its own
+     * BO learner and PC table, so threads and cores sharing a cache do
+     * not disturb each other's offsets.
+     */
+    struct ContextState
+    {
+        ContextState(const std::string &name, const TDTPrefetcherParams &p,
+                     const PCTableInfo &pc_table_info,
+                     const SatCounter8 &init_confidence);
+
+        BestOffsetPrefetcher bestOffsetPrefetcher;
+        PCTable pcTable;
+    };
+
+    std::unordered_map<ContextID, std::unique_ptr<ContextState>> contexts;
+
+    /**
+     * Try to find the learning state of the given context. If none is
+     * found, a new one is created.
+     *
+     * @param context The context to be searched for.
+     * @return The state corresponding to the given context.
+     */
+    ContextState& findContext(ContextID context);
+
+    /**
+     * Create the learning state of the given context.
+     *
+     * @param context The context of the new state.
+     * @return The new state
+     */
+    ContextState& allocateNewContext(ContextID context);
+
+    /**
+     * Context whose state is trained by a request. Requests that carry no
+     * context, such as prefetches from upper levels, train context 0.
+     */
+    static ContextID
+    learningContext(ContextID context)
+    {
+        return context == InvalidContextID ? 0 : context;
+    }
+
+    /** Context and base address a BO prefetch was generated with */
+    struct IssuedOffset
+    {
+        /** Physical line address of the prefetch */
+        Addr line = MaxAddr;
+        ContextID context = InvalidContextID;
+        /**
+         * Line of the triggering access in the learning address space,
+         * which the fill inserts in the RR table
+         */
+        Addr base = 0;
+    };
+
+    /**
+     * Direct-mapped table of the in-flight BO prefetches, indexed by
+     * physical line and kept until their fill. A record can be
+     * overwritten before its fill arrives, in which case the fill is
+     * treated as a demand fill.
+     */
+    std::vector<IssuedOffset> issuedOffsets;
+
+    /**
+     * Remember the context and base address used to prefetch a line.
+     * @param line Physical line address of the prefetch
+     * @param context Context that generated the prefetch
+     * @param base Line of the triggering access, in the learning space
+     */
+    void recordIssuedOffset(Addr line, ContextID context, Addr base);
+
+    /**
+     * Physical line address of a prefetch candidate.
+     * @param pfi Information of the triggering access
+     * @param pf_addr Address of the candidate, in the learning space
+     * @param pf_line Filled with the physical line of the candidate
+     * @return False if it is only known after translation, i.e., for
+     *         virtual candidates outside of the page of the access
+     */
+    bool physicalLine(const PrefetchInfo &pfi, Addr pf_addr,
+                      Addr &pf_line) const;
+
+    /** What to do with BO candidates that cross a physical page */
+    const TDTPagePolicy pagePolicy;
+
+    /**
+     * Retrieve and forget the record of a filled line.
+     * @param line Physical line address of the fill
+     * @param record Filled with the record of the line, if any
+     * @return False if the line was not prefetched or its record was lost
+     */
+    bool takeIssuedOffset(Addr line, IssuedOffset &record);
+
+    /** Context and triggering PC of a prefetch issued to the cache */
+    struct IssuedPrefetch
+    {
+        ContextID context;
+        Addr pc;
+        bool secure;
+    };
 
-    PCTable& findTable(int context);
-    PCTable& allocateNewContext(int context);
-    // The preceding can safely be ignored
+    /**
+     * Prefetches issued to the cache, by physical block address, until a
+     * demand finds them in flight, uses their block, or their block is
+     * evicted. They attribute the late and useful prefetches the base
+     * counters see to a context and a PC.
+     */
+    std::unordered_map<Addr, IssuedPrefetch> issuedPrefetches;
+
+    /**
+     * Retrieve and forget the prefetch issued for a block.
+     * @param addr Address in the block
+     * @param is_secure Whether the block belongs to the secure space
+     * @param prefetch Filled with the prefetch, if any
+     * @return False if the block has no prefetch issued by this cache
+     */
+    bool takeIssuedPrefetch(Addr addr, bool is_secure,
+                            IssuedPrefetch &prefetch);
+
+    /** How the candidates of an access are derived from the BO learner */
+    const TDTDegreeMode degreeMode;
+
+    /** Largest number of candidates generated per access */
+    const unsigned maxDegree;
+
+    /** Whether the degree and prefetch-off decision follow accuracy */
+    const bool adaptiveDegree;
+
+    /** Number of prefetch outcomes (useful or unused) per accuracy window */
+    const unsigned accuracyWindow;
+
+    /** Accuracy at or above which the degree is increased */
+    const double highAccuracy;
+
+    /** Accuracy below which the degree is decreased */
+    const double lowAccuracy;
+
+    /**
+     * Accuracy below which prefetching is suspended when the degree is
+     * already 1
+     */
+    const double offAccuracy;
+
+    /** Number of candidates currently generated per access */
+    unsigned degree;
+
+    /**
+     * Prefetching was suspended by the accuracy throttle. It resumes when
+     * a learning phase selects a new offset.
+     */
+    bool throttledOff;
+
+    /**
+     * Scale of the number of candidates of both engines, set by the
+     * feedback throttle. Low enough, it suspends an engine.
+     */
+    double throttleScale;
+
+    /**
+     * Scale a number of candidates per access by the throttle.
+     * @param num Number of candidates of the configuration
+     * @return Number of candidates to generate, possibly 0
+     */
+    unsigned scaledDegree(unsigned num) const;
+
+    /** Values of pfUseful and pfUnused at the start of the current window */
+    statistics::Counter windowUseful;
+    statistics::Counter windowUnused;
+
+    /**
+     * Adapt the degree from the useful and unused prefetches of the
+     * current window, once it has seen accuracyWindow outcomes.
+     */
+    void updateDegree();
+
+    /**
+     * Count the end of a learning phase in the stats.
+     * @param bo BO learner whose phase ended
+     * @param end How the phase ended
+     * @param context Context of the learner
+     */
+    void recordPhaseEnd(const BestOffsetPrefetcher &bo,
+                        BestOffsetPrefetcher::PhaseEnd end,
+                        ContextID context);
+
+    /**
+     * Train the stride of the accessing PC and generate its candidates if
+     * the stride is confident enough.
+     * @param pc_table PC table of the accessing context
+     * @param pfi Information of the access
+     * @param candidates Filled with the stride candidates
+     */
+    void calculateStrideCandidates(PCTable &pc_table,
+                                   const PrefetchInfo &pfi,
+                                   std::vector<AddrPriority> &candidates);
+
+    /**
+     * Generate the BO candidates of an access from the learned offsets,
+     * applying the page policy when learning on physical addresses.
+     * @param bo BO learner of the accessing context
+     * @param access_addr Address of the access, in the learning space
+     * @param candidates Filled with the BO candidates
+     */
+    void calculateBOCandidates(const BestOffsetPrefetcher &bo,
+                               Addr access_addr,
+                               std::vector<AddrPriority> &candidates);
+
+    struct TDTStats : public statistics::Group
+    {
+        TDTStats(statistics::Group *parent);
+
+        /** Learning phases completed, per context */
+        statistics::Vector learningPhases;
+        /** Prefetch candidates generated, per context */
+        statistics::Vector pfCandidates;
+        /** Accuracy windows that increased the degree */
+        statistics::Scalar degreeIncreases;
+        /** Accuracy windows that decreased the degree */
+        statistics::Scalar degreeDecreases;
+        /** Accuracy windows that suspended prefetching */
+        statistics::Scalar throttledOff;
+        /** Accesses for which each engine's candidates were issued */
+        statistics::Vector engineChoice;
+        /** Offsets selected by the learning phases */
+        statistics::Distribution selectedOffsets;
+        /** Learning phases ended by an offset reaching the score max */
+        statistics::Scalar phasesScoreMax;
+        /** Learning phases ended by reaching the round max */
+        statistics::Scalar phasesRoundMax;
+        /** Highest score of each learning phase */
+        statistics::Distribution bestScore;
+        /** Demand accesses that found a prefetch in flight, per context */
+        statistics::Vector latePrefetches;
+        /** Prefetches issued, per triggering PC */
+        statistics::SparseHistogram pcIssued;
+        /** Prefetched lines used by a demand, per triggering PC */
+        statistics::SparseHistogram pcUseful;
+        /** BO candidates dropped for crossing a physical page */
+        statistics::Scalar pfPageDropped;
+        /** BO candidates clamped to the page of the access */
+        statistics::Scalar pfPageClamped;
+    } statsTDT;
 
     void notifyFill(const CacheAccessProbeArg &arg) override;
+    void notifyEvict(const CacheDataUpdateProbeArg &info) override;
 
   public:
+    PARAMS(TDTPrefetcher);
     TDTPrefetcher(const TDTPrefetcherParams &p);
 
+    void regStats() override;
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
     void calculatePrefetch(const PrefetchInfo &pf1,
                            std::vector<AddrPriority> &addresses,
                            const CacheAccessor &cache) override;
+
+    void notifyPrefetchIssued(const PrefetchInfo &pfi,
+                              const PacketPtr &pkt) override;
+    void notifyPrefetchLate(Addr addr, bool is_secure) override;
+    void notifyPrefetchUseful(Addr addr, bool is_secure) override;
+
+    /**
+     * Scale the BO degree and the stride degree. Above the configured
+     * aggressiveness, the single mode also prefetches multiples of the
+     * best offset, and the top offsets mode is capped by the offsets it
+     * tracks.
+     * @param scale Aggressiveness relative to the configuration
+     */
+    void setAggressiveness(double scale) override;
                            
 
 };
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/prefetch/temporal.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "params/TemporalPrefetcher.hh"
+#include "sim/cur_tick.hh"
+#include "sim/stats.hh"
+
+namespace gem5
+{
+
+namespace prefetch
+{
+
+Temporal::PCEntry::PCEntry(TagExtractor ext)
+  : TaggedEntry()
+{
+    registerTagExtractor(ext);
+    invalidate();
+}
+
+void
+Temporal::PCEntry::invalidate()
+{
+    TaggedEntry::invalidate();
+    lastAddr = MaxAddr;
+}
+
+Temporal::CorrelationEntry::CorrelationEntry(
+    const SatCounter8 &init_confidence, TagExtractor ext)
+  : TaggedEntry(), confidence(init_confidence)
+{
+    registerTagExtractor(ext);
+    invalidate();
+}
+
+void
+Temporal::CorrelationEntry::invalidate()
+{
+    TaggedEntry::invalidate();
+    successor = 0;
+    confidence.reset();
+}
+
+Temporal::Temporal(const TemporalPrefetcherParams &p)
+  : Queued(p),
+    metadataLocation(p.metadata_location),
+    degree(p.degree),
+    scaledDegree(degree),
+    entryBytes(p.metadata_entry_bytes),
+    transferBytes(p.metadata_transfer_bytes),
+    metadataLatency(p.metadata_latency),
+    metadataBandwidth(p.metadata_bandwidth),
+    readQueueSize(p.metadata_read_queue),
+    pcTable((name() + ".PCTable").c_str(),
+            p.pc_table_entries,
+            p.pc_table_assoc,
+            p.pc_table_replacement_policy,
+            p.pc_table_indexing_policy,
+            PCEntry(genTagExtractor(p.pc_table_indexing_policy))),
+    metadataTable((name() + ".MetadataTable").c_str(),
+                  p.metadata_entries,
+                  p.metadata_assoc,
+                  p.metadata_replacement_policy,
+                  p.metadata_indexing_policy,
+                  CorrelationEntry(
+                      SatCounter8(p.confidence_counter_bits, 1),
+                      genTagExtractor(p.metadata_indexing_policy))),
+    nextHistory(0),
+    transfersEnd(0),
+    temporalStats(this, double(p.metadata_entries) * p.metadata_entry_bytes,
+                  p.metadata_location == TemporalMetadata::off_chip ?
+                      double(p.history_buffer_entries) *
+                      p.metadata_entry_bytes : 0.0,
+                  p.metadata_transfer_bytes)
+{
+    fatal_if(metadataLocation == TemporalMetadata::off_chip &&
+             p.history_buffer_entries == 0,
+             "An off-chip history buffer needs at least one entry.\n");
+    fatal_if(metadataLocation == TemporalMetadata::off_chip &&
+             readQueueSize == 0,
+             "Off-chip metadata needs at least one read in flight.\n");
+    if (metadataLocation == TemporalMetadata::off_chip) {
+        historyBuffer.reserve(p.history_buffer_entries);
+        historyOrder.reserve(p.history_buffer_entries);
+    }
+}
+
+Temporal::TemporalStats::TemporalStats(statistics::Group *parent,
+                                       double on_chip_bytes,
+                                       double off_chip_bytes,
+                                       unsigned transfer_bytes)
+  : statistics::Group(parent, "temporal"),
+    ADD_STAT(onChipBytes, statistics::units::Byte::get(),
+             "Metadata storage on chip"),
+    ADD_STAT(offChipBytes, statistics::units::Byte::get(),
+             "Metadata storage in memory"),
+    ADD_STAT(onChipHits, statistics::units::Count::get(),
+             "Number of metadata lookups that hit on chip"),
+    ADD_STAT(onChipMisses, statistics::units::Count::get(),
+             "Number of metadata lookups that missed on chip"),
+    ADD_STAT(offChipHits, statistics::units::Count::get(),
+             "Number of on-chip misses found in the history buffer"),
+    ADD_STAT(offChipReads, statistics::units::Count::get(),
+             "Number of metadata transfers from memory"),
+    ADD_STAT(offChipReadsDropped, statistics::units::Count::get(),
+             "Number of on-chip misses not read from memory as too many "
+             "reads were in flight"),
+    ADD_STAT(offChipWrites, statistics::units::Count::get(),
+             "Number of metadata transfers to memory"),
+    ADD_STAT(offChipBandwidth, statistics::units::Rate<
+                statistics::units::Byte, statistics::units::Second>::get(),
+             "Memory bandwidth taken by the metadata transfers")
+{
+    onChipBytes = statistics::constant(on_chip_bytes);
+    offChipBytes = statistics::constant(off_chip_bytes);
+    offChipBandwidth = (offChipReads + offChipWrites) *
+        statistics::constant(transfer_bytes) / simSeconds;
+}
+
+const Temporal::CorrelationEntry *
+Temporal::lookup(Addr addr, bool is_secure)
+{
+    const CorrelationEntry::KeyType key = metadataKey(addr, is_secure);
+    CorrelationEntry *entry = metadataTable.findEntry(key);
+    if (entry != nullptr) {
+        metadataTable.accessEntry(entry);
+        temporalStats.onChipHits++;
+        return entry;
+    }
+    temporalStats.onChipMisses++;
+
+    if (metadataLocation == TemporalMetadata::off_chip) {
+        readOffChip(addr, is_secure);
+    }
+    return nullptr;
+}
+
+void
+Temporal::readOffChip(Addr addr, bool is_secure)
+{
+    for (const PendingRead &read : pendingReads) {
+        if (read.addr == addr && read.isSecure == is_secure) {
+            return;
+        }
+    }
+    if (pendingReads.size() >= readQueueSize) {
+        temporalStats.offChipReadsDropped++;
+        return;
+    }
+
+    temporalStats.offChipReads++;
+    PendingRead read{reserveTransfer() + metadataLatency, addr, is_secure,
+                     false, 0};
+    auto it = historyBuffer.find(historyKey(addr, is_secure));
+    if (it != historyBuffer.end()) {
+        temporalStats.offChipHits++;
+        read.found = true;
+        read.successor = it->second;
+    }
+    // Reads complete in the order they are issued, as they all take the
+    // same latency after their transfer
+    pendingReads.push_back(read);
+}
+
+void
+Temporal::completeReads()
+{
+    while (!pendingReads.empty() && pendingReads.front().ready <= curTick()) {
+        const PendingRead &read = pendingReads.front();
+        // A newer successor may have been learnt while the read was in
+        // flight
+        if (read.found && metadataTable.findEntry(
+                metadataKey(read.addr, read.isSecure)) == nullptr) {
+            storeOnChip(read.addr, read.successor, read.isSecure);
+        }
+        pendingReads.pop_front();
+    }
+}
+
+Tick
+Temporal::reserveTransfer()
+{
+    transfersEnd = std::max(transfersEnd, curTick()) +
+        Tick(transferBytes * metadataBandwidth);
+    return transfersEnd;
+}
+
+Temporal::CorrelationEntry *
+Temporal::storeOnChip(Addr addr, Addr successor, bool is_secure)
+{
+    const CorrelationEntry::KeyType key = metadataKey(addr, is_secure);
+    CorrelationEntry *entry = metadataTable.findVictim(key);
+    metadataTable.insertEntry(key, entry);
+    entry->successor = successor;
+    return entry;
+}
+
+void
+Temporal::storeOffChip(Addr addr, Addr successor, bool is_secure)
+{
+    const Addr key = historyKey(addr, is_secure);
+    auto [it, inserted] = historyBuffer.try_emplace(key, successor);
+    it->second = successor;
+    temporalStats.offChipWrites++;
+    reserveTransfer();
+    if (!inserted) {
+        return;
+    }
+
+    // Forget the oldest block once the buffer is full
+    if (historyOrder.size() < historyOrder.capacity()) {
+        historyOrder.push_back(key);
+    } else {
+        historyBuffer.erase(historyOrder[nextHistory]);
+        historyOrder[nextHistory] = key;
+        nextHistory = (nextHistory + 1) % historyOrder.size();
+    }
+}
+
+void
+Temporal::update(Addr addr, Addr successor, bool is_secure)
+{
+    CorrelationEntry *entry =
+        metadataTable.findEntry(metadataKey(addr, is_secure));
+    if (entry == nullptr) {
+        // Writing the successor does not need the old metadata
+        storeOnChip(addr, successor, is_secure);
+    } else if (entry->successor == successor) {
+        entry->confidence++;
+        return;
+    } else {
+        entry->confidence--;
+        if (entry->confidence != 0) {
+            return;
+        }
+        entry->successor = successor;
+        entry->confidence.reset();
+    }
+
+    // The metadata in memory is written through
+    if (metadataLocation == TemporalMetadata::off_chip) {
+        storeOffChip(addr, successor, is_secure);
+    }
+}
+
+void
+Temporal::setAggressiveness(double scale)
+{
+    // The chain of successors is followed further or less far
+    scaledDegree = std::max(1u, unsigned(std::lround(degree * scale)));
+}
+
+void
+Temporal::calculatePrefetch(const PrefetchInfo &pfi,
+                            std::vector<AddrPriority> &addresses,
+                            const CacheAccessor &cache)
+{
+    if (!pfi.hasPC()) {
+        DPRINTF(HWPrefetch, "Ignoring request with no PC.\n");
+        return;
+    }
+
+    const Addr addr = blockAddress(pfi.getAddr());
+    const bool is_secure = pfi.isSecure();
+
+    // Train on the miss stream, including the misses that were removed
+    // by a prefetch, so that the stream does not change once it is
+    // prefetched
+    if (!pfi.isCacheMiss() &&
+        !cache.hasBeenPrefetched(pfi.getPaddr(), is_secure)) {
+        return;
+    }
+
+    if (metadataLocation == TemporalMetadata::off_chip) {
+        completeReads();
+    }
+
+    const PCEntry::KeyType pc_key{pfi.getPC(), is_secure};
+    PCEntry *pc_entry = pcTable.findEntry(pc_key);
+    if (pc_entry != nullptr) {
+        pcTable.accessEntry(pc_entry);
+        if (pc_entry->lastAddr == addr) {
+            return;
+        }
+        update(pc_entry->lastAddr, addr, is_secure);
+    } else {
+        pc_entry = pcTable.findVictim(pc_key);
+        pcTable.insertEntry(pc_key, pc_entry);
+    }
+    pc_entry->lastAddr = addr;
+
+    // Follow the chain of successors
+    Addr current = addr;
+    for (unsigned d = 0; d < scaledDegree; d++) {
+        const CorrelationEntry *entry = lookup(current, is_secure);
+        if (entry == nullptr || entry->successor == addr) {
+            break;
+        }
+        current = entry->successor;
+        addresses.push_back(AddrPriority(current, scaledDegree - d));
+    }
+
+    DPRINTF(HWPrefetch, "Temporal: miss %#x, PC %#x, %d successors\n", addr,
+            pfi.getPC(), addresses.size());
+}
+
+} // namespace prefetch
+} // namespace gem5
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes a temporal, address-correlating, prefetcher.
+ *
+ * The prefetcher learns, for every missing block, the block that missed
+ * next under the same PC, and prefetches the chain of successors of every
+ * miss. The successor pairs are its metadata, which is kept either in an
+ * on-chip table, whose capacity can be carved out of the ways of a cache,
+ * or in a history buffer in memory, fronted by the on-chip table used as
+ * a metadata cache. The metadata read from memory takes the memory latency
+ * and bandwidth to arrive, so it only serves the misses after it.
+ *
+ * H. Wu, K. Nathella, J. Pusdesris, D. Sunwoo, A. Jain and C. Lin,
+ * "Temporal prefetching without the off-chip metadata", MICRO 2019.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_TEMPORAL_HH__
+#define __MEM_CACHE_PREFETCH_TEMPORAL_HH__
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "base/cache/associative_cache.hh"
+#include "base/sat_counter.hh"
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "enums/TemporalMetadata.hh"
+#include "mem/cache/prefetch/queued.hh"
+#include "mem/cache/tags/tagged_entry.hh"
+#include "mem/packet.hh"
+
+namespace gem5
+{
+
+struct TemporalPrefetcherParams;
+
+namespace prefetch
+{
+
+class Temporal : public Queued
+{
+  protected:
+    /** Where the metadata is kept */
+    const TemporalMetadata metadataLocation;
+
+    /** Number of successors prefetched per miss */
+    const unsigned degree;
+
+    /** Degree scaled by the feedback throttle */
+    unsigned scaledDegree;
+
+    /** Size of a metadata entry, in bytes */
+    const unsigned entryBytes;
+
+    /** Size of a transfer of metadata from or to memory, in bytes */
+    const unsigned transferBytes;
+
+    /** Latency of a read of metadata from memory */
+    const Tick metadataLatency;
+
+    /** Memory bandwidth of the metadata transfers, in ticks per byte */
+    const double metadataBandwidth;
+
+    /** Number of metadata reads from memory in flight */
+    const unsigned readQueueSize;
+
+    /** Last block that missed under a PC */
+    struct PCEntry : public TaggedEntry
+    {
+        PCEntry(TagExtractor ext);
+
+        void invalidate() override;
+
+        Addr lastAddr;
+    };
+    AssociativeCache<PCEntry> pcTable;
+
+    /** The block that follows a block in the miss stream of its PC */
+    struct CorrelationEntry : public TaggedEntry
+    {
+        CorrelationEntry(const SatCounter8 &init_confidence,
+                         TagExtractor ext);
+
+        void invalidate() override;
+
+        Addr successor;
+        /** How often the successor was seen again; a new one replaces it
+         *  only once it reaches zero */
+        SatCounter8 confidence;
+    };
+    AssociativeCache<CorrelationEntry> metadataTable;
+
+    /**
+     * History buffer in memory, used when the metadata is off-chip. It
+     * maps the key of a block to its successor, and forgets the oldest
+     * keys first.
+     */
+    std::unordered_map<Addr, Addr> historyBuffer;
+    std::vector<Addr> historyOrder;
+    size_t nextHistory;
+
+    /** A read of the history buffer in flight */
+    struct PendingRead
+    {
+        /** When the metadata is back from memory */
+        Tick ready;
+        Addr addr;
+        bool isSecure;
+        /** Whether the history buffer holds a successor for the block */
+        bool found;
+        Addr successor;
+    };
+
+    /** Reads of the history buffer in flight, in completion order */
+    std::deque<PendingRead> pendingReads;
+
+    /** When the metadata transfers queued so far are over */
+    Tick transfersEnd;
+
+    struct TemporalStats : public statistics::Group
+    {
+        TemporalStats(statistics::Group *parent, double on_chip_bytes,
+                      double off_chip_bytes, unsigned transfer_bytes);
+
+        /** Metadata storage on chip, in bytes */
+        statistics::Formula onChipBytes;
+        /** Metadata storage in memory, in bytes */
+        statistics::Formula offChipBytes;
+        statistics::Scalar onChipHits;
+        statistics::Scalar onChipMisses;
+        /** On-chip misses found in the history buffer */
+        statistics::Scalar offChipHits;
+        /** Transfers of metadata from memory */
+        statistics::Scalar offChipReads;
+        /** On-chip misses not read as too many reads were in flight */
+        statistics::Scalar offChipReadsDropped;
+        /** Transfers of metadata to memory */
+        statistics::Scalar offChipWrites;
+        /** Memory bandwidth taken by the metadata, in bytes per second */
+        statistics::Formula offChipBandwidth;
+    } temporalStats;
+
+    /** @return The key of a block in the on-chip table */
+    CorrelationEntry::KeyType
+    metadataKey(Addr addr, bool is_secure) const
+    {
+        // Index with the block number, as the offset bits are all zero
+        return {addr >> lBlkSize, is_secure};
+    }
+
+    /** @return The key of a block in the history buffer */
+    static Addr
+    historyKey(Addr addr, bool is_secure)
+    {
+        // Blocks are aligned, so the secure bit fits in the offset
+        return addr | Addr(is_secure);
+    }
+
+    /**
+     * Find the successor of a block. When the metadata is off-chip, an
+     * on-chip miss issues a read of the history buffer. The successor it
+     * finds fills the on-chip table once the read is back from memory, so
+     * it is only used by the lookups from then on, never by this one.
+     * @param addr The block
+     * @param is_secure Whether the block belongs to the secure space
+     * @return The entry of the block, nullptr if not on chip
+     */
+    const CorrelationEntry *lookup(Addr addr, bool is_secure);
+
+    /**
+     * Read the successor of a block from the history buffer, unless a
+     * read of the block is already in flight.
+     * @param addr The block
+     * @param is_secure Whether the block belongs to the secure space
+     */
+    void readOffChip(Addr addr, bool is_secure);
+
+    /** Fill the on-chip table with the reads that are back from memory. */
+    void completeReads();
+
+    /**
+     * Reserve the memory bandwidth of a metadata transfer, after the
+     * transfers queued before it.
+     * @return When the transfer is over
+     */
+    Tick reserveTransfer();
+
+    /**
+     * Record that a block followed another in the miss stream of a PC.
+     * @param addr The block that missed first
+     * @param successor The block that missed next
+     * @param is_secure Whether the blocks belong to the secure space
+     */
+    void update(Addr addr, Addr successor, bool is_secure);
+
+    /**
+     * Store the successor of a block in the on-chip table.
+     * @return The entry of the block
+     */
+    CorrelationEntry *storeOnChip(Addr addr, Addr successor,
+                                  bool is_secure);
+
+    /** Store the successor of a block in the history buffer. */
+    void storeOffChip(Addr addr, Addr successor, bool is_secure);
+
+  public:
+    Temporal(const TemporalPrefetcherParams &p);
+
+    void calculatePrefetch(const PrefetchInfo &pfi,
+                           std::vector<AddrPriority> &addresses,
+                           const CacheAccessor &cache) override;
+
+    void setAggressiveness(double scale) override;
+};
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif // __MEM_CACHE_PREFETCH_TEMPORAL_HH__
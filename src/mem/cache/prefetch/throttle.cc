@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/cache/prefetch/throttle.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+#include "mem/cache/prefetch/queued.hh"
+#include "mem/mem_ctrl.hh"
+#include "params/PrefetchThrottle.hh"
+
+namespace gem5
+{
+
+namespace prefetch
+{
+
+Throttle::Throttle(const PrefetchThrottleParams &p)
+  : SimObject(p),
+    interval(p.interval),
+    minIssued(p.min_issued),
+    accuracyHigh(p.accuracy_high / 100.0),
+    accuracyLow(p.accuracy_low / 100.0),
+    latenessThreshold(p.lateness_threshold / 100.0),
+    pollutionThreshold(p.pollution_threshold / 100.0),
+    readQueueThreshold(p.read_queue_threshold / 100.0),
+    busThreshold(p.bus_threshold / 100.0),
+    numLevels(p.levels),
+    initialLevel(p.initial_level),
+    memCtrls(p.mem_ctrls),
+    lastBusBusy(memCtrls.size(), 0),
+    sampleEvent([this]{ sample(); }, name()),
+    throttleStats(this)
+{
+    fatal_if(interval == 0, "The throttle needs a sampling interval.\n");
+    fatal_if(accuracyLow > accuracyHigh,
+             "The low accuracy of the throttle is above the high one.\n");
+    fatal_if(initialLevel == 0 || initialLevel > numLevels,
+             "The initial level of the throttle must be within its %d "
+             "levels.\n", numLevels);
+
+    throttleStats.levels.init(1, numLevels, 1);
+}
+
+Throttle::ThrottleStats::ThrottleStats(Throttle *parent)
+  : statistics::Group(parent),
+    ADD_STAT(intervals, statistics::units::Count::get(),
+             "Number of sampled intervals"),
+    ADD_STAT(pressuredIntervals, statistics::units::Count::get(),
+             "Number of intervals with the memory under pressure"),
+    ADD_STAT(increments, statistics::units::Count::get(),
+             "Number of times a prefetcher became more aggressive"),
+    ADD_STAT(decrements, statistics::units::Count::get(),
+             "Number of times a prefetcher became less aggressive"),
+    ADD_STAT(levels, statistics::units::Count::get(),
+             "Aggressiveness levels of the prefetchers")
+{
+}
+
+void
+Throttle::startup()
+{
+    for (int i = 0; i < memCtrls.size(); i++) {
+        lastBusBusy[i] = memCtrls[i]->dataBusBusyTicks();
+    }
+    schedule(sampleEvent, curTick() + interval);
+}
+
+void
+Throttle::registerPrefetcher(Queued *prefetcher)
+{
+    clients.push_back(Client{prefetcher, prefetcher->feedback(),
+                             initialLevel});
+}
+
+bool
+Throttle::memoryPressured()
+{
+    bool pressured = false;
+    for (int i = 0; i < memCtrls.size(); i++) {
+        const Tick busy = memCtrls[i]->dataBusBusyTicks();
+        // Pseudo channels each have their own bus
+        const double utilization = double(busy - lastBusBusy[i]) /
+            (double(interval) * memCtrls[i]->numDataBuses());
+        lastBusBusy[i] = busy;
+
+        // The read buffer is sampled now, the bus over the interval
+        if (utilization >= busThreshold ||
+            memCtrls[i]->readBufferOccupancy() >= readQueueThreshold) {
+            pressured = true;
+        }
+    }
+    return pressured;
+}
+
+int
+Throttle::decide(double accuracy, bool late, bool polluting,
+                 bool pressured) const
+{
+    // Accurate prefetches are worth their bandwidth, and should only be
+    // issued earlier if they arrive late and the memory can take it
+    if (accuracy >= accuracyHigh) {
+        return (late && !pressured) ? 1 : 0;
+    }
+
+    // Others give their bandwidth and their cache space back
+    if (pressured || polluting) {
+        return -1;
+    }
+    if (accuracy < accuracyLow) {
+        return late ? -1 : 0;
+    }
+    return late ? 1 : 0;
+}
+
+void
+Throttle::sample()
+{
+    throttleStats.intervals++;
+    const bool pressured = memoryPressured();
+    if (pressured) {
+        throttleStats.pressuredIntervals++;
+    }
+
+    for (Client &client : clients) {
+        Base::Feedback now = client.prefetcher->feedback();
+
+        // The counters restart when the statistics are reset
+        if (now.issued < client.last.issued ||
+            now.useful < client.last.useful ||
+            now.late < client.last.late ||
+            now.pollution < client.last.pollution ||
+            now.demandMisses < client.last.demandMisses) {
+            client.last = Base::Feedback();
+        }
+        const uint64_t issued = now.issued - client.last.issued;
+        const uint64_t useful = now.useful - client.last.useful;
+        const uint64_t late = now.late - client.last.late;
+        const uint64_t pollution = now.pollution - client.last.pollution;
+        const uint64_t misses = now.demandMisses - client.last.demandMisses;
+        client.last = now;
+
+        throttleStats.levels.sample(client.level);
+        if (issued < minIssued) {
+            continue;
+        }
+
+        // Prefetches issued in an earlier interval may be used in this
+        // one, so the accuracy is capped
+        const double accuracy = std::min(1.0, double(useful) / issued);
+        const bool is_late = double(late) / issued >= latenessThreshold;
+        const bool polluting = misses > 0 &&
+            double(pollution) / misses >= pollutionThreshold;
+
+        const int step = decide(accuracy, is_late, polluting, pressured);
+        if (step > 0 && client.level < numLevels) {
+            client.level++;
+            throttleStats.increments++;
+        } else if (step < 0 && client.level > 1) {
+            client.level--;
+            throttleStats.decrements++;
+        } else {
+            continue;
+        }
+
+        DPRINTF(HWPrefetch, "Throttle: %s to level %d, accuracy %.2f, "
+                "%s, %s%s\n", client.prefetcher->name(), client.level,
+                accuracy, is_late ? "late" : "timely",
+                polluting ? "polluting" : "clean",
+                pressured ? ", memory under pressure" : "");
+        client.prefetcher->setAggressiveness(double(client.level) /
+                                             initialLevel);
+    }
+
+    schedule(sampleEvent, curTick() + interval);
+}
+
+} // namespace prefetch
+} // namespace gem5
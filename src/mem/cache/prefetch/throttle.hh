@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Describes a feedback-directed prefetch throttle.
+ *
+ * The throttle samples, at regular intervals, the accuracy, lateness and
+ * pollution of every prefetcher registered with it, together with the
+ * load on the memory controllers, and moves each prefetcher up or down a
+ * ladder of aggressiveness levels. Since a single throttle is shared by
+ * the prefetchers of the whole hierarchy, they are coordinated: while
+ * the memory is under pressure no prefetcher becomes more aggressive,
+ * and the ones that are not highly accurate back off first.
+ *
+ * S. Srinath, O. Mutlu, H. Kim and Y. N. Patt, "Feedback directed
+ * prefetching: Improving the performance and bandwidth-efficiency of
+ * hardware prefetchers", HPCA 2007.
+ *
+ * E. Ebrahimi, O. Mutlu, C. J. Lee and Y. N. Patt, "Coordinated control
+ * of multiple prefetchers in multi-core systems", MICRO 2009.
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_THROTTLE_HH__
+#define __MEM_CACHE_PREFETCH_THROTTLE_HH__
+
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/cache/prefetch/base.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+namespace gem5
+{
+
+struct PrefetchThrottleParams;
+
+namespace memory
+{
+class MemCtrl;
+} // namespace memory
+
+namespace prefetch
+{
+
+class Queued;
+
+class Throttle : public SimObject
+{
+  protected:
+    /** Time between two samples of the feedback */
+    const Tick interval;
+
+    /** Prefetches a prefetcher must issue in an interval to be judged */
+    const unsigned minIssued;
+
+    /** Accuracy at or above which a prefetcher is accurate */
+    const double accuracyHigh;
+
+    /** Accuracy below which a prefetcher is inaccurate */
+    const double accuracyLow;
+
+    /** Fraction of late prefetches at which a prefetcher is late */
+    const double latenessThreshold;
+
+    /** Fraction of the demand misses caused by prefetches at which a
+     *  prefetcher pollutes the cache */
+    const double pollutionThreshold;
+
+    /** Read buffer occupancy at which a controller is under pressure */
+    const double readQueueThreshold;
+
+    /** Data bus utilization at which a controller is under pressure */
+    const double busThreshold;
+
+    /** Number of aggressiveness levels */
+    const unsigned numLevels;
+
+    /** Level at which the prefetchers behave as configured */
+    const unsigned initialLevel;
+
+    /** Controllers whose load throttles the prefetchers */
+    const std::vector<memory::MemCtrl *> memCtrls;
+
+    /** Busy time of the data bus of each controller at the last sample */
+    std::vector<Tick> lastBusBusy;
+
+    /** A throttled prefetcher */
+    struct Client
+    {
+        Queued *prefetcher;
+        /** Counters of the prefetcher at the last sample */
+        Base::Feedback last;
+        /** Current aggressiveness level, from 1 to numLevels */
+        unsigned level;
+    };
+    std::vector<Client> clients;
+
+    EventFunctionWrapper sampleEvent;
+
+    struct ThrottleStats : public statistics::Group
+    {
+        ThrottleStats(Throttle *parent);
+
+        statistics::Scalar intervals;
+        /** Intervals in which a memory controller was under pressure */
+        statistics::Scalar pressuredIntervals;
+        statistics::Scalar increments;
+        statistics::Scalar decrements;
+        /** Levels of the prefetchers, sampled every interval */
+        statistics::Distribution levels;
+    } throttleStats;
+
+    /**
+     * Check the load on the memory controllers over the last interval.
+     * @return Whether any of them is under pressure
+     */
+    bool memoryPressured();
+
+    /**
+     * Decide how the aggressiveness of a prefetcher changes.
+     * @param accuracy Fraction of its prefetches that were useful
+     * @param late Whether too many of its prefetches were late
+     * @param polluting Whether its prefetches evict too many useful blocks
+     * @param pressured Whether the memory is under pressure
+     * @return The change of level, -1, 0 or 1
+     */
+    int decide(double accuracy, bool late, bool polluting,
+               bool pressured) const;
+
+    /** Sample the feedback and adjust every prefetcher */
+    void sample();
+
+  public:
+    Throttle(const PrefetchThrottleParams &p);
+
+    void startup() override;
+
+    /**
+     * Throttle a prefetcher.
+     * @param prefetcher The prefetcher
+     */
+    void registerPrefetcher(Queued *prefetcher);
+};
+
+} // namespace prefetch
+} // namespace gem5
+
+#endif // __MEM_CACHE_PREFETCH_THROTTLE_HH__
@@ -45,9 +45,12 @@
 #ifndef __MEM_CACHE_QUEUE_HH__
 #define __MEM_CACHE_QUEUE_HH__
 
+#include <algorithm>
 #include <cassert>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 
 #include "base/logging.hh"
 #include "base/named.hh"
@@ -101,6 +104,25 @@ class Queue : public Drainable, public Named
     /** Holds non allocated entries. */
     typename Entry::List freeList;
 
+    /**
+     * Index of the allocated entries by block address, so that they are
+     * matched without scanning allocatedList. The entries of a block are
+     * kept in allocation order, as they appear in allocatedList.
+     */
+    std::unordered_map<Addr, std::vector<Entry*>> blkIndex;
+
+    /**
+     * Append a newly allocated entry to the allocated list and index it.
+     *
+     * @param entry The entry, already allocated to its block.
+     */
+    void
+    addToAllocatedList(Entry *entry)
+    {
+        entry->allocIter = allocatedList.insert(allocatedList.end(), entry);
+        blkIndex[entry->blkAddr].push_back(entry);
+    }
+
     typename Entry::Iterator addToReadyList(Entry* entry)
     {
         if (readyList.empty() ||
@@ -140,6 +162,7 @@ class Queue : public Drainable, public Named
         for (int i = 0; i < numEntries; ++i) {
             freeList.push_back(&entries[i]);
         }
+        blkIndex.reserve(numEntries);
     }
 
     bool isEmpty() const
@@ -168,7 +191,12 @@ class Queue : public Drainable, public Named
     Entry* findMatch(Addr blk_addr, bool is_secure,
                      bool ignore_uncacheable = true) const
     {
-        for (const auto& entry : allocatedList) {
+        const auto it = blkIndex.find(blk_addr);
+        if (it == blkIndex.end()) {
+            return nullptr;
+        }
+
+        for (const auto& entry : it->second) {
             // we ignore any entries allocated for uncacheable
             // accesses and simply ignore them when matching, in the
             // cache we never check for matches when adding new
@@ -241,6 +269,13 @@ class Queue : public Drainable, public Named
     deallocate(Entry *entry)
     {
         allocatedList.erase(entry->allocIter);
+        auto it = blkIndex.find(entry->blkAddr);
+        assert(it != blkIndex.end());
+        it->second.erase(std::find(it->second.begin(), it->second.end(),
+                                   entry));
+        if (it->second.empty()) {
+            blkIndex.erase(it);
+        }
         freeList.push_front(entry);
         allocated--;
         if (entry->inService) {
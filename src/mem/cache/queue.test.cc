@@ -0,0 +1,253 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <list>
+#include <random>
+#include <string>
+
+#include "base/gtest/cur_tick_fake.hh"
+#include "mem/cache/queue.hh"
+#include "mem/cache/queue_entry.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+GTestTickHandler tickHandler;
+
+const Addr blkSize = 64;
+
+/** An entry matching the block and security of another, as the MSHRs. */
+class FakeEntry : public QueueEntry
+{
+  public:
+    typedef std::list<FakeEntry *> List;
+    typedef List::iterator Iterator;
+
+    Iterator readyIter;
+    Iterator allocIter;
+
+    FakeEntry(const std::string &name) : QueueEntry(name) {}
+
+    void
+    allocate(Addr blk_addr, bool secure, bool uncacheable, Tick ready_time)
+    {
+        blkAddr = blk_addr;
+        isSecure = secure;
+        _isUncacheable = uncacheable;
+        readyTime = ready_time;
+        inService = false;
+    }
+
+    void deallocate() { inService = false; }
+
+    Tick getReadyTime() const { return readyTime; }
+
+    bool
+    matchBlockAddr(const Addr addr, const bool is_secure) const override
+    {
+        return blkAddr == addr && isSecure == is_secure;
+    }
+
+    bool
+    matchBlockAddr(const PacketPtr pkt) const override
+    {
+        return false;
+    }
+
+    bool
+    conflictAddr(const QueueEntry *entry) const override
+    {
+        return blkAddr == entry->blkAddr && isSecure == entry->isSecure;
+    }
+
+    bool sendPacket(BaseCache &cache) override { return false; }
+
+    Target *getTarget() override { return nullptr; }
+};
+
+/** A queue allocating entries as MSHRQueue and WriteQueue do. */
+class FakeQueue : public Queue<FakeEntry>
+{
+  public:
+    FakeQueue(int num_entries)
+      : Queue<FakeEntry>("queue", num_entries, 0, "queue")
+    {}
+
+    FakeEntry *
+    allocate(Addr blk_addr, bool secure, bool uncacheable, Tick ready_time)
+    {
+        assert(!freeList.empty());
+        FakeEntry *entry = freeList.front();
+        freeList.pop_front();
+
+        entry->allocate(blk_addr, secure, uncacheable, ready_time);
+        addToAllocatedList(entry);
+        entry->readyIter = addToReadyList(entry);
+
+        allocated += 1;
+        return entry;
+    }
+
+    void
+    markInService(FakeEntry *entry)
+    {
+        entry->inService = true;
+        readyList.erase(entry->readyIter);
+        _numInService += 1;
+    }
+
+    /** findMatch as it was, scanning the allocated entries in order. */
+    FakeEntry *
+    scanMatch(Addr blk_addr, bool is_secure, bool ignore_uncacheable) const
+    {
+        for (const auto &entry : allocatedList) {
+            if (!(ignore_uncacheable && entry->isUncacheable()) &&
+                entry->matchBlockAddr(blk_addr, is_secure)) {
+                return entry;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * The conflicting entry not yet in service that is ready first, the
+     * oldest one if several are ready at the same time.
+     */
+    FakeEntry *
+    scanPending(const QueueEntry *other) const
+    {
+        FakeEntry *pending = nullptr;
+        for (const auto &entry : allocatedList) {
+            if (!entry->inService && entry->conflictAddr(other) &&
+                (!pending ||
+                 entry->getReadyTime() < pending->getReadyTime())) {
+                pending = entry;
+            }
+        }
+        return pending;
+    }
+
+    const FakeEntry::List &getAllocated() const { return allocatedList; }
+};
+
+} // anonymous namespace
+
+/** The entries of a block are matched in allocation order. */
+TEST(QueueTest, MatchesOldestEntryOfBlock)
+{
+    FakeQueue queue(8);
+    FakeEntry *first = queue.allocate(0x40, false, false, 0);
+    FakeEntry *second = queue.allocate(0x40, false, false, 0);
+
+    ASSERT_EQ(queue.findMatch(0x40, false), first);
+    queue.deallocate(first);
+    ASSERT_EQ(queue.findMatch(0x40, false), second);
+    queue.deallocate(second);
+    ASSERT_EQ(queue.findMatch(0x40, false), nullptr);
+    ASSERT_TRUE(queue.isEmpty());
+}
+
+/** Secure and non-secure entries of a block do not alias. */
+TEST(QueueTest, SecureDoesNotAlias)
+{
+    FakeQueue queue(8);
+    FakeEntry *non_secure = queue.allocate(0x80, false, false, 0);
+    ASSERT_EQ(queue.findMatch(0x80, true), nullptr);
+
+    FakeEntry *secure = queue.allocate(0x80, true, false, 0);
+    ASSERT_EQ(queue.findMatch(0x80, false), non_secure);
+    ASSERT_EQ(queue.findMatch(0x80, true), secure);
+
+    queue.deallocate(non_secure);
+    ASSERT_EQ(queue.findMatch(0x80, false), nullptr);
+    ASSERT_EQ(queue.findMatch(0x80, true), secure);
+}
+
+/** Uncacheable entries are only matched on request. */
+TEST(QueueTest, UncacheableIgnored)
+{
+    FakeQueue queue(8);
+    FakeEntry *uncacheable = queue.allocate(0xc0, false, true, 0);
+    ASSERT_EQ(queue.findMatch(0xc0, false), nullptr);
+    ASSERT_EQ(queue.findMatch(0xc0, false, false), uncacheable);
+
+    FakeEntry *cacheable = queue.allocate(0xc0, false, false, 0);
+    ASSERT_EQ(queue.findMatch(0xc0, false), cacheable);
+    ASSERT_EQ(queue.findMatch(0xc0, false, false), uncacheable);
+}
+
+/**
+ * Random allocations, deallocations and services give the same matches
+ * and pending entries as scanning the queue.
+ */
+TEST(QueueTest, MatchesScan)
+{
+    const int num_entries = 16;
+    const unsigned num_blks = 8;
+    FakeQueue queue(num_entries);
+    std::mt19937 rng(0);
+
+    for (unsigned i = 0; i < 20000; i++) {
+        const Addr blk_addr = (rng() % num_blks) * blkSize;
+        const bool secure = rng() % 4 == 0;
+        const auto &allocated = queue.getAllocated();
+
+        const unsigned op = rng() % 4;
+        if (op == 0 && !allocated.empty()) {
+            auto it = allocated.begin();
+            std::advance(it, rng() % allocated.size());
+            queue.deallocate(*it);
+        } else if (op == 1 && !allocated.empty()) {
+            auto it = allocated.begin();
+            std::advance(it, rng() % allocated.size());
+            if (!(*it)->inService) {
+                queue.markInService(*it);
+            }
+        } else if (!queue.isFull()) {
+            queue.allocate(blk_addr, secure, rng() % 8 == 0, rng() % 4);
+        }
+
+        FakeEntry other("other");
+        for (Addr addr = 0; addr < num_blks * blkSize; addr += blkSize) {
+            for (bool is_secure : {false, true}) {
+                for (bool ignore : {false, true}) {
+                    ASSERT_EQ(queue.findMatch(addr, is_secure, ignore),
+                              queue.scanMatch(addr, is_secure, ignore));
+                }
+                other.allocate(addr, is_secure, false, 0);
+                ASSERT_EQ(queue.findPending(&other),
+                          queue.scanPending(&other));
+            }
+        }
+    }
+}
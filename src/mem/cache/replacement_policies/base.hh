@@ -29,7 +29,10 @@
 #ifndef __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
 #define __MEM_CACHE_REPLACEMENT_POLICIES_BASE_HH__
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "base/compiler.hh"
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
@@ -109,6 +112,62 @@ class Base : public SimObject
      * @return A shared pointer to the new replacement data.
      */
     virtual std::shared_ptr<ReplacementData> instantiateEntry() = 0;
+
+    /**
+     * Instantiate the replacement data of all the entries of a table at
+     * once. Policies override it to store the data in an array they own,
+     * indexed by set and way, instead of a separate heap object per
+     * entry. Their decisions do not depend on the layout of the data. By
+     * default every entry gets its own instance.
+     *
+     * @param entries The entries of the table, placed in their set and way.
+     */
+    virtual void
+    instantiateEntries(const std::vector<ReplaceableEntry*> &entries)
+    {
+        for (auto entry : entries) {
+            entry->replacementData = instantiateEntry();
+        }
+    }
+
+  protected:
+    /**
+     * Store the replacement data of a table in a single array owned by
+     * this policy, indexed by set and way so that the ways of a set are
+     * contiguous in memory. The entries point to their element without
+     * owning it, so there is neither a control block nor a reference
+     * count to update. The array lives as long as the policy.
+     *
+     * @param entries The entries of the table, placed in their set and way.
+     * @param args The arguments to construct the replacement data with.
+     */
+    template <class Data, class... Args>
+    void
+    instantiatePacked(const std::vector<ReplaceableEntry*> &entries,
+                      const Args&... args)
+    {
+        uint32_t num_sets = 0;
+        uint32_t assoc = 0;
+        for (auto entry : entries) {
+            num_sets = std::max(num_sets, entry->getSet() + 1);
+            assoc = std::max(assoc, entry->getWay() + 1);
+        }
+
+        auto table = std::make_shared<std::vector<Data>>(
+            std::size_t(num_sets) * assoc, Data(args...));
+        for (auto entry : entries) {
+            Data &data =
+                (*table)[std::size_t(entry->getSet()) * assoc +
+                         entry->getWay()];
+            entry->replacementData = std::shared_ptr<ReplacementData>(
+                std::shared_ptr<ReplacementData>(), &data);
+        }
+        packedTables.push_back(std::move(table));
+    }
+
+  private:
+    /** The arrays of replacement data of the tables packed by this policy */
+    std::vector<std::shared_ptr<void>> packedTables;
 };
 
 } // namespace replacement_policy
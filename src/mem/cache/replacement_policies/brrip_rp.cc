@@ -146,5 +146,11 @@ BRRIP::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new BRRIPReplData(numRRPVBits));
 }
 
+void
+BRRIP::instantiateEntries(const std::vector<ReplaceableEntry*> &entries)
+{
+    instantiatePacked<BRRIPReplData>(entries, numRRPVBits);
+}
+
 } // namespace replacement_policy
 } // namespace gem5
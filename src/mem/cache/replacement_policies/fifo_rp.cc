@@ -94,5 +94,11 @@ FIFO::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new FIFOReplData());
 }
 
+void
+FIFO::instantiateEntries(const std::vector<ReplaceableEntry*> &entries)
+{
+    instantiatePacked<FIFOReplData>(entries);
+}
+
 } // namespace replacement_policy
 } // namespace gem5
@@ -115,6 +115,9 @@ class FIFO : public Base
      * @return A shared pointer to the new replacement data.
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
+
+    void instantiateEntries(const std::vector<ReplaceableEntry*> &entries)
+                                                                     override;
 };
 
 } // namespace replacement_policy
@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "base/gtest/cur_tick_fake.hh"
+#include "mem/cache/replacement_policies/base.hh"
+#include "mem/cache/replacement_policies/bip_rp.hh"
+#include "mem/cache/replacement_policies/brrip_rp.hh"
+#include "mem/cache/replacement_policies/fifo_rp.hh"
+#include "mem/cache/replacement_policies/lfu_rp.hh"
+#include "mem/cache/replacement_policies/lru_rp.hh"
+#include "mem/cache/replacement_policies/mru_rp.hh"
+#include "mem/cache/replacement_policies/random_rp.hh"
+#include "mem/cache/replacement_policies/second_chance_rp.hh"
+#include "mem/cache/replacement_policies/ship_rp.hh"
+#include "mem/cache/replacement_policies/weighted_lru_rp.hh"
+#include "mem/packet.hh"
+#include "mem/request.hh"
+#include "params/BIPRP.hh"
+#include "params/BRRIPRP.hh"
+#include "params/FIFORP.hh"
+#include "params/LFURP.hh"
+#include "params/LRURP.hh"
+#include "params/MRURP.hh"
+#include "params/RandomRP.hh"
+#include "params/SHiPMemRP.hh"
+#include "params/SHiPPCRP.hh"
+#include "params/SecondChanceRP.hh"
+#include "params/WeightedLRURP.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+GTestTickHandler tickHandler;
+
+const unsigned numSets = 8;
+const unsigned assoc = 4;
+
+using PolicyPtr = std::unique_ptr<replacement_policy::Base>;
+
+/** A set associative table, with the entries the policy replaces. */
+class Table
+{
+  public:
+    /**
+     * @param policy The replacement policy of the table.
+     * @param packed Whether the replacement data is instantiated for the
+     *        whole table, or for each entry as the tags used to.
+     */
+    Table(replacement_policy::Base &policy, bool packed)
+      : policy(policy), entries(numSets * assoc),
+        tags(numSets * assoc, MaxAddr)
+    {
+        for (unsigned set = 0; set < numSets; set++) {
+            for (unsigned way = 0; way < assoc; way++) {
+                entries[set * assoc + way].setPosition(set, way);
+            }
+        }
+
+        if (!packed) {
+            for (auto &entry : entries) {
+                entry.replacementData = policy.instantiateEntry();
+            }
+            return;
+        }
+
+        // The data is placed by set and way, whatever the order of the
+        // entries
+        std::vector<ReplaceableEntry*> shuffled;
+        for (auto &entry : entries) {
+            shuffled.push_back(&entry);
+        }
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(0));
+        policy.instantiateEntries(shuffled);
+    }
+
+    /**
+     * Access a block, replacing an entry of its set on a miss.
+     * @return The way replaced, or assoc on a hit.
+     */
+    unsigned
+    access(unsigned set, Addr tag, const PacketPtr pkt)
+    {
+        for (unsigned way = 0; way < assoc; way++) {
+            ReplaceableEntry &entry = entries[set * assoc + way];
+            if (tags[set * assoc + way] == tag) {
+                policy.touch(entry.replacementData, pkt);
+                return assoc;
+            }
+        }
+
+        ReplacementCandidates candidates;
+        for (unsigned way = 0; way < assoc; way++) {
+            candidates.push_back(&entries[set * assoc + way]);
+        }
+        ReplaceableEntry *victim = policy.getVictim(candidates);
+        const unsigned way = victim->getWay();
+        if (tags[set * assoc + way] != MaxAddr) {
+            policy.invalidate(victim->replacementData);
+        }
+        tags[set * assoc + way] = tag;
+        policy.reset(victim->replacementData, pkt);
+        return way;
+    }
+
+    void
+    invalidate(unsigned set, unsigned way)
+    {
+        if (tags[set * assoc + way] != MaxAddr) {
+            tags[set * assoc + way] = MaxAddr;
+            policy.invalidate(entries[set * assoc + way].replacementData);
+        }
+    }
+
+  private:
+    replacement_policy::Base &policy;
+    std::vector<ReplaceableEntry> entries;
+    std::vector<Addr> tags;
+};
+
+/**
+ * Replay the same random accesses and invalidations on a table with each
+ * layout of the replacement data, and check that they replace the same
+ * ways. The policies are instantiated alike, so that their random number
+ * generators draw the same numbers.
+ */
+void
+compareLayouts(std::function<PolicyPtr()> make_policy)
+{
+    PolicyPtr separate_policy = make_policy();
+    PolicyPtr packed_policy = make_policy();
+    Table separate(*separate_policy, false);
+    Table packed(*packed_policy, true);
+    std::mt19937 rng(1);
+
+    for (unsigned i = 0; i < 20000; i++) {
+        tickHandler.setCurTick(i + 1);
+        const unsigned set = rng() % numSets;
+
+        if (rng() % 16 == 0) {
+            const unsigned way = rng() % assoc;
+            separate.invalidate(set, way);
+            packed.invalidate(set, way);
+            continue;
+        }
+
+        const Addr tag = rng() % (2 * assoc);
+        const Addr addr = (tag * numSets + set) * 64;
+        auto req = std::make_shared<Request>(addr, 64, 0, 0, addr >> 3, 0);
+        req->setPaddr(addr);
+        Packet pkt(req, MemCmd::ReadReq);
+        ASSERT_EQ(separate.access(set, tag, &pkt),
+                  packed.access(set, tag, &pkt)) << "access " << i;
+    }
+}
+
+template <class Params>
+Params
+makeParams()
+{
+    Params p;
+    p.name = "repl";
+    p.eventq_index = 0;
+    return p;
+}
+
+BRRIPRPParams
+brripParams()
+{
+    auto p = makeParams<BRRIPRPParams>();
+    p.num_bits = 2;
+    p.hit_priority = false;
+    p.btp = 3;
+    return p;
+}
+
+template <class Params>
+Params
+shipParams()
+{
+    auto p = makeParams<Params>();
+    p.num_bits = 2;
+    p.hit_priority = true;
+    p.btp = 0;
+    p.shct_size = 16;
+    p.insertion_threshold = 1;
+    return p;
+}
+
+} // anonymous namespace
+
+TEST(InstantiateEntriesTest, LRU)
+{
+    compareLayouts([] {
+        return std::make_unique<replacement_policy::LRU>(
+            makeParams<LRURPParams>()); });
+}
+
+TEST(InstantiateEntriesTest, BIP)
+{
+    auto p = makeParams<BIPRPParams>();
+    p.btp = 3;
+    compareLayouts([&p] {
+        return std::make_unique<replacement_policy::BIP>(p); });
+}
+
+TEST(InstantiateEntriesTest, WeightedLRU)
+{
+    compareLayouts([] {
+        return std::make_unique<replacement_policy::WeightedLRU>(
+            makeParams<WeightedLRURPParams>()); });
+}
+
+TEST(InstantiateEntriesTest, MRU)
+{
+    compareLayouts([] {
+        return std::make_unique<replacement_policy::MRU>(
+            makeParams<MRURPParams>()); });
+}
+
+TEST(InstantiateEntriesTest, FIFO)
+{
+    compareLayouts([] {
+        return std::make_unique<replacement_policy::FIFO>(
+            makeParams<FIFORPParams>()); });
+}
+
+TEST(InstantiateEntriesTest, SecondChance)
+{
+    compareLayouts([] {
+        return std::make_unique<replacement_policy::SecondChance>(
+            makeParams<SecondChanceRPParams>()); });
+}
+
+TEST(InstantiateEntriesTest, LFU)
+{
+    compareLayouts([] {
+        return std::make_unique<replacement_policy::LFU>(
+            makeParams<LFURPParams>()); });
+}
+
+TEST(InstantiateEntriesTest, BRRIP)
+{
+    compareLayouts([] {
+        return std::make_unique<replacement_policy::BRRIP>(brripParams()); });
+}
+
+TEST(InstantiateEntriesTest, SHiPMem)
+{
+    compareLayouts([] {
+        return std::make_unique<replacement_policy::SHiPMem>(
+            shipParams<SHiPMemRPParams>()); });
+}
+
+TEST(InstantiateEntriesTest, SHiPPC)
+{
+    compareLayouts([] {
+        return std::make_unique<replacement_policy::SHiPPC>(
+            shipParams<SHiPPCRPParams>()); });
+}
+
+TEST(InstantiateEntriesTest, Random)
+{
+    compareLayouts([] {
+        return std::make_unique<replacement_policy::Random>(
+            makeParams<RandomRPParams>()); });
+}
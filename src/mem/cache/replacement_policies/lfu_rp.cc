@@ -92,5 +92,11 @@ LFU::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new LFUReplData());
 }
 
+void
+LFU::instantiateEntries(const std::vector<ReplaceableEntry*> &entries)
+{
+    instantiatePacked<LFUReplData>(entries);
+}
+
 } // namespace replacement_policy
 } // namespace gem5
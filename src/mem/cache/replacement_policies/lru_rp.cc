@@ -96,5 +96,11 @@ LRU::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new LRUReplData());
 }
 
+void
+LRU::instantiateEntries(const std::vector<ReplaceableEntry*> &entries)
+{
+    instantiatePacked<LRUReplData>(entries);
+}
+
 } // namespace replacement_policy
 } // namespace gem5
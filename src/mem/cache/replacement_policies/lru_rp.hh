@@ -107,6 +107,9 @@ class LRU : public Base
      * @return A shared pointer to the new replacement data.
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
+
+    void instantiateEntries(const std::vector<ReplaceableEntry*> &entries)
+                                                                     override;
 };
 
 } // namespace replacement_policy
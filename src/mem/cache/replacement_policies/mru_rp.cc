@@ -101,5 +101,11 @@ MRU::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new MRUReplData());
 }
 
+void
+MRU::instantiateEntries(const std::vector<ReplaceableEntry*> &entries)
+{
+    instantiatePacked<MRUReplData>(entries);
+}
+
 } // namespace replacement_policy
 } // namespace gem5
@@ -109,6 +109,9 @@ class MRU : public Base
      * @return A shared pointer to the new replacement data.
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
+
+    void instantiateEntries(const std::vector<ReplaceableEntry*> &entries)
+                                                                     override;
 };
 
 } // namespace replacement_policy
@@ -94,5 +94,11 @@ Random::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new RandomReplData());
 }
 
+void
+Random::instantiateEntries(const std::vector<ReplaceableEntry*> &entries)
+{
+    instantiatePacked<RandomReplData>(entries);
+}
+
 } // namespace replacement_policy
 } // namespace gem5
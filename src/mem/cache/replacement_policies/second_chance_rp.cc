@@ -137,5 +137,11 @@ SecondChance::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new SecondChanceReplData());
 }
 
+void
+SecondChance::instantiateEntries(const std::vector<ReplaceableEntry*> &entries)
+{
+    instantiatePacked<SecondChanceReplData>(entries);
+}
+
 } // namespace replacement_policy
 } // namespace gem5
@@ -147,6 +147,12 @@ SHiP::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new SHiPReplData(numRRPVBits));
 }
 
+void
+SHiP::instantiateEntries(const std::vector<ReplaceableEntry*> &entries)
+{
+    instantiatePacked<SHiPReplData>(entries, numRRPVBits);
+}
+
 SHiPMem::SHiPMem(const SHiPMemRPParams &p) : SHiP(p) {}
 
 SHiP::SignatureType
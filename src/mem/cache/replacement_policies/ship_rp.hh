@@ -158,6 +158,9 @@ class SHiP : public BRRIP
      * @return A shared pointer to the new replacement data.
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
+
+    void instantiateEntries(const std::vector<ReplaceableEntry*> &entries)
+                                                                     override;
 };
 
 /** SHiP that Uses memory addresses as signatures. */
@@ -96,5 +96,11 @@ WeightedLRU::instantiateEntry()
     return std::shared_ptr<ReplacementData>(new WeightedLRUReplData);
 }
 
+void
+WeightedLRU::instantiateEntries(const std::vector<ReplaceableEntry*> &entries)
+{
+    instantiatePacked<WeightedLRUReplData>(entries);
+}
+
 } // namespace replacement_policy
 } // namespace gem5
@@ -75,6 +75,9 @@ class WeightedLRU : public LRU
      */
     std::shared_ptr<ReplacementData> instantiateEntry() override;
 
+    void instantiateEntries(const std::vector<ReplaceableEntry*> &entries)
+                                                                     override;
+
     /**
      * Find replacement victim using weight.
      *
@@ -93,6 +93,10 @@ class BaseTags(ClockedObject):
         "Whether to access tags and data sequentially",
     )
 
+    tag_only = Param.Bool(
+        Parent.tag_only, "Whether the blocks hold no data"
+    )
+
     # Get indexing policy
     indexing_policy = Param.TaggedIndexingPolicy(
         TaggedSetAssociative(), "Indexing policy"
@@ -66,7 +66,9 @@ BaseTags::BaseTags(const Params &p)
       partitionManager(p.partitioning_manager),
       warmupBound((p.warmup_percentage/100.0) * (p.size / p.block_size)),
       warmedUp(false), numBlocks(p.size / p.block_size),
-      dataBlks(new uint8_t[p.size]), // Allocate data storage in one big chunk
+      tagOnly(p.tag_only),
+      // Allocate data storage in one big chunk
+      dataBlks(new uint8_t[p.tag_only ? p.block_size : p.size]),
       stats(*this)
 {
     registerExitCallback([this]() { cleanupRefs(); });
@@ -81,10 +83,23 @@ BaseTags::findBlockBySetAndWay(int set, int way) const
 CacheBlk*
 BaseTags::findBlock(const CacheBlk::KeyType &key) const
 {
+    // Walk the set in place when the key has a single one, as copying
+    // the possible entries on every lookup is costly
+    uint32_t set;
+    if (indexingPolicy->getSetIndex(key, set)) {
+        return findBlockIn(indexingPolicy->getSet(set), key);
+    }
+
     // Find possible entries that may contain the given address
     const std::vector<ReplaceableEntry*> entries =
         indexingPolicy->getPossibleEntries(key);
+    return findBlockIn(entries, key);
+}
 
+CacheBlk*
+BaseTags::findBlockIn(const std::vector<ReplaceableEntry*> &entries,
+                      const CacheBlk::KeyType &key)
+{
     // Search for block
     for (const auto& location : entries) {
         CacheBlk* blk = static_cast<CacheBlk*>(location);
@@ -50,6 +50,7 @@
 #include <cstdint>
 #include <functional>
 #include <string>
+#include <vector>
 
 #include "base/callback.hh"
 #include "base/logging.hh"
@@ -102,9 +103,27 @@ class BaseTags : public ClockedObject
     /** the number of blocks in the cache */
     const unsigned numBlocks;
 
+    /**
+     * Whether the blocks hold no data. They then all share a single line
+     * of scratch storage instead of one line each.
+     */
+    const bool tagOnly;
+
     /** The data blocks, 1 per cache block. */
     std::unique_ptr<uint8_t[]> dataBlks;
 
+    /**
+     * Get the data storage of a block.
+     *
+     * @param blk_index The index of the block.
+     * @return The line of data the block points to.
+     */
+    uint8_t *
+    blockData(unsigned blk_index) const
+    {
+        return tagOnly ? &dataBlks[0] : &dataBlks[blkSize * blk_index];
+    }
+
     /**
      * TODO: It would be good if these stats were acquired after warmup.
      */
@@ -160,6 +179,16 @@ class BaseTags : public ClockedObject
         statistics::Scalar dataAccesses;
     } stats;
 
+    /**
+     * Search a group of entries for the block matching a key.
+     *
+     * @param entries The entries that may hold the block.
+     * @param key The key of the block.
+     * @return Pointer to the cache block, or nullptr if not found.
+     */
+    static CacheBlk *findBlockIn(const std::vector<ReplaceableEntry*> &entries,
+                                 const CacheBlk::KeyType &key);
+
   public:
     PARAMS(BaseTags);
     BaseTags(const Params &p);
@@ -46,6 +46,7 @@
 #include "mem/cache/tags/base_set_assoc.hh"
 
 #include <string>
+#include <vector>
 
 #include "base/intmath.hh"
 
@@ -55,7 +56,8 @@ namespace gem5
 BaseSetAssoc::BaseSetAssoc(const Params &p)
     :BaseTags(p), allocAssoc(p.assoc), blks(p.size / p.block_size),
      sequentialAccess(p.sequential_access),
-     replacementPolicy(p.replacement_policy)
+     replacementPolicy(p.replacement_policy), assoc(p.assoc),
+     packedTags(numBlocks, p.assoc)
 {
     // There must be a indexing policy
     fatal_if(!p.indexing_policy, "An indexing policy is required");
@@ -69,6 +71,8 @@ BaseSetAssoc::BaseSetAssoc(const Params &p)
 void
 BaseSetAssoc::tagsInit()
 {
+    std::vector<ReplaceableEntry*> entries(numBlocks);
+
     // Initialize all blocks
     for (unsigned blk_index = 0; blk_index < numBlocks; blk_index++) {
         // Locate next cache block
@@ -78,14 +82,36 @@ BaseSetAssoc::tagsInit()
         indexingPolicy->setEntry(blk, blk_index);
 
         // Associate a data chunk to the block
-        blk->data = &dataBlks[blkSize*blk_index];
-
-        // Associate a replacement data entry to the block
-        blk->replacementData = replacementPolicy->instantiateEntry();
+        blk->data = blockData(blk_index);
 
         // This is not used as of now but we set it for security
         blk->registerTagExtractor(genTagExtractor(indexingPolicy));
+
+        updatePacked(blk);
+        entries[blk_index] = blk;
     }
+
+    // Associate a replacement data entry to every block at once, so that
+    // the replacement state of a set is contiguous
+    replacementPolicy->instantiateEntries(entries);
+}
+
+CacheBlk*
+BaseSetAssoc::findBlock(const CacheBlk::KeyType &key) const
+{
+    uint32_t set;
+    if (!indexingPolicy->getSetIndex(key, set)) {
+        return BaseTags::findBlock(key);
+    }
+
+    uint32_t way;
+    if (!packedTags.find(set, extractTag(key.address), key.secure, way)) {
+        return nullptr;
+    }
+
+    CacheBlk *blk = static_cast<CacheBlk*>(indexingPolicy->getEntry(set, way));
+    assert(blk->match(key));
+    return blk;
 }
 
 void
@@ -97,6 +123,7 @@ BaseSetAssoc::invalidate(CacheBlk *blk)
     }
 
     BaseTags::invalidate(blk);
+    updatePacked(blk);
 
     // Decrease the number of tags in use
     stats.tagsInUse--;
@@ -109,6 +136,8 @@ void
 BaseSetAssoc::moveBlock(CacheBlk *src_blk, CacheBlk *dest_blk)
 {
     BaseTags::moveBlock(src_blk, dest_blk);
+    updatePacked(src_blk);
+    updatePacked(dest_blk);
 
     // Since the blocks were using different replacement data pointers,
     // we must touch the replacement data of the new entry, and invalidate
@@ -59,6 +59,7 @@
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/base.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
+#include "mem/cache/tags/packed_tags.hh"
 #include "mem/cache/tags/partitioning_policies/partition_manager.hh"
 #include "mem/packet.hh"
 #include "params/BaseSetAssoc.hh"
@@ -88,6 +89,25 @@ class BaseSetAssoc : public BaseTags
     /** Replacement policy */
     replacement_policy::Base *replacementPolicy;
 
+    /** The associativity of the cache. */
+    const unsigned assoc;
+
+    /** The tags of the blocks, packed for the lookups. */
+    PackedTags packedTags;
+
+    /**
+     * Mirror the tag, valid and secure bits of a block in the packed
+     * tags. Must be called whenever any of them changes.
+     *
+     * @param blk The block to mirror.
+     */
+    void
+    updatePacked(const CacheBlk *blk)
+    {
+        packedTags.update(blk->getSet(), blk->getWay(), blk->getTag(),
+                          blk->isValid(), blk->isSecure());
+    }
+
   public:
     /** Convenience typedef. */
      typedef BaseSetAssocParams Params;
@@ -115,6 +135,15 @@ class BaseSetAssoc : public BaseTags
      */
     void invalidate(CacheBlk *blk) override;
 
+    /**
+     * Finds the block in the cache without touching it. When all ways of
+     * the key lie in one set, their packed tags are swept.
+     *
+     * @param key The key to look for.
+     * @return Pointer to the cache block.
+     */
+    CacheBlk *findBlock(const CacheBlk::KeyType &key) const override;
+
     /**
      * Access block and update replacement data. May not succeed, in which case
      * nullptr is returned. This has all the implications of a cache access and
@@ -201,6 +230,7 @@ class BaseSetAssoc : public BaseTags
     {
         // Insert block
         BaseTags::insertBlock(pkt, blk);
+        updatePacked(blk);
 
         // Increment tag counter
         stats.tagsInUse++;
@@ -45,6 +45,8 @@
 
 #include "mem/cache/tags/compressed_tags.hh"
 
+#include <vector>
+
 #include "base/trace.hh"
 #include "debug/CacheComp.hh"
 #include "mem/cache/replacement_policies/base.hh"
@@ -69,6 +71,17 @@ CompressedTags::tagsInit()
     blks = std::vector<CompressionBlk>(numBlocks);
     superBlks = std::vector<SuperBlk>(numSectors);
 
+    // Link the superblocks to the indexing policy, then associate a
+    // replacement data entry to all of them at once, at their set and way
+    std::vector<ReplaceableEntry*> entries(numSectors);
+    for (unsigned superblock_index = 0; superblock_index < numSectors;
+         superblock_index++) {
+        indexingPolicy->setEntry(&superBlks[superblock_index],
+                                 superblock_index);
+        entries[superblock_index] = &superBlks[superblock_index];
+    }
+    replacementPolicy->instantiateEntries(entries);
+
     // Initialize all blocks
     unsigned blk_index = 0;          // index into blks array
     for (unsigned superblock_index = 0; superblock_index < numSectors;
@@ -81,9 +94,6 @@ CompressedTags::tagsInit()
         // allocation conditions
         superblock->setBlkSize(blkSize);
 
-        // Associate a replacement data entry to the block
-        superblock->replacementData = replacementPolicy->instantiateEntry();
-
         // Initialize all blocks in this superblock
         superblock->blks.resize(numBlocksPerSector, nullptr);
         for (unsigned k = 0; k < numBlocksPerSector; ++k){
@@ -94,7 +104,7 @@ CompressedTags::tagsInit()
             blk = &blks[blk_index];
 
             // Associate a data chunk to the block
-            blk->data = &dataBlks[blkSize*blk_index];
+            blk->data = blockData(blk_index);
 
             // Associate superblock to this block
             blk->setSectorBlock(superblock);
@@ -108,9 +118,6 @@ CompressedTags::tagsInit()
             // Update block index
             ++blk_index;
         }
-
-        // Link block to indexing policy
-        indexingPolicy->setEntry(superblock, superblock_index);
     }
 }
 
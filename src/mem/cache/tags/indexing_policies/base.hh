@@ -170,6 +170,34 @@ class IndexingPolicyTemplate : public SimObject
         return sets[set][way];
     }
 
+    /**
+     * Get all the entries of a set, without copying them. Together with
+     * getSetIndex() this allows walking the possible entries of a key in
+     * place, which is cheaper than getPossibleEntries() on hot paths.
+     *
+     * @param set The set of the desired entries.
+     * @return The entries of the set, indexed by way.
+     */
+    const std::vector<ReplaceableEntry*>&
+    getSet(const uint32_t set) const
+    {
+        return sets[set];
+    }
+
+    /**
+     * Find the single set holding all possible entries of a key. Policies
+     * that may place the ways of a key in different sets do not have one.
+     *
+     * @param key The key to find the set of.
+     * @param set The set of the key, if it has a single one.
+     * @return Whether all possible entries of the key lie in one set.
+     */
+    virtual bool
+    getSetIndex(const KeyType &key, uint32_t &set) const
+    {
+        return false;
+    }
+
     /**
      * Generate the tag from the given address.
      *
@@ -75,4 +75,11 @@ SetAssociative::getPossibleEntries(const Addr &addr) const
     return sets[extractSet(addr)];
 }
 
+bool
+SetAssociative::getSetIndex(const Addr &addr, uint32_t &set) const
+{
+    set = extractSet(addr);
+    return true;
+}
+
 } // namespace gem5
@@ -118,6 +118,15 @@ class SetAssociative : public BaseIndexingPolicy
     std::vector<ReplaceableEntry*> getPossibleEntries(const Addr &addr) const
                                                                      override;
 
+    /**
+     * All the ways of an address belong to the set of the address.
+     *
+     * @param addr The addr to find the set of.
+     * @param set The set of the address.
+     * @return Always true.
+     */
+    bool getSetIndex(const Addr &addr, uint32_t &set) const override;
+
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
      *
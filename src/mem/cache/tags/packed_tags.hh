@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ * Declaration of the packed tags of a set associative tag store.
+ */
+
+#ifndef __MEM_CACHE_TAGS_PACKED_TAGS_HH__
+#define __MEM_CACHE_TAGS_PACKED_TAGS_HH__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "base/types.hh"
+
+namespace gem5
+{
+
+/**
+ * The tag, valid and secure bits of the blocks of a set associative tag
+ * store, packed per set and indexed by set * assoc + way, so that a
+ * lookup sweeps the ways of a set in contiguous memory instead of chasing
+ * a pointer per block. The tag store mirrors its blocks in it.
+ */
+class PackedTags
+{
+  public:
+    /**
+     * @param num_blocks Number of blocks of the tag store.
+     * @param assoc The associativity of the tag store.
+     */
+    PackedTags(std::size_t num_blocks, unsigned assoc)
+      : assoc(assoc), tags(num_blocks, MaxAddr), state(num_blocks, 0)
+    {}
+
+    /**
+     * Mirror a block. Must be called whenever its tag, valid or secure
+     * bit changes.
+     *
+     * @param set The set of the block.
+     * @param way The way of the block.
+     * @param tag The tag of the block.
+     * @param valid Whether the block is valid.
+     * @param secure Whether the block is secure.
+     */
+    void
+    update(uint32_t set, uint32_t way, Addr tag, bool valid, bool secure)
+    {
+        const std::size_t index = set * assoc + way;
+        tags[index] = tag;
+        state[index] = (valid ? Valid : 0) | (secure ? Secure : 0);
+    }
+
+    /**
+     * Look for a valid block in a set. All ways are compared in a single
+     * branchless sweep that the compiler can vectorize.
+     *
+     * @param set The set to look in.
+     * @param tag The tag to look for.
+     * @param secure Whether the block looked for is secure.
+     * @param way The way of the block, if found.
+     * @return Whether the block was found.
+     */
+    bool
+    find(uint32_t set, Addr tag, bool secure, uint32_t &way) const
+    {
+        const uint8_t match_state = Valid | (secure ? Secure : 0);
+        const Addr *set_tags = &tags[set * assoc];
+        const uint8_t *set_state = &state[set * assoc];
+
+        // Do not exit early, so that the loop is vectorized. A block can
+        // only be in one way, and the hit is reported as its way plus one
+        // so that zero means a miss
+        unsigned hit = 0;
+        for (unsigned i = 0; i < assoc; i++) {
+            const bool match =
+                (set_tags[i] == tag) & (set_state[i] == match_state);
+            hit = std::max(hit, match ? i + 1 : 0u);
+        }
+        if (hit == 0) {
+            return false;
+        }
+        way = hit - 1;
+        return true;
+    }
+
+  private:
+    /** Bits of the packed state of a block. */
+    enum : uint8_t
+    {
+        Valid = 0x1,
+        Secure = 0x2
+    };
+
+    /** The associativity of the tag store. */
+    const unsigned assoc;
+
+    /** The tags of the blocks. */
+    std::vector<Addr> tags;
+
+    /** The valid and secure bits of the blocks. */
+    std::vector<uint8_t> state;
+};
+
+} // namespace gem5
+
+#endif //__MEM_CACHE_TAGS_PACKED_TAGS_HH__
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2026 The gem5 Project
+ * All rights reserved
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "base/gtest/cur_tick_fake.hh"
+#include "mem/cache/cache_blk.hh"
+#include "mem/cache/replacement_policies/lru_rp.hh"
+#include "mem/cache/tags/packed_tags.hh"
+#include "mem/cache/tags/tagged_entry.hh"
+#include "params/LRURP.hh"
+#include "params/TaggedSetAssociative.hh"
+
+using namespace gem5;
+
+namespace
+{
+
+GTestTickHandler tickHandler;
+
+const unsigned numBlocks = 16;
+const unsigned assoc = 4;
+const int blkSize = 64;
+
+/**
+ * The blocks of a set associative tag store, mirrored in packed tags as
+ * BaseSetAssoc does, so that packed lookups can be compared with a walk
+ * of the possible entries of the key.
+ */
+class PackedTagsTest : public ::testing::Test
+{
+  protected:
+    PackedTagsTest() : blks(numBlocks), packed(numBlocks, assoc)
+    {
+        TaggedSetAssociativeParams ip;
+        ip.name = "indexing";
+        ip.eventq_index = 0;
+        ip.assoc = assoc;
+        ip.size = numBlocks * blkSize;
+        ip.entry_size = blkSize;
+        indexing = std::make_unique<TaggedSetAssociative>(ip);
+
+        LRURPParams rp;
+        rp.name = "repl";
+        rp.eventq_index = 0;
+        repl = std::make_unique<replacement_policy::LRU>(rp);
+
+        std::vector<ReplaceableEntry*> entries(numBlocks);
+        for (unsigned blk_index = 0; blk_index < numBlocks; blk_index++) {
+            CacheBlk *blk = &blks[blk_index];
+            indexing->setEntry(blk, blk_index);
+            blk->registerTagExtractor(genTagExtractor(indexing.get()));
+            update(blk);
+            entries[blk_index] = blk;
+        }
+        repl->instantiateEntries(entries);
+    }
+
+    void
+    update(const CacheBlk *blk)
+    {
+        packed.update(blk->getSet(), blk->getWay(), blk->getTag(),
+                      blk->isValid(), blk->isSecure());
+    }
+
+    /** Look the key up in the packed tags, as BaseSetAssoc::findBlock. */
+    CacheBlk *
+    findPacked(const CacheBlk::KeyType &key) const
+    {
+        uint32_t set, way;
+        if (!indexing->getSetIndex(key, set) ||
+            !packed.find(set, indexing->extractTag(key.address),
+                         key.secure, way)) {
+            return nullptr;
+        }
+        return static_cast<CacheBlk*>(indexing->getEntry(set, way));
+    }
+
+    /** Look the key up in the blocks, as BaseTags::findBlock. */
+    CacheBlk *
+    findUnpacked(const CacheBlk::KeyType &key) const
+    {
+        for (auto entry : indexing->getPossibleEntries(key)) {
+            CacheBlk *blk = static_cast<CacheBlk*>(entry);
+            if (blk->match(key)) {
+                return blk;
+            }
+        }
+        return nullptr;
+    }
+
+    void
+    invalidate(CacheBlk *blk)
+    {
+        blk->invalidate();
+        update(blk);
+        repl->invalidate(blk->replacementData);
+    }
+
+    /**
+     * Access a key, allocating it on a miss.
+     * @return The block evicted for it, if any.
+     */
+    CacheBlk *
+    access(const CacheBlk::KeyType &key, CacheBlk::KeyType &evicted)
+    {
+        if (CacheBlk *blk = findUnpacked(key)) {
+            repl->touch(blk->replacementData);
+            return nullptr;
+        }
+
+        CacheBlk *victim = static_cast<CacheBlk*>(
+            repl->getVictim(indexing->getPossibleEntries(key)));
+        CacheBlk *evicted_blk = nullptr;
+        if (victim->isValid()) {
+            evicted = {indexing->regenerateAddr({victim->getTag(), false},
+                                                victim),
+                       victim->isSecure()};
+            evicted_blk = victim;
+            invalidate(victim);
+        }
+        victim->insert(key, 0, 0, 0);
+        update(victim);
+        repl->reset(victim->replacementData);
+        return evicted_blk;
+    }
+
+    std::vector<CacheBlk> blks;
+    PackedTags packed;
+    std::unique_ptr<TaggedSetAssociative> indexing;
+    std::unique_ptr<replacement_policy::LRU> repl;
+};
+
+} // anonymous namespace
+
+/** Only valid blocks of the same security are found. */
+TEST_F(PackedTagsTest, MatchesValidAndSecurity)
+{
+    const CacheBlk::KeyType key{0x1040, false};
+    CacheBlk::KeyType evicted;
+
+    // No block is valid at first
+    ASSERT_EQ(findPacked(key), nullptr);
+
+    tickHandler.setCurTick(1);
+    access(key, evicted);
+    CacheBlk *blk = findPacked(key);
+    ASSERT_NE(blk, nullptr);
+    ASSERT_EQ(blk, findUnpacked(key));
+    ASSERT_EQ(findPacked({key.address, true}), nullptr);
+
+    tickHandler.setCurTick(2);
+    access({key.address, true}, evicted);
+    CacheBlk *secure_blk = findPacked({key.address, true});
+    ASSERT_NE(secure_blk, nullptr);
+    ASSERT_NE(secure_blk, blk);
+    ASSERT_EQ(findPacked(key), blk);
+
+    invalidate(blk);
+    ASSERT_EQ(findPacked(key), nullptr);
+    ASSERT_EQ(findPacked({key.address, true}), secure_blk);
+}
+
+/**
+ * Random accesses and invalidations give the same lookups and the same
+ * evictions with the packed tags as with the blocks.
+ */
+TEST_F(PackedTagsTest, MatchesUnpackedLookups)
+{
+    std::mt19937 rng(0);
+    const unsigned num_addrs = 4 * numBlocks;
+
+    for (unsigned i = 0; i < 10000; i++) {
+        const CacheBlk::KeyType key{(rng() % num_addrs) * blkSize,
+                                    rng() % 4 == 0};
+        CacheBlk &blk = blks[rng() % numBlocks];
+
+        // Replacement orders the blocks by the tick of their accesses
+        tickHandler.setCurTick(i + 1);
+
+        if (rng() % 8 == 0 && blk.isValid()) {
+            invalidate(&blk);
+        } else {
+            // The evicted block must be the one the packed tags held the
+            // evicted key in, and the key must be gone from them
+            CacheBlk *evicted_blk = nullptr;
+            if (!findUnpacked(key)) {
+                CacheBlk *victim = static_cast<CacheBlk*>(repl->getVictim(
+                    indexing->getPossibleEntries(key)));
+                if (victim->isValid()) {
+                    evicted_blk = victim;
+                    const CacheBlk::KeyType old_key{
+                        indexing->regenerateAddr({victim->getTag(), false},
+                                                 victim),
+                        victim->isSecure()};
+                    ASSERT_EQ(findPacked(old_key), victim);
+                }
+            }
+            CacheBlk::KeyType evicted;
+            ASSERT_EQ(access(key, evicted), evicted_blk);
+            if (evicted_blk) {
+                ASSERT_EQ(findPacked(evicted), nullptr);
+            }
+            ASSERT_EQ(findPacked(key), findUnpacked(key));
+            ASSERT_NE(findPacked(key), nullptr);
+        }
+
+        for (Addr addr = 0; addr < num_addrs * blkSize; addr += blkSize) {
+            ASSERT_EQ(findPacked({addr, false}), findUnpacked({addr, false}));
+            ASSERT_EQ(findPacked({addr, true}), findUnpacked({addr, true}));
+        }
+    }
+}
@@ -47,6 +47,7 @@
 #include <cassert>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "base/intmath.hh"
 #include "base/logging.hh"
@@ -89,6 +90,16 @@ SectorTags::tagsInit()
     blks = std::vector<SectorSubBlk>(numBlocks);
     secBlks = std::vector<SectorBlk>(numSectors);
 
+    // Link the sectors to the indexing policy, then associate a replacement
+    // data entry to all of them at once, at their set and way
+    std::vector<ReplaceableEntry*> entries(numSectors);
+    for (unsigned sec_blk_index = 0; sec_blk_index < numSectors;
+         sec_blk_index++) {
+        indexingPolicy->setEntry(&secBlks[sec_blk_index], sec_blk_index);
+        entries[sec_blk_index] = &secBlks[sec_blk_index];
+    }
+    replacementPolicy->instantiateEntries(entries);
+
     // Initialize all blocks
     unsigned blk_index = 0;       // index into blks array
     for (unsigned sec_blk_index = 0; sec_blk_index < numSectors;
@@ -97,9 +108,6 @@ SectorTags::tagsInit()
         // Locate next cache sector
         SectorBlk* sec_blk = &secBlks[sec_blk_index];
 
-        // Associate a replacement data entry to the sector
-        sec_blk->replacementData = replacementPolicy->instantiateEntry();
-
         // Initialize all blocks in this sector
         sec_blk->blks.resize(numBlocksPerSector);
         for (unsigned k = 0; k < numBlocksPerSector; ++k){
@@ -110,7 +118,7 @@ SectorTags::tagsInit()
             blk = &blks[blk_index];
 
             // Associate a data chunk to the block
-            blk->data = &dataBlks[blkSize*blk_index];
+            blk->data = blockData(blk_index);
 
             // Associate sector block to this block
             blk->setSectorBlock(sec_blk);
@@ -124,9 +132,6 @@ SectorTags::tagsInit()
             // Update block index
             ++blk_index;
         }
-
-        // Link block to indexing policy
-        indexingPolicy->setEntry(sec_blk, sec_blk_index);
     }
 }
 
@@ -49,6 +49,7 @@
 #include "mem/cache/tags/indexing_policies/base.hh"
 #include "params/TaggedIndexingPolicy.hh"
 #include "params/TaggedSetAssociative.hh"
+#include "sim/serialize.hh"
 
 namespace gem5
 {
@@ -94,6 +95,13 @@ class TaggedSetAssociative : public TaggedIndexingPolicy
         return sets[extractSet(key)];
     }
 
+    bool
+    getSetIndex(const KeyType &key, uint32_t &set) const override
+    {
+        set = extractSet(key);
+        return true;
+    }
+
     Addr
     regenerateAddr(const KeyType &key,
                    const ReplaceableEntry *entry) const override
@@ -191,6 +199,32 @@ class TaggedEntry : public ReplaceableEntry
             isSecure(), isValid(), ReplaceableEntry::print());
     }
 
+    /**
+     * Checkpoint the tag and secure bit of a valid entry. Entries holding
+     * more state extend these to checkpoint it as well.
+     */
+    void
+    serialize(CheckpointOut &cp) const
+    {
+        paramOut(cp, "tag", getTag());
+        paramOut(cp, "secure", isSecure());
+    }
+
+    /** Restore a checkpointed entry into this invalid entry. */
+    void
+    unserialize(CheckpointIn &cp)
+    {
+        Addr tag;
+        bool secure;
+        paramIn(cp, "tag", tag);
+        paramIn(cp, "secure", secure);
+        setValid();
+        setTag(tag);
+        if (secure) {
+            setSecure();
+        }
+    }
+
   protected:
     /**
      * Set tag associated to this block.
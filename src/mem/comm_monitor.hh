@@ -40,6 +40,7 @@
 #ifndef __MEM_COMM_MONITOR_HH__
 #define __MEM_COMM_MONITOR_HH__
 
+#include "base/pool_alloc.hh"
 #include "base/statistics.hh"
 #include "mem/port.hh"
 #include "params/CommMonitor.hh"
@@ -89,7 +90,9 @@ class CommMonitor : public SimObject
      * Sender state class for the monitor so that we can annotate
      * packets with a transmit time and receive time.
      */
-    class CommMonitorSenderState : public Packet::SenderState
+    class CommMonitorSenderState
+        : public Packet::SenderState,
+          public PoolAllocated<CommMonitorSenderState>
     {
 
       public:
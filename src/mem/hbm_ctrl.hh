@@ -253,6 +253,15 @@ class HBMCtrl : public MemCtrl
     virtual void startup() override;
     virtual void drainResume() override;
 
+    double
+    readBufferOccupancy() const override
+    {
+        return double(totalReadQueueSize + respQueue.size() +
+                      respQueuePC1.size()) / readBufferSize;
+    }
+
+    unsigned numDataBuses() const override { return 2; }
+
 
   protected:
     Tick recvAtomic(PacketPtr pkt) override;
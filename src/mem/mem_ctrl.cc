@@ -76,7 +76,7 @@ MemCtrl::MemCtrl(const MemCtrlParams &p) :
     frontendLatency(p.static_frontend_latency),
     backendLatency(p.static_backend_latency),
     commandWindow(p.command_window),
-    prevArrival(0),
+    prevArrival(0), dataBusBusy(0),
     stats(*this)
 {
     DPRINTF(MemCtrl, "Setting up controller\n");
@@ -818,6 +818,7 @@ MemCtrl::doBurstAccess(MemPacket* mem_pkt, MemInterface* mem_intr)
     mem_intr->nextReqTime = mem_intr->nextBurstAt - mem_intr->commandOffset();
 
     // Update the common bus stats
+    dataBusBusy += mem_intr->burstDelay();
     if (mem_pkt->isRead()) {
         ++(mem_intr->readsThisTime);
         // Update latency stats
@@ -559,6 +559,9 @@ class MemCtrl : public qos::MemCtrl
      */
     Tick nextReqTime;
 
+    /** Time the data bus has spent transferring bursts */
+    Tick dataBusBusy;
+
     struct CtrlStats : public statistics::Group
     {
         CtrlStats(MemCtrl &ctrl);
@@ -779,6 +782,36 @@ class MemCtrl : public qos::MemCtrl
     virtual void startup() override;
     virtual void drainResume() override;
 
+    /**
+     * Occupancy of the read buffer, counting the responses that are
+     * waiting to be sent, for the clients that adapt to the load on
+     * the memory.
+     *
+     * @return fraction of the read buffer in use
+     */
+    virtual double
+    readBufferOccupancy() const
+    {
+        return double(totalReadQueueSize + respQueue.size()) /
+            readBufferSize;
+    }
+
+    /**
+     * Time the data bus has spent transferring bursts since the start
+     * of the simulation, which gives its utilization over an interval.
+     * A controller with several pseudo channels sums their buses.
+     *
+     * @return busy time of the data bus
+     */
+    Tick dataBusBusyTicks() const { return dataBusBusy; }
+
+    /**
+     * Number of data buses summed by dataBusBusyTicks.
+     *
+     * @return number of channels of the controller
+     */
+    virtual unsigned numDataBuses() const { return 1; }
+
   protected:
 
     virtual Tick recvAtomic(PacketPtr pkt);
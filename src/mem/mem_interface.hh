@@ -296,6 +296,13 @@ class MemInterface : public AbstractMemory
      */
     Tick rankDelay() const { return tCS; }
 
+    /**
+     * Time the data bus is held by a burst
+     *
+     * @return burst duration
+     */
+    Tick burstDelay() const { return tBURST; }
+
     /**
      *
      * @return minimum additional bus turnaround required for read-to-write
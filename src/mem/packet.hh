@@ -58,8 +58,10 @@
 #include "base/extensible.hh"
 #include "base/flags.hh"
 #include "base/logging.hh"
+#include "base/pool_alloc.hh"
 #include "base/printable.hh"
 #include "base/types.hh"
+#include "config/use_pool_alloc.hh"
 #include "mem/htm.hh"
 #include "mem/request.hh"
 #include "sim/byteswap.hh"
@@ -291,7 +293,8 @@ class MemCmd
  * ultimate destination and back, possibly being conveyed by several
  * different Packets along the way.)
  */
-class Packet : public Printable, public Extensible<Packet>
+class Packet : public Printable, public Extensible<Packet>,
+               public PoolAllocated<Packet>
 {
   public:
     typedef uint32_t FlagsType;
@@ -353,6 +356,9 @@ class Packet : public Printable, public Extensible<Packet>
         /// the packet is destroyed. The pointer is assumed to be pointing
         /// to an array, and delete [] is consequently called
         DYNAMIC_DATA           = 0x00002000,
+        /// The dynamic data was allocated from the buffer pools, and is
+        /// returned to them when the packet is destroyed
+        POOLED_DATA            = 0x00004000,
 
         /// suppress the error if this packet encounters a functional
         /// access failure.
@@ -360,7 +366,11 @@ class Packet : public Printable, public Extensible<Packet>
 
         // Signal block present to squash prefetch and cache evict packets
         // through express snoop flag
-        BLOCK_CACHED          = 0x00010000
+        BLOCK_CACHED          = 0x00010000,
+
+        /// The payload comes from a tag-only cache, which holds no data,
+        /// and must not be read or written to memory
+        PLACEHOLDER_DATA       = 0x00020000
     };
 
     Flags flags;
@@ -760,6 +770,15 @@ class Packet : public Printable, public Extensible<Packet>
     bool isBlockCached() const     { return flags.isSet(BLOCK_CACHED); }
     void clearBlockCached()        { flags.clear(BLOCK_CACHED); }
 
+    /**
+     * Set by tag-only caches on the responses and writebacks they send
+     * without copying any data, as their blocks hold none. Memory keeps
+     * the only copy of the data, so the payload of such a packet is
+     * neither written to memory nor used to satisfy functional accesses.
+     */
+    void setPlaceholderData()      { flags.set(PLACEHOLDER_DATA); }
+    bool hasPlaceholderData() const { return flags.isSet(PLACEHOLDER_DATA); }
+
     /**
      * QoS Value getter
      * Returns 0 if QoS value was never set (constructor default).
@@ -1355,10 +1374,12 @@ class Packet : public Printable, public Extensible<Packet>
     void
     deleteData()
     {
-        if (flags.isSet(DYNAMIC_DATA))
+        if (flags.isSet(POOLED_DATA))
+            BufferPool::deallocate(data, getSize());
+        else if (flags.isSet(DYNAMIC_DATA))
             delete [] data;
 
-        flags.clear(STATIC_DATA|DYNAMIC_DATA);
+        flags.clear(STATIC_DATA|DYNAMIC_DATA|POOLED_DATA);
         data = NULL;
     }
 
@@ -1371,7 +1392,12 @@ class Packet : public Printable, public Extensible<Packet>
         if (hasData() || hasRespData()) {
             assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
             flags.set(DYNAMIC_DATA);
+#if USE_POOL_ALLOC
+            flags.set(POOLED_DATA);
+            data = BufferPool::allocate(getSize());
+#else
             data = new uint8_t[getSize()];
+#endif
         }
     }
 
@@ -1413,7 +1439,8 @@ class Packet : public Printable, public Extensible<Packet>
         // data pointer
         return trySatisfyFunctional(other, other->getAddr(), other->isSecure(),
                                     other->getSize(),
-                                    other->hasData() ?
+                                    other->hasData() &&
+                                    !other->hasPlaceholderData() ?
                                     other->getPtr<uint8_t>() : NULL);
     }
 
@@ -54,13 +54,16 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "base/amo.hh"
 #include "base/compiler.hh"
 #include "base/extensible.hh"
 #include "base/flags.hh"
+#include "base/pool_alloc.hh"
 #include "base/types.hh"
+#include "config/use_pool_alloc.hh"
 #include "cpu/inst_seq.hh"
 #include "mem/htm.hh"
 #include "sim/cur_tick.hh"
@@ -530,6 +533,23 @@ class Request : public Extensible<Request>
 
     ~Request() {}
 
+    /**
+     * Factory method for creating requests from any of the constructors.
+     * The request and its reference count are allocated together from
+     * the request pool when gem5 is built with USE_POOL_ALLOC.
+     */
+    template <class... Args>
+    static RequestPtr
+    create(Args&&... args)
+    {
+#if USE_POOL_ALLOC
+        return std::allocate_shared<Request>(PoolAllocator<Request>(),
+                                             std::forward<Args>(args)...);
+#else
+        return std::make_shared<Request>(std::forward<Args>(args)...);
+#endif
+    }
+
     /**
      * Factory method for creating memory management requests, with
      * unspecified addr and size.
@@ -537,7 +557,7 @@ class Request : public Extensible<Request>
     static RequestPtr
     createMemManagement(Flags flags, RequestorID id)
     {
-        auto mgmt_req = std::make_shared<Request>();
+        auto mgmt_req = create();
         mgmt_req->_flags.set(flags);
         mgmt_req->_requestorId = id;
         mgmt_req->_time = curTick();
@@ -619,8 +639,8 @@ class Request : public Extensible<Request>
         assert(hasVaddr());
         assert(!hasPaddr());
         assert(split_addr > _vaddr && split_addr < _vaddr + _size);
-        req1 = std::make_shared<Request>(*this);
-        req2 = std::make_shared<Request>(*this);
+        req1 = create(*this);
+        req2 = create(*this);
         req1->_size = split_addr - _vaddr;
         req2->_vaddr = split_addr;
         req2->_size = _size - req1->_size;
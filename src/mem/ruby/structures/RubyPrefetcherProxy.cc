@@ -66,7 +66,7 @@ RubyPrefetcherProxy::RubyPrefetcherProxy(AbstractController* _parent,
             name());
         prefetcher->setParentInfo(
             cacheCntrl->params().system,
-            cacheCntrl->getProbeManager(),
+            cacheCntrl->getProbeManager(), *this,
             cacheCntrl->m_ruby_system->getBlockSizeBytes());
     }
 }
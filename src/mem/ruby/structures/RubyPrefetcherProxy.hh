@@ -176,6 +176,9 @@ class RubyPrefetcherProxy : public CacheAccessor, public Named
     bool coalesce() const override
     { return cacheCntrl->coalesce(); }
 
+    void prefetchQueued() override
+    { scheduleNextPrefetch(); }
+
 };
 
 } // namespace ruby
@@ -45,6 +45,7 @@
 #include <cassert>
 #include <string>
 
+#include "base/pool_alloc.hh"
 #include "mem/ruby/common/MachineID.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
 #include "mem/ruby/protocol/RequestStatus.hh"
@@ -148,7 +149,8 @@ class RubyPort : public ClockedObject
         AddrRangeList getAddrRanges() const;
     };
 
-    struct SenderState : public Packet::SenderState
+    struct SenderState : public Packet::SenderState,
+                         public PoolAllocated<SenderState>
     {
         MemResponsePort *port;
         SenderState(MemResponsePort * _port) : port(_port)
@@ -108,6 +108,55 @@ struct PacketInfo
 typedef ProbePointArg<PacketInfo> Packet;
 typedef std::unique_ptr<Packet> PacketUPtr;
 
+/**
+ * The value returned to a load, as seen by the core that issued it. The
+ * requests observed in the memory system do not carry the data of loads,
+ * so this lets memory-side components, such as prefetchers, learn from
+ * it.
+ */
+struct LoadValueInfo
+{
+    Addr pc;
+    /** Virtual address of the load */
+    Addr vaddr;
+    /** Physical address of the load */
+    Addr paddr;
+    /** Size of the load, in bytes */
+    unsigned size;
+    /** Loaded value, sign extended from its size */
+    uint64_t value;
+};
+
+/**
+ * Load value probe point
+ *
+ * Cores notify it, under the name LoadValue, when a load of at most 8
+ * bytes receives its data.
+ */
+typedef ProbePointArg<LoadValueInfo> LoadValue;
+typedef std::unique_ptr<LoadValue> LoadValueUPtr;
+
+/**
+ * A cache block that the front-end of a core predicts it will fetch
+ * instructions from, before fetch gets there.
+ */
+struct FetchTargetInfo
+{
+    /** Virtual address of the block */
+    Addr addr;
+    /** Number of predicted blocks between fetch and this one, included */
+    unsigned distance;
+};
+
+/**
+ * Fetch target probe point
+ *
+ * Cores with a fetch-target queue notify it, under the name FetchTarget,
+ * for each block they add to the queue.
+ */
+typedef ProbePointArg<FetchTargetInfo> FetchTarget;
+typedef std::unique_ptr<FetchTarget> FetchTargetUPtr;
+
 } // namespace probing
 
 } // namespace gem5
@@ -12,6 +12,10 @@ config = f"{gem5_root}/configs/tdt4260/prefetcher.py"
 binaries = ["gcc", "exchange2", "mcf", "deepsjeng", "x264"]
 welcome_message = True
 
+# Record the L1D and L2 request streams of each run in its output folder,
+# to be replayed by run_trace_eval.py
+record_traces = False
+
 if (welcome_message):
     print('''
 The prefetcher run script is now invoked and will run each benchmark from checkpoints.
@@ -32,8 +36,10 @@ for x in range(0, num_benchmarks):
     output_dir = f"prefetcher_out_{x}"
     if (os.path.exists(f"prefetcher_out_{x}")):
         shutil.rmtree(f"prefetcher_out_{x}")
+    trace_args = ["--l1d-trace-file=l1d.trc.gz",
+                  "--l2-trace-file=l2.trc.gz"] if record_traces else []
     proc = subprocess.run([gem5_bin, "-v", "-r", f"--outdir={output_dir}", config,
-                    "--iteration", str(x)])
+                    "--iteration", str(x)] + trace_args)
     print(f"{proc.returncode} was returned for binary {binaries[x]}")
     if (proc.returncode == 0):
         count = count + 1
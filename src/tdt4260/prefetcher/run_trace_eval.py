@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+import os
+import subprocess
+
+gem5_root = os.path.abspath("../../..")
+gem5_bin = f"{gem5_root}/build/X86/gem5.opt"
+config = f"{gem5_root}/configs/tdt4260/trace_eval.py"
+
+b_names = ["gcc_s", "exchange2_s", "mcf_s", "deepsjeng_s", "x264_s"]
+
+# Traces are recorded by run_prefetcher.py with record_traces = True
+levels = ["l1d", "l2"]
+
+# Prefetcher variants to compare, each given as a list of NAME=VALUE
+# parameter assignments of the prefetcher
+variants = [
+    [],
+    ["bo_degree_mode=multiples", "bo_adaptive_degree=True"],
+    ["arbiter=bo_only"],
+]
+
+result_dst = "results/trace_eval_summary.txt"
+metrics = ["miss reduction", "accuracy", "coverage"]
+
+summary = []
+for v, variant in enumerate(variants):
+    for x, name in enumerate(b_names):
+        for level in levels:
+            trace = f"spec2017/prefetcher_out_{x}/{level}.trc.gz"
+            if not os.path.exists(trace):
+                continue
+            output_dir = f"trace_eval_out/{v}_{x}_{level}"
+            args = [gem5_bin, "-r", f"--outdir={output_dir}", config, trace,
+                    "--level", level]
+            for param in variant:
+                args += ["--pf-param", param]
+            proc = subprocess.run(args, capture_output=True, text=True)
+            if (proc.returncode != 0):
+                print(f"{proc.returncode} was returned for {name} {level}")
+                continue
+
+            result = {}
+            for line in proc.stdout.split("\n"):
+                key, sep, value = line.partition(": ")
+                if sep and key in metrics:
+                    result[key] = value
+            summary.append((variant, name, level, result))
+
+with open(result_dst, "w") as out:
+    for variant, name, level, result in summary:
+        values = ", ".join(f"{k}: {result.get(k, '-')}" for k in metrics)
+        out.write(f"[{' '.join(variant) or 'default'}] {name} {level}: "
+                  f"{values}\n")
+
+print(f"Results collated to {result_dst}")
@@ -70,6 +70,17 @@ gem5_verify_config(
     length=constants.long_tag,
 )
 
+# The testers check the data they read, which tag-only caches must take
+# from memory, with the bytes of each write going through
+gem5_verify_config(
+    name="memtest_tag_only",
+    verifiers=(),  # No need for verfiers this will return non-zero on fail
+    config=joinpath(getcwd(), "memtest-run.py"),
+    config_args=["--tag-only-caches"],
+    valid_isas=(constants.null_tag,),
+    length=constants.long_tag,
+)
+
 null_tests = [
     ("garnet_synth_traffic", None, ["--sim-cycles", "5000000"]),
     ("memcheck", None, ["--maxtick", "2000000000", "--prefetchers"]),